@@ -24,4 +24,125 @@ fn main() {
             .write_to_file(target_dir.join("bindings.rs"))
             .expect("generated bindings should be written to `OUT_DIR`");
     }
+    #[cfg(feature = "static")]
+    static_lib::build();
+}
+
+/// Static linking of `CoolProp` built from source _(the **`static`** feature)_.
+#[cfg(feature = "static")]
+mod static_lib {
+    use std::{
+        env, fs,
+        path::{Path, PathBuf},
+    };
+
+    const LIB_NAME: &str = "CoolProp";
+
+    /// Builds `CoolProp` from the source tree specified by `COOLPROP_SOURCE_DIR`,
+    /// links it statically and generates the function table of the linked symbols.
+    pub fn build() {
+        println!("cargo:rerun-if-changed=build.rs");
+        for var in ["COOLPROP_SOURCE_DIR", "COOLPROP_MARCH", "COOLPROP_LTO", "COOLPROP_CXX_STDLIB"]
+        {
+            println!("cargo:rerun-if-env-changed={var}");
+        }
+        let source_dir = PathBuf::from(env::var("COOLPROP_SOURCE_DIR").expect(
+            "`COOLPROP_SOURCE_DIR` should point to the CoolProp source tree \
+             (with submodules) for the `static` feature",
+        ));
+        let out_dir = PathBuf::from(env::var("OUT_DIR").unwrap());
+        let flags = compiler_flags();
+        let dst = cmake::Config::new(&source_dir)
+            .define("COOLPROP_STATIC_LIBRARY", "ON")
+            .define("COOLPROP_SHARED_LIBRARY", "OFF")
+            .define("CMAKE_POSITION_INDEPENDENT_CODE", "ON")
+            .define("FORCE_BITNESS_NATIVE", "ON")
+            .profile("Release")
+            .cflag(&flags)
+            .cxxflag(&flags)
+            .build_target(LIB_NAME)
+            .build();
+        let build_dir = dst.join("build");
+        println!("cargo:rustc-link-search=native={}", build_dir.display());
+        println!("cargo:rustc-link-search=native={}", build_dir.join("Release").display());
+        println!("cargo:rustc-link-lib=static={LIB_NAME}");
+        if let Some(stdlib) = cxx_stdlib() {
+            println!("cargo:rustc-link-lib=dylib={stdlib}");
+        }
+        let bindings_path = if cfg!(feature = "regen-bindings") {
+            out_dir.join("bindings.rs")
+        } else {
+            PathBuf::from("src/bindings_generated.rs")
+        };
+        println!("cargo:rerun-if-changed={}", bindings_path.display());
+        let bindings = fs::read_to_string(&bindings_path).expect("bindings should be readable");
+        write_linked(&bindings, &out_dir.join("linked.rs"));
+    }
+
+    /// Optimization flags of the `CoolProp` build: `-O3`, target CPU from `COOLPROP_MARCH`
+    /// _(e.g., `native` or `x86-64-v3`)_ and `ThinLTO` if `COOLPROP_LTO` is set.
+    fn compiler_flags() -> String {
+        let msvc = env::var("CARGO_CFG_TARGET_ENV").is_ok_and(|x| x == "msvc");
+        let lto = env::var("COOLPROP_LTO").is_ok_and(|x| !x.is_empty() && x != "0");
+        let mut flags = vec![if msvc { "/O2" } else { "-O3" }.to_owned()];
+        if let Ok(march) = env::var("COOLPROP_MARCH") {
+            if msvc {
+                println!("cargo:warning=`COOLPROP_MARCH` is ignored for MSVC targets");
+            } else {
+                flags.push(format!("-march={march}"));
+            }
+        }
+        if lto {
+            flags.push(if msvc { "/GL" } else { "-flto=thin" }.to_owned());
+        }
+        flags.join(" ")
+    }
+
+    /// C++ standard library to link with _(`COOLPROP_CXX_STDLIB` overrides the default)_.
+    fn cxx_stdlib() -> Option<String> {
+        if let Ok(stdlib) = env::var("COOLPROP_CXX_STDLIB") {
+            return (!stdlib.is_empty()).then_some(stdlib);
+        }
+        match env::var("CARGO_CFG_TARGET_OS").unwrap().as_str() {
+            "macos" => Some("c++".into()),
+            "windows" => None,
+            _ => Some("stdc++".into()),
+        }
+    }
+
+    /// Writes `extern` declarations of all `CoolProp` functions and the constructor
+    /// of the function table from them, following the fields of the bindings struct.
+    fn write_linked(bindings: &str, path: &Path) {
+        let start = bindings
+            .find("pub struct CoolProp {")
+            .expect("bindings should contain the `CoolProp` struct");
+        let end = start + bindings[start..].find("\n}\n").expect("`CoolProp` struct should end");
+        let mut fields = Vec::<(String, String)>::new();
+        for line in bindings[start..end].lines().skip(1) {
+            if let Some(field) = line.strip_prefix("    pub ") {
+                let (name, signature) = field.split_once(':').expect("field should have a type");
+                fields.push((name.to_owned(), signature.to_owned()));
+            } else if let Some((_, signature)) = fields.last_mut() {
+                signature.push('\n');
+                signature.push_str(line);
+            }
+        }
+        let mut declarations = String::new();
+        let mut initializers = String::new();
+        for (name, signature) in &fields {
+            let signature = signature
+                .trim()
+                .trim_end_matches(',')
+                .strip_prefix("unsafe extern \"C\" fn")
+                .expect("`CoolProp` struct fields should be function pointers");
+            declarations.push_str(&format!("        pub fn {name}{signature};\n"));
+            initializers.push_str(&format!("            {name}: linked::{name},\n"));
+        }
+        let code = format!(
+            "mod linked {{\n    unsafe extern \"C\" {{\n{declarations}    }}\n}}\n\n\
+             impl CoolProp {{\n    pub fn linked() -> Self {{\n        Self {{\n            \
+             __library: this_process(),\n{initializers}        }}\n    }}\n}}\n"
+        );
+        fs::write(path, code).expect("function table should be written to `OUT_DIR`");
+    }
 }
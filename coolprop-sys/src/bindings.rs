@@ -20,3 +20,18 @@ include!(concat!(env!("OUT_DIR"), "/bindings.rs"));
 
 #[cfg(not(feature = "regen-bindings"))]
 include!("bindings_generated.rs");
+
+// Function table of the statically linked library (`CoolProp::linked`)
+#[cfg(feature = "static")]
+include!(concat!(env!("OUT_DIR"), "/linked.rs"));
+
+/// Handle of the current process, which contains the statically linked library.
+#[cfg(feature = "static")]
+fn this_process() -> ::libloading::Library {
+    #[cfg(unix)]
+    let library = ::libloading::os::unix::Library::this();
+    #[cfg(windows)]
+    let library = ::libloading::os::windows::Library::this()
+        .expect("handle of the current process should be available");
+    library.into()
+}
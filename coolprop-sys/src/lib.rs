@@ -56,6 +56,40 @@
 //! cargo add coolprop-sys --features regen-bindings
 //! ```
 //!
+//! ### Static linking
+//!
+//! For latency-sensitive applications, enable the **`static`** feature to build `CoolProp`
+//! from source with `-O3` and link it statically instead of loading the bundled dynamic library
+//! at runtime (requires `cmake` and a C++ compiler). The `CoolProp` source tree (with submodules)
+//! is specified by environment variables, which are read during build:
+//!
+//! - `COOLPROP_SOURCE_DIR` -- path to the `CoolProp` source tree (required)
+//! - `COOLPROP_MARCH` -- target CPU for `-march` (e.g., `native` or `x86-64-v3`)
+//! - `COOLPROP_LTO` -- enables `ThinLTO` of `CoolProp` if set to `1`
+//! - `COOLPROP_CXX_STDLIB` -- C++ standard library to link with
+//!   (`stdc++` on Linux and `c++` on macOS by default)
+//!
+//! ```shell
+//! git clone --recursive https://github.com/CoolProp/CoolProp.git
+//! COOLPROP_SOURCE_DIR=$PWD/CoolProp COOLPROP_MARCH=native cargo build --release --features static
+//! ```
+//!
+//! Cross-language LTO additionally requires `clang` with the same LLVM version as `rustc`:
+//!
+//! ```shell
+//! CC=clang CXX=clang++ COOLPROP_LTO=1 \
+//! RUSTFLAGS="-Clinker-plugin-lto -Clinker=clang -Clink-arg=-fuse-ld=lld" \
+//! cargo build --release --features static
+//! ```
+//!
+//! To compare it with the dynamic build, save the benchmark baseline of the latter
+//! and run the same benchmarks with the **`static`** feature:
+//!
+//! ```shell
+//! cargo bench -p rfluids --bench native -- --save-baseline dynamic
+//! cargo bench -p rfluids --bench native --features static -- --baseline dynamic
+//! ```
+//!
 //! #### License
 //!
 //! <sup>
@@ -63,7 +97,7 @@
 //! <a href="https://github.com/portyanikhin/rfluids/blob/main/LICENSE">MIT License</a>
 //! </sup>
 
-use std::sync::{LazyLock, Mutex};
+use std::sync::{LazyLock, Mutex, RwLock};
 
 pub mod bindings;
 
@@ -81,16 +115,89 @@ pub const COOLPROP_PATH: &str = coolprop_sys_windows_aarch64::COOLPROP_PATH;
 #[cfg(all(target_os = "windows", target_arch = "x86_64"))]
 pub const COOLPROP_PATH: &str = coolprop_sys_windows_x86_64::COOLPROP_PATH;
 
+/// Function table of the `CoolProp` dynamic library.
+///
+/// All `CoolProp` symbols are resolved once, on first access using [`LazyLock`], and stay valid
+/// for the entire lifetime of the process. The table itself is immutable and can be shared
+/// between threads without any locking.
+///
+/// It is intended for calls that only touch a single `AbstractState` handle
+/// (e.g., `AbstractState_update` or `AbstractState_keyed_output`).
+/// Such calls should hold a read lock on [`COOLPROP_HANDLES`] for their entire duration,
+/// so they can run in parallel with each other, but never concurrently with creation
+/// or destruction of other handles. All other calls should go through [`COOLPROP`].
+///
+/// ```no_run
+/// use coolprop_sys::{COOLPROP_API, COOLPROP_HANDLES};
+///
+/// let _handles = COOLPROP_HANDLES.read().unwrap();
+/// // Use CoolProp per-handle methods of `COOLPROP_API` here
+/// ```
+///
+/// # Panics
+///
+/// Panics on initialization if the `CoolProp` dynamic library cannot be loaded
+/// (e.g., if the library file is missing or corrupted).
+///
+/// With the **`static`** feature, the table points to the statically linked `CoolProp`
+/// instead, so nothing is loaded at runtime.
+///
+/// # Safety
+///
+/// Internally uses `unsafe` to load the dynamic library via FFI.
+/// Safety is ensured because:
+/// - The library is loaded from the verified [`COOLPROP_PATH`]
+/// - Loading occurs once during initialization
+/// - All subsequent accesses work with the already loaded library
+///
+/// # See Also
+///
+/// - [`COOLPROP`]
+/// - [`COOLPROP_HANDLES`]
+/// - [`CoolPropLib.h` Reference](https://coolprop.org/_static/doxygen/html/_cool_prop_lib_8h.html)
+pub static COOLPROP_API: LazyLock<bindings::CoolProp> = LazyLock::new(load);
+
+#[cfg(not(feature = "static"))]
+fn load() -> bindings::CoolProp {
+    unsafe { bindings::CoolProp::new(COOLPROP_PATH) }
+        .expect("CoolProp dynamic library should load from `COOLPROP_PATH`")
+}
+
+#[cfg(feature = "static")]
+fn load() -> bindings::CoolProp {
+    bindings::CoolProp::linked()
+}
+
+/// Lock around the `CoolProp` registry of `AbstractState` handles.
+///
+/// `CoolProp` keeps all `AbstractState` instances created via `AbstractState_factory`
+/// in an unsynchronized process-global map, which is looked up by every per-handle call.
+/// Per-handle calls _(via [`COOLPROP_API`])_ should hold a **read** lock, while
+/// `AbstractState_factory`, `AbstractState_free` and process-global configuration changes
+/// should hold a **write** lock.
+///
+/// If both locks are required, [`COOLPROP`] should always be acquired first.
+///
+/// # See Also
+///
+/// - [`COOLPROP`]
+/// - [`COOLPROP_API`]
+pub static COOLPROP_HANDLES: RwLock<()> = RwLock::new(());
+
 /// Global instance of the `CoolProp` dynamic library.
 ///
 /// Provides thread-safe access to a single `CoolProp` instance across the entire application.
-/// The library is loaded lazily on first access using [`LazyLock`].
+/// The library is loaded lazily on first access using [`LazyLock`]
+/// _(it shares the function table with [`COOLPROP_API`])_.
 ///
 /// Access to this shared handle is protected by a [`Mutex`]. This is a conservative boundary
 /// around `CoolProp`'s process-global configuration, debug level, warning, and pending-error
 /// state. It also allows higher-level wrappers to keep calls returning sentinel values and
 /// subsequent pending-error retrieval together.
 ///
+/// Calls that only touch a single `AbstractState` handle don't need this lock,
+/// see [`COOLPROP_API`] and [`COOLPROP_HANDLES`] instead.
+///
 /// To use the library, acquire the lock:
 ///
 /// ```no_run
@@ -105,20 +212,10 @@ pub const COOLPROP_PATH: &str = coolprop_sys_windows_x86_64::COOLPROP_PATH;
 /// Panics on initialization if the `CoolProp` dynamic library cannot be loaded
 /// (e.g., if the library file is missing or corrupted).
 ///
-/// # Safety
-///
-/// Internally uses `unsafe` to load the dynamic library via FFI.
-/// Safety is ensured because:
-/// - The library is loaded from the verified [`COOLPROP_PATH`]
-/// - Loading occurs once during initialization
-/// - All subsequent accesses work with the already loaded library
-///
 /// # See Also
 ///
+/// - [`COOLPROP_API`]
+/// - [`COOLPROP_HANDLES`]
 /// - [`CoolPropLib.h` Reference](https://coolprop.org/_static/doxygen/html/_cool_prop_lib_8h.html)
-pub static COOLPROP: LazyLock<Mutex<bindings::CoolProp>> = LazyLock::new(|| {
-    Mutex::new(
-        unsafe { bindings::CoolProp::new(COOLPROP_PATH) }
-            .expect("CoolProp dynamic library should load from `COOLPROP_PATH`"),
-    )
-});
+pub static COOLPROP: LazyLock<Mutex<&'static bindings::CoolProp>> =
+    LazyLock::new(|| Mutex::new(&*COOLPROP_API));
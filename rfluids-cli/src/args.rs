@@ -0,0 +1,323 @@
+use std::{collections::HashMap, path::PathBuf, str::FromStr};
+
+use rfluids::prelude::*;
+
+/// Usage message of the command-line interface.
+pub(crate) const USAGE: &str = "\
+Usage: rfluids-cli eval [OPTIONS] --substance <NAME> --input1 <KEY>=<COLUMN> \
+--input2 <KEY>=<COLUMN> --outputs <KEYS> [INPUT] [OUTPUT]
+
+Evaluates CoolProp properties for each row of the CSV file
+and appends them to the row as new columns.
+All values are in SI units. INPUT and OUTPUT default to stdin and stdout (or `-`).
+
+Options:
+      --substance <NAME>       Substance name (e.g., `Water`, `INCOMP::Water`, `R444A.mix`),
+                               or binary mixture kind (e.g., `MPG`) if `--fraction` is specified
+      --fraction <VALUE>       Fraction of the binary mixture [dimensionless, from 0 to 1]
+      --backend <NAME>         CoolProp backend (e.g., `HEOS`, `TTSE&HEOS`)
+                               [default: default backend of the substance]
+      --input1 <KEY>=<COLUMN>  First input parameter and its column (e.g., `P=pressure`)
+      --input2 <KEY>=<COLUMN>  Second input parameter and its column (e.g., `T=temperature`)
+      --outputs <KEYS>         Comma-separated output parameters (e.g., `DMass,CpMass`)
+      --batch-rows <N>         Number of rows evaluated at once [default: 65536]
+      --delimiter <CHAR>       Field delimiter [default: ,]
+  -h, --help                   Print help
+";
+
+/// Default number of rows evaluated at once.
+const DEFAULT_BATCH_ROWS: usize = 65_536;
+
+/// Names of the options which take a value.
+const OPTIONS: [&str; 8] =
+    ["substance", "fraction", "backend", "input1", "input2", "outputs", "batch-rows", "delimiter"];
+
+/// Parsed command.
+#[derive(Debug, PartialEq)]
+pub(crate) enum Command {
+    /// Print the usage message.
+    Help,
+    /// Evaluate the properties.
+    Eval(EvalArgs),
+}
+
+/// Arguments of the `eval` command.
+#[derive(Debug, PartialEq)]
+pub(crate) struct EvalArgs {
+    /// Substance of all rows.
+    pub(crate) substance: Substance,
+    /// Custom backend _(if `None`, the default backend of the substance is used)_.
+    pub(crate) backend: Option<Backend>,
+    /// First input parameter and its column name.
+    pub(crate) input1: (FluidParam, String),
+    /// Second input parameter and its column name.
+    pub(crate) input2: (FluidParam, String),
+    /// Output parameters and their column names.
+    pub(crate) outputs: Vec<(FluidParam, String)>,
+    /// Number of rows evaluated at once.
+    pub(crate) batch_rows: usize,
+    /// Field delimiter.
+    pub(crate) delimiter: char,
+    /// Input file _(if `None`, stdin is used)_.
+    pub(crate) input: Option<PathBuf>,
+    /// Output file _(if `None`, stdout is used)_.
+    pub(crate) output: Option<PathBuf>,
+}
+
+/// Error during parsing of the command-line arguments.
+#[derive(Clone, Debug, Eq, PartialEq, thiserror::Error)]
+pub(crate) enum ArgsError {
+    /// Unknown command.
+    #[error("unknown command `{0}`")]
+    UnknownCommand(String),
+
+    /// Unknown option.
+    #[error("unknown option `{0}`")]
+    UnknownOption(String),
+
+    /// Option without value.
+    #[error("option `--{0}` requires a value")]
+    MissingValue(&'static str),
+
+    /// Required option is not specified.
+    #[error("option `--{0}` is required")]
+    MissingOption(&'static str),
+
+    /// Invalid option value.
+    #[error("invalid value `{value}` of option `--{option}`")]
+    InvalidValue {
+        /// Option name.
+        option: &'static str,
+        /// Specified value.
+        value: String,
+    },
+
+    /// Unexpected positional argument.
+    #[error("unexpected argument `{0}`")]
+    UnexpectedArgument(String),
+}
+
+/// Parses the command-line arguments _(without the program name)_.
+///
+/// # Errors
+///
+/// Returns an [`ArgsError`] for unknown, missing or invalid arguments.
+pub(crate) fn parse(args: impl IntoIterator<Item = String>) -> Result<Command, ArgsError> {
+    let mut args = args.into_iter();
+    match args.next().as_deref() {
+        None | Some("-h" | "--help") => return Ok(Command::Help),
+        Some("eval") => {}
+        Some(other) => return Err(ArgsError::UnknownCommand(other.into())),
+    }
+    let mut values = HashMap::new();
+    let mut positional = Vec::new();
+    while let Some(arg) = args.next() {
+        if arg == "-h" || arg == "--help" {
+            return Ok(Command::Help);
+        }
+        let Some(option) = arg.strip_prefix("--") else {
+            positional.push(arg);
+            continue;
+        };
+        let (name, value) = match option.split_once('=') {
+            Some((name, value)) => (name, Some(value.to_owned())),
+            None => (option, None),
+        };
+        let name = *OPTIONS
+            .iter()
+            .find(|&&x| x == name)
+            .ok_or_else(|| ArgsError::UnknownOption(arg.clone()))?;
+        let value = match value {
+            Some(value) => value,
+            None => args.next().ok_or(ArgsError::MissingValue(name))?,
+        };
+        values.insert(name, value);
+    }
+    let mut positional = positional.into_iter().map(|x| (x != "-").then(|| PathBuf::from(x)));
+    let (input, output) = (positional.next().flatten(), positional.next().flatten());
+    if let Some(unexpected) = positional.next() {
+        return Err(ArgsError::UnexpectedArgument(
+            unexpected.map_or("-".into(), |x| x.display().to_string()),
+        ));
+    }
+    Ok(Command::Eval(EvalArgs {
+        substance: substance(
+            &required(&mut values, "substance")?,
+            values.remove("fraction").as_deref(),
+        )?,
+        backend: values.remove("backend").map(|x| value("backend", &x)).transpose()?,
+        input1: input("input1", &required(&mut values, "input1")?)?,
+        input2: input("input2", &required(&mut values, "input2")?)?,
+        outputs: outputs(&required(&mut values, "outputs")?)?,
+        batch_rows: values.remove("batch-rows").map_or(Ok(DEFAULT_BATCH_ROWS), |x| {
+            value("batch-rows", &x).and_then(|rows: usize| {
+                if rows == 0 { Err(invalid("batch-rows", &x)) } else { Ok(rows) }
+            })
+        })?,
+        delimiter: values.remove("delimiter").map_or(Ok(','), |x| delimiter(&x))?,
+        input,
+        output,
+    }))
+}
+
+fn required(
+    values: &mut HashMap<&'static str, String>,
+    option: &'static str,
+) -> Result<String, ArgsError> {
+    values.remove(option).ok_or(ArgsError::MissingOption(option))
+}
+
+fn invalid(option: &'static str, value: &str) -> ArgsError {
+    ArgsError::InvalidValue { option, value: value.into() }
+}
+
+fn value<T: FromStr>(option: &'static str, value: &str) -> Result<T, ArgsError> {
+    T::from_str(value.trim()).map_err(|_| invalid(option, value))
+}
+
+fn substance(name: &str, fraction: Option<&str>) -> Result<Substance, ArgsError> {
+    let Some(fraction) = fraction else {
+        return value("substance", name);
+    };
+    let kind: BinaryMixKind = value("substance", name.strip_prefix("INCOMP::").unwrap_or(name))?;
+    kind.with_fraction(value("fraction", fraction)?)
+        .map(Into::into)
+        .map_err(|_| invalid("fraction", fraction))
+}
+
+fn input(option: &'static str, spec: &str) -> Result<(FluidParam, String), ArgsError> {
+    let (key, column) = spec.split_once('=').ok_or_else(|| invalid(option, spec))?;
+    if column.is_empty() {
+        return Err(invalid(option, spec));
+    }
+    Ok((value(option, key)?, column.into()))
+}
+
+fn outputs(spec: &str) -> Result<Vec<(FluidParam, String)>, ArgsError> {
+    spec.split(',').map(str::trim).map(|key| Ok((value("outputs", key)?, key.to_owned()))).collect()
+}
+
+fn delimiter(spec: &str) -> Result<char, ArgsError> {
+    let mut chars = spec.chars();
+    match (chars.next(), chars.next()) {
+        (Some(delimiter), None) if delimiter.is_ascii() && delimiter != '\n' => Ok(delimiter),
+        _ => Err(invalid("delimiter", spec)),
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use rstest::*;
+
+    use super::*;
+
+    fn args(s: &str) -> Vec<String> {
+        s.split_whitespace().map(String::from).collect()
+    }
+
+    #[rstest]
+    #[case("")]
+    #[case("--help")]
+    #[case("eval -h")]
+    #[case("eval --substance Water --help")]
+    fn parse_help(#[case] s: &str) {
+        // When
+        let res = parse(args(s));
+
+        // Then
+        assert_eq!(res, Ok(Command::Help));
+    }
+
+    #[test]
+    fn parse_all_options() {
+        // When
+        let res = parse(args(
+            "eval --substance=MPG --fraction 0.4 --backend TTSE&INCOMP --input1 P=p \
+             --input2 T=t --outputs DMass,CpMass --batch-rows 1024 --delimiter ; in.csv -",
+        ));
+
+        // Then
+        assert_eq!(
+            res,
+            Ok(Command::Eval(EvalArgs {
+                substance: BinaryMixKind::MPG.with_fraction(0.4).unwrap().into(),
+                backend: Some(BaseBackend::Incomp.with(TabularMethod::Ttse)),
+                input1: (FluidParam::P, "p".into()),
+                input2: (FluidParam::T, "t".into()),
+                outputs: vec![
+                    (FluidParam::DMass, "DMass".into()),
+                    (FluidParam::CpMass, "CpMass".into())
+                ],
+                batch_rows: 1024,
+                delimiter: ';',
+                input: Some("in.csv".into()),
+                output: None,
+            }))
+        );
+    }
+
+    #[test]
+    fn parse_defaults() {
+        // When
+        let res = parse(args("eval --substance Water --input1 P=p --input2 T=t --outputs H"));
+
+        // Then
+        assert_eq!(
+            res,
+            Ok(Command::Eval(EvalArgs {
+                substance: Pure::Water.into(),
+                backend: None,
+                input1: (FluidParam::P, "p".into()),
+                input2: (FluidParam::T, "t".into()),
+                outputs: vec![(FluidParam::HMass, "H".into())],
+                batch_rows: DEFAULT_BATCH_ROWS,
+                delimiter: ',',
+                input: None,
+                output: None,
+            }))
+        );
+    }
+
+    #[rstest]
+    #[case("run", ArgsError::UnknownCommand("run".into()))]
+    #[case("eval --unknown 1", ArgsError::UnknownOption("--unknown".into()))]
+    #[case("eval --substance", ArgsError::MissingValue("substance"))]
+    #[case("eval --input1 P=p --input2 T=t --outputs H", ArgsError::MissingOption("substance"))]
+    #[case("eval --substance Water --input2 T=t --outputs H", ArgsError::MissingOption("input1"))]
+    #[case(
+        "eval --substance Unknown --input1 P=p --input2 T=t --outputs H",
+        invalid("substance", "Unknown")
+    )]
+    #[case(
+        "eval --substance MPG --fraction 2 --input1 P=p --input2 T=t --outputs H",
+        invalid("fraction", "2")
+    )]
+    #[case(
+        "eval --substance Water --backend HEOS&TTSE --input1 P=p --input2 T=t --outputs H",
+        invalid("backend", "HEOS&TTSE")
+    )]
+    #[case("eval --substance Water --input1 P --input2 T=t --outputs H", invalid("input1", "P"))]
+    #[case(
+        "eval --substance Water --input1 P=p --input2 T=t --outputs H,Unknown",
+        invalid("outputs", "Unknown")
+    )]
+    #[case(
+        "eval --substance Water --input1 P=p --input2 T=t --outputs H --batch-rows 0",
+        invalid("batch-rows", "0")
+    )]
+    #[case(
+        "eval --substance Water --input1 P=p --input2 T=t --outputs H --delimiter ;;",
+        invalid("delimiter", ";;")
+    )]
+    #[case(
+        "eval --substance Water --input1 P=p --input2 T=t --outputs H in.csv out.csv extra.csv",
+        ArgsError::UnexpectedArgument("extra.csv".into())
+    )]
+    fn parse_invalid(#[case] s: &str, #[case] expected: ArgsError) {
+        // When
+        let res = parse(args(s));
+
+        // Then
+        assert_eq!(res, Err(expected));
+    }
+}
@@ -0,0 +1,67 @@
+//! Command-line batch evaluator of `CoolProp` properties built on
+//! [`rfluids`](https://docs.rs/rfluids).
+//!
+//! Streams the rows of the CSV file through a bounded pipeline
+//! _(read and parse → parallel evaluation → write)_, appends the calculated output parameters
+//! to each row and reports the throughput to stderr, e.g.:
+//!
+//! ```text
+//! rfluids-cli eval --substance Water --input1 P=pressure --input2 T=temperature \
+//!     --outputs DMass,CpMass states.csv properties.csv
+//! ```
+
+mod args;
+mod pipeline;
+
+use std::{
+    fs::File,
+    io::{self, BufRead, BufReader, BufWriter, Write},
+    process::ExitCode,
+};
+
+use args::{ArgsError, Command, USAGE};
+use pipeline::EvalError;
+
+fn main() -> ExitCode {
+    match run(std::env::args().skip(1)) {
+        Ok(()) => ExitCode::SUCCESS,
+        Err(CliError::Args(e)) => {
+            eprintln!("error: {e}\n\nFor more information, try `--help`.");
+            ExitCode::FAILURE
+        }
+        Err(CliError::Eval(e)) => {
+            eprintln!("error: {e}");
+            ExitCode::FAILURE
+        }
+    }
+}
+
+#[derive(Debug, thiserror::Error)]
+enum CliError {
+    #[error(transparent)]
+    Args(#[from] ArgsError),
+
+    #[error(transparent)]
+    Eval(#[from] EvalError),
+}
+
+fn run(args: impl IntoIterator<Item = String>) -> Result<(), CliError> {
+    let args = match args::parse(args)? {
+        Command::Help => {
+            print!("{USAGE}");
+            return Ok(());
+        }
+        Command::Eval(args) => args,
+    };
+    let reader: Box<dyn BufRead + Send> = match &args.input {
+        Some(path) => Box::new(BufReader::new(File::open(path).map_err(EvalError::from)?)),
+        None => Box::new(BufReader::new(io::stdin())),
+    };
+    let writer: Box<dyn Write + Send> = match &args.output {
+        Some(path) => Box::new(BufWriter::new(File::create(path).map_err(EvalError::from)?)),
+        None => Box::new(BufWriter::new(io::stdout())),
+    };
+    let summary = pipeline::run(&args, reader, writer)?;
+    eprintln!("evaluated {summary}");
+    Ok(())
+}
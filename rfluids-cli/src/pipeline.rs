@@ -0,0 +1,392 @@
+use std::{
+    fmt::{self, Display, Write as _},
+    io::{self, BufRead, Write},
+    sync::mpsc::{self, Receiver, SyncSender},
+    thread,
+    time::{Duration, Instant},
+};
+
+use rfluids::{
+    fluid::{FluidBatch, FluidBatchError, FluidBuildError},
+    prelude::*,
+};
+
+use crate::args::EvalArgs;
+
+/// Maximum number of row batches waiting between the pipeline stages.
+///
+/// Together with the batch size, it bounds the memory usage regardless of the input size.
+const CHANNEL_CAPACITY: usize = 2;
+
+/// Error during evaluation of the CSV rows.
+#[derive(Debug, thiserror::Error)]
+pub(crate) enum EvalError {
+    /// I/O error.
+    #[error(transparent)]
+    Io(#[from] io::Error),
+
+    /// Error during building of the fluid.
+    #[error(transparent)]
+    Build(#[from] FluidBuildError),
+
+    /// Error during calculation of the batch.
+    #[error(transparent)]
+    Batch(#[from] FluidBatchError),
+
+    /// Specified input parameters can't be used as the input pair.
+    #[error("invalid input pair `{0:?}` and `{1:?}`")]
+    InvalidInputPair(FluidParam, FluidParam),
+
+    /// Input is empty _(without the header)_.
+    #[error("input has no header")]
+    MissingHeader,
+
+    /// Input column is not found in the header.
+    #[error("column `{0}` not found in the header")]
+    MissingColumn(String),
+
+    /// Input value can't be parsed.
+    #[error("line {line}: invalid value `{value}` in column `{column}`")]
+    InvalidValue {
+        /// Line number _(1-based, including the header)_.
+        line: usize,
+        /// Column name.
+        column: String,
+        /// Specified value.
+        value: String,
+    },
+}
+
+/// Summary of the completed evaluation.
+#[derive(Clone, Copy, Debug)]
+pub(crate) struct Summary {
+    /// Number of evaluated rows.
+    pub(crate) rows: usize,
+    /// Total wall-clock time.
+    pub(crate) elapsed: Duration,
+}
+
+impl Summary {
+    /// Throughput **\[rows/s\]**.
+    pub(crate) fn throughput(&self) -> f64 {
+        self.rows as f64 / self.elapsed.as_secs_f64().max(f64::EPSILON)
+    }
+}
+
+impl Display for Summary {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        write!(
+            f,
+            "{} rows in {:.3} s ({:.0} rows/s)",
+            self.rows,
+            self.elapsed.as_secs_f64(),
+            self.throughput()
+        )
+    }
+}
+
+/// Consecutive rows of the input with parsed input values.
+#[derive(Debug, Default)]
+struct Rows {
+    lines: Vec<String>,
+    input1: Vec<f64>,
+    input2: Vec<f64>,
+}
+
+/// Positions and names of the input columns _(in order of the input pair)_.
+#[derive(Debug)]
+struct Columns<'a> {
+    delimiter: char,
+    indices: [usize; 2],
+    names: [&'a str; 2],
+}
+
+/// Evaluates the output parameters for each row of the CSV input
+/// and writes the rows with appended output columns.
+///
+/// Runs as a bounded pipeline of three stages -- reading and parsing of the input values,
+/// parallel evaluation of the [`FluidBatch`] and writing of the output,
+/// so reading and writing overlap with the evaluation,
+/// and memory usage doesn't depend on the input size.
+/// Output values that can't be calculated are written as `NaN`.
+///
+/// # Errors
+///
+/// Returns an [`EvalError`] for I/O errors, invalid arguments or input values.
+pub(crate) fn run<R, W>(args: &EvalArgs, mut reader: R, writer: W) -> Result<Summary, EvalError>
+where
+    R: BufRead + Send,
+    W: Write + Send,
+{
+    let start = Instant::now();
+    let keys = (args.input1.0, args.input2.0);
+    let input_pair =
+        FluidInputPair::try_from(keys).map_err(|_| EvalError::InvalidInputPair(keys.0, keys.1))?;
+    let names = if <(FluidParam, FluidParam)>::from(input_pair) == keys {
+        [args.input1.1.as_str(), args.input2.1.as_str()]
+    } else {
+        [args.input2.1.as_str(), args.input1.1.as_str()]
+    };
+    let fluid = Fluid::builder()
+        .substance(args.substance.clone())
+        .maybe_with_backend(args.backend)
+        .build()?;
+    let output_keys: Vec<FluidParam> = args.outputs.iter().map(|(key, _)| *key).collect();
+    let mut batch = FluidBatch::new(&fluid, input_pair, &output_keys);
+
+    let mut header = String::new();
+    if reader.read_line(&mut header)? == 0 {
+        return Err(EvalError::MissingHeader);
+    }
+    trim_line_end(&mut header);
+    let index = |name: &str| {
+        header
+            .split(args.delimiter)
+            .position(|x| x.trim() == name)
+            .ok_or_else(|| EvalError::MissingColumn(name.into()))
+    };
+    let columns =
+        Columns { delimiter: args.delimiter, indices: [index(names[0])?, index(names[1])?], names };
+    for (_, name) in &args.outputs {
+        header.push(args.delimiter);
+        header.push_str(name);
+    }
+    header.push('\n');
+
+    let (rows_sender, rows_receiver) = mpsc::sync_channel(CHANNEL_CAPACITY);
+    let (text_sender, text_receiver) = mpsc::sync_channel(CHANNEL_CAPACITY);
+    thread::scope(|scope| {
+        let columns = &columns;
+        scope.spawn(move || read(reader, columns, args.batch_rows, &rows_sender));
+        let writer = scope.spawn(move || write(writer, &header, &text_receiver));
+        let mut count = 0;
+        let mut res = Ok(());
+        for rows in rows_receiver {
+            let rows = match rows {
+                Ok(rows) => rows,
+                Err(e) => {
+                    res = Err(e);
+                    break;
+                }
+            };
+            if let Err(e) = evaluate(&mut batch, &rows) {
+                res = Err(e);
+                break;
+            }
+            count += rows.lines.len();
+            // The writer has failed, which is reported below
+            if text_sender.send(format(&rows, &batch, args.delimiter)).is_err() {
+                break;
+            }
+        }
+        drop(text_sender);
+        let written = writer.join().unwrap();
+        res.and(written)?;
+        Ok(Summary { rows: count, elapsed: start.elapsed() })
+    })
+}
+
+fn evaluate(batch: &mut FluidBatch, rows: &Rows) -> Result<(), EvalError> {
+    batch.clear().extend_from_slices(&rows.input1, &rows.input2)?.calculate()?;
+    Ok(())
+}
+
+fn read<R: BufRead>(
+    mut reader: R,
+    columns: &Columns,
+    batch_rows: usize,
+    sender: &SyncSender<Result<Rows, EvalError>>,
+) {
+    // The header is already read
+    let mut line_number = 1;
+    loop {
+        let Some(rows) = read_rows(&mut reader, columns, batch_rows, &mut line_number).transpose()
+        else {
+            return;
+        };
+        let failed = rows.is_err();
+        if sender.send(rows).is_err() || failed {
+            return;
+        }
+    }
+}
+
+/// Reads up to `batch_rows` non-empty rows _(`None` if the input is over)_.
+fn read_rows<R: BufRead>(
+    reader: &mut R,
+    columns: &Columns,
+    batch_rows: usize,
+    line_number: &mut usize,
+) -> Result<Option<Rows>, EvalError> {
+    let mut rows = Rows {
+        lines: Vec::with_capacity(batch_rows),
+        input1: Vec::with_capacity(batch_rows),
+        input2: Vec::with_capacity(batch_rows),
+    };
+    while rows.lines.len() < batch_rows {
+        let mut line = String::new();
+        if reader.read_line(&mut line)? == 0 {
+            break;
+        }
+        *line_number += 1;
+        trim_line_end(&mut line);
+        if line.is_empty() {
+            continue;
+        }
+        rows.input1.push(parse_value(&line, columns, 0, *line_number)?);
+        rows.input2.push(parse_value(&line, columns, 1, *line_number)?);
+        rows.lines.push(line);
+    }
+    Ok((!rows.lines.is_empty()).then_some(rows))
+}
+
+fn parse_value(
+    line: &str,
+    columns: &Columns,
+    i: usize,
+    line_number: usize,
+) -> Result<f64, EvalError> {
+    let value = line.split(columns.delimiter).nth(columns.indices[i]).unwrap_or_default();
+    value.trim().parse().map_err(|_| EvalError::InvalidValue {
+        line: line_number,
+        column: columns.names[i].into(),
+        value: value.into(),
+    })
+}
+
+fn format(rows: &Rows, batch: &FluidBatch, delimiter: char) -> String {
+    let outputs = batch.outputs();
+    let len = batch.len();
+    let mut text = String::with_capacity(rows.lines.iter().map(|x| x.len() + 1).sum::<usize>() * 2);
+    for (i, line) in rows.lines.iter().enumerate() {
+        text.push_str(line);
+        for j in 0..batch.output_keys().len() {
+            let _ = write!(text, "{delimiter}{}", outputs[j * len + i]);
+        }
+        text.push('\n');
+    }
+    text
+}
+
+fn write<W: Write>(
+    mut writer: W,
+    header: &str,
+    receiver: &Receiver<String>,
+) -> Result<(), EvalError> {
+    writer.write_all(header.as_bytes())?;
+    for text in receiver {
+        writer.write_all(text.as_bytes())?;
+    }
+    writer.flush()?;
+    Ok(())
+}
+
+fn trim_line_end(line: &mut String) {
+    let len = line.trim_end_matches(['\n', '\r']).len();
+    line.truncate(len);
+}
+
+#[cfg(test)]
+mod tests {
+    use std::io::Cursor;
+
+    use approx::assert_relative_eq;
+
+    use super::*;
+    use crate::args::{self, Command};
+
+    fn eval_args(s: &str) -> EvalArgs {
+        match args::parse(s.split_whitespace().map(String::from)) {
+            Ok(Command::Eval(args)) => args,
+            res => panic!("unexpected result: {res:?}"),
+        }
+    }
+
+    #[test]
+    fn run_valid_input() {
+        // Given
+        let args = eval_args(
+            "eval --substance Water --input1 T=temperature --input2 P=pressure \
+             --outputs DMass,P --batch-rows 2",
+        );
+        let input =
+            "id,pressure,temperature\r\n1,101325,293.15\n\n2,101325,313.15\n3,101325,333.15\n";
+        let mut output = Vec::new();
+
+        // When
+        let res = run(&args, Cursor::new(input), &mut output).unwrap();
+
+        // Then
+        assert_eq!(res.rows, 3);
+        let output = String::from_utf8(output).unwrap();
+        let lines: Vec<_> = output.lines().collect();
+        assert_eq!(lines.len(), 4);
+        assert_eq!(lines[0], "id,pressure,temperature,DMass,P");
+        for (line, temperature) in lines[1..].iter().zip([293.15, 313.15, 333.15]) {
+            let fields: Vec<_> = line.split(',').collect();
+            let mut water = Fluid::from(Pure::Water)
+                .in_state(FluidInput::pressure(101_325.0), FluidInput::temperature(temperature))
+                .unwrap();
+            assert_eq!(fields[2].parse::<f64>().unwrap(), temperature);
+            assert_relative_eq!(
+                fields[3].parse::<f64>().unwrap(),
+                water.density().unwrap(),
+                max_relative = 1e-6
+            );
+            assert_relative_eq!(fields[4].parse::<f64>().unwrap(), 101_325.0, max_relative = 1e-6);
+        }
+    }
+
+    #[test]
+    fn run_failed_calculation() {
+        // Given
+        let args = eval_args("eval --substance Water --input1 P=p --input2 T=t --outputs DMass");
+        let mut output = Vec::new();
+
+        // When
+        let res = run(&args, Cursor::new("p,t\n-1,293.15\n"), &mut output).unwrap();
+
+        // Then
+        assert_eq!(res.rows, 1);
+        assert_eq!(String::from_utf8(output).unwrap(), "p,t,DMass\n-1,293.15,NaN\n");
+    }
+
+    #[test]
+    fn run_invalid_value() {
+        // Given
+        let args = eval_args("eval --substance Water --input1 P=p --input2 T=t --outputs DMass");
+
+        // When
+        let res = run(&args, Cursor::new("p,t\n101325,293.15\n101325,\n"), io::sink());
+
+        // Then
+        assert!(matches!(
+            res,
+            Err(EvalError::InvalidValue { line: 3, column, value }) if column == "t" && value.is_empty()
+        ));
+    }
+
+    #[test]
+    fn run_missing_column() {
+        // Given
+        let args = eval_args("eval --substance Water --input1 P=p --input2 T=t --outputs DMass");
+
+        // When
+        let res = run(&args, Cursor::new("p,temperature\n"), io::sink());
+
+        // Then
+        assert!(matches!(res, Err(EvalError::MissingColumn(column)) if column == "t"));
+    }
+
+    #[test]
+    fn run_invalid_input_pair() {
+        // Given
+        let args = eval_args("eval --substance Water --input1 P=p --input2 P=t --outputs DMass");
+
+        // When
+        let res = run(&args, Cursor::new("p,t\n"), io::sink());
+
+        // Then
+        assert!(matches!(res, Err(EvalError::InvalidInputPair(FluidParam::P, FluidParam::P))));
+    }
+}
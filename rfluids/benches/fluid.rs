@@ -0,0 +1,104 @@
+//! [`Fluid`] state updates, cloning, cached versus uncached outputs
+//! and warm-started versus regular updates along a sequential path.
+//!
+//! Run with:
+//!
+//! ```shell
+//! cargo bench -p rfluids --bench fluid
+//! ```
+
+use std::hint::black_box;
+
+use criterion::{BatchSize, Criterion, criterion_group, criterion_main};
+use rfluids::prelude::*;
+
+fn water() -> Fluid {
+    Fluid::from(Pure::Water)
+        .in_state(FluidInput::pressure(101_325.0), FluidInput::temperature(293.15))
+        .unwrap()
+}
+
+fn fluid(c: &mut Criterion) {
+    let mut group = c.benchmark_group("fluid");
+    let temperatures: Vec<f64> = (0..100).map(|i| 293.15 + f64::from(i) * 0.5).collect();
+    let mut water = water();
+    group.bench_function("in_state", |b| {
+        let mut temperature = temperatures.iter().cycle();
+        b.iter(|| {
+            black_box(
+                water
+                    .in_state(
+                        FluidInput::pressure(101_325.0),
+                        FluidInput::temperature(*temperature.next().unwrap()),
+                    )
+                    .unwrap(),
+            )
+        });
+    });
+    group.bench_function("clone", |b| b.iter(|| black_box(water.clone())));
+    water.density().unwrap();
+    group.bench_function("cached_output", |b| b.iter(|| black_box(water.density().unwrap())));
+    group.bench_function("uncached_output", |b| {
+        b.iter_batched(
+            || water.in_state(FluidInput::pressure(101_325.0), FluidInput::temperature(293.15)),
+            |fluid| black_box(fluid.unwrap().specific_heat().unwrap()),
+            BatchSize::SmallInput,
+        );
+    });
+    group.bench_function("update_and_output", |b| {
+        let mut temperature = temperatures.iter().cycle();
+        b.iter(|| {
+            water
+                .update(
+                    FluidInput::pressure(101_325.0),
+                    FluidInput::temperature(*temperature.next().unwrap()),
+                )
+                .unwrap();
+            black_box(water.density().unwrap())
+        });
+    });
+    group.finish();
+}
+
+/// Pressure and enthalpy along the heated pipe _(each step is close to the previous one)_.
+fn pipe_path() -> Vec<(FluidInput, FluidInput)> {
+    let inlet_enthalpy = water().enthalpy().unwrap();
+    (0..100)
+        .map(|i| {
+            let i = f64::from(i);
+            (
+                FluidInput::pressure(101_325.0 - 10.0 * i),
+                FluidInput::enthalpy(inlet_enthalpy + 200.0 * i),
+            )
+        })
+        .collect()
+}
+
+fn warm_start(c: &mut Criterion) {
+    let mut group = c.benchmark_group("warm_start");
+    let path = pipe_path();
+    group.bench_function("update", |b| {
+        let mut sut = water();
+        b.iter(|| {
+            for &(pressure, enthalpy) in &path {
+                sut.update(pressure, enthalpy).unwrap();
+                black_box(sut.temperature().unwrap());
+            }
+        });
+    });
+    group.bench_function("update_near", |b| {
+        let mut sut = water();
+        let mut previous = water();
+        b.iter(|| {
+            for &(pressure, enthalpy) in &path {
+                sut.update_near(&previous, pressure, enthalpy).unwrap();
+                black_box(sut.temperature().unwrap());
+                std::mem::swap(&mut sut, &mut previous);
+            }
+        });
+    });
+    group.finish();
+}
+
+criterion_group!(benches, fluid, warm_start);
+criterion_main!(benches);
@@ -0,0 +1,71 @@
+//! [`HumidAir`] state updates and outputs _(with canonical and non-canonical inputs)_.
+//!
+//! Run with:
+//!
+//! ```shell
+//! cargo bench -p rfluids --bench humid_air
+//! ```
+
+use std::hint::black_box;
+
+use criterion::{Criterion, criterion_group, criterion_main};
+use rfluids::prelude::*;
+
+fn humid_air(c: &mut Criterion) {
+    let mut group = c.benchmark_group("humid_air");
+    let temperatures: Vec<f64> = (0..100).map(|i| 283.15 + f64::from(i) * 0.2).collect();
+    let inputs = |temperature: f64| {
+        (
+            HumidAirInput::pressure(101_325.0),
+            HumidAirInput::temperature(temperature),
+            HumidAirInput::rel_humidity(0.5),
+        )
+    };
+    let (pressure, temperature, rel_humidity) = inputs(293.15);
+    let mut humid_air = HumidAir::new().in_state(pressure, temperature, rel_humidity).unwrap();
+    group.bench_function("update_and_output", |b| {
+        let mut temperature = temperatures.iter().cycle();
+        b.iter(|| {
+            let (pressure, temperature, rel_humidity) = inputs(*temperature.next().unwrap());
+            humid_air.update(pressure, temperature, rel_humidity).unwrap();
+            black_box(humid_air.enthalpy().unwrap())
+        });
+    });
+    humid_air.update(pressure, temperature, rel_humidity).unwrap();
+    humid_air.enthalpy().unwrap();
+    group.bench_function("cached_output", |b| {
+        b.iter(|| black_box(humid_air.enthalpy().unwrap()));
+    });
+    group.bench_function("update_and_wet_bulb_temperature", |b| {
+        b.iter(|| {
+            humid_air.update(pressure, temperature, rel_humidity).unwrap();
+            black_box(humid_air.wet_bulb_temperature().unwrap())
+        });
+    });
+    // Non-canonical inputs, for which the dry-bulb temperature is solved for once per state
+    let (pressure, enthalpy, rel_humidity) = (
+        HumidAirInput::pressure(101_325.0),
+        HumidAirInput::enthalpy(50_000.0),
+        HumidAirInput::rel_humidity(0.5),
+    );
+    group.bench_function("update_and_output_non_canonical", |b| {
+        b.iter(|| {
+            humid_air.update(pressure, enthalpy, rel_humidity).unwrap();
+            black_box(humid_air.density().unwrap())
+        });
+    });
+    group.bench_function("update_and_outputs_non_canonical", |b| {
+        b.iter(|| {
+            humid_air.update(pressure, enthalpy, rel_humidity).unwrap();
+            black_box((
+                humid_air.density().unwrap(),
+                humid_air.dew_temperature().unwrap(),
+                humid_air.specific_heat().unwrap(),
+            ))
+        });
+    });
+    group.finish();
+}
+
+criterion_group!(benches, humid_air);
+criterion_main!(benches);
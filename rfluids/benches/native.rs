@@ -0,0 +1,69 @@
+//! `CoolProp` native API: [`AbstractState`] updates and outputs for different backends
+//! and [`CoolProp::props_si`] calls.
+//!
+//! Run with:
+//!
+//! ```shell
+//! cargo bench -p rfluids --bench native
+//! ```
+
+use std::hint::black_box;
+
+use criterion::{BenchmarkId, Criterion, criterion_group, criterion_main};
+use rfluids::prelude::*;
+
+/// Temperatures of the sequential updates **\[K\]**.
+fn temperatures(min: f64) -> Vec<f64> {
+    (0..100).map(|i| min + f64::from(i) * 0.5).collect()
+}
+
+fn abstract_state(c: &mut Criterion) {
+    let mut group = c.benchmark_group("abstract_state");
+    let cases = [
+        ("HEOS", "Water", None, 293.15),
+        ("TTSE&HEOS", "Water", None, 293.15),
+        ("BICUBIC&HEOS", "Water", None, 293.15),
+        ("INCOMP", "MPG", Some(0.4), 273.15),
+    ];
+    for (backend, substance, fraction, min_temperature) in cases {
+        let mut state = AbstractState::new(backend, substance).unwrap();
+        if let Some(fraction) = fraction {
+            state.set_fractions(&[fraction]).unwrap();
+        }
+        let temperatures = temperatures(min_temperature);
+        group.bench_function(BenchmarkId::new("update", backend), |b| {
+            let mut temperature = temperatures.iter().cycle();
+            b.iter(|| {
+                state.update(FluidInputPair::PT, 101_325.0, *temperature.next().unwrap()).unwrap();
+            });
+        });
+        state.update(FluidInputPair::PT, 101_325.0, min_temperature).unwrap();
+        group.bench_function(BenchmarkId::new("keyed_output", backend), |b| {
+            b.iter(|| black_box(state.keyed_output(FluidParam::DMass).unwrap()));
+        });
+    }
+    group.finish();
+}
+
+fn props_si(c: &mut Criterion) {
+    let mut group = c.benchmark_group("props_si");
+    let temperatures = temperatures(293.15);
+    group.bench_function("props_si", |b| {
+        let mut temperature = temperatures.iter().cycle();
+        b.iter(|| {
+            black_box(
+                CoolProp::props_si("D", "P", 101_325.0, "T", *temperature.next().unwrap(), "Water")
+                    .unwrap(),
+            )
+        });
+    });
+    let mut density = CoolProp::prepare("D", "P", "T", "Water").unwrap();
+    group.bench_function("prepared_query", |b| {
+        let mut temperature = temperatures.iter().cycle();
+        b.iter(|| black_box(density.eval(101_325.0, *temperature.next().unwrap()).unwrap()));
+    });
+    group.finish();
+}
+
+criterion_group!(benches, abstract_state, props_si);
+criterion_main!(benches);
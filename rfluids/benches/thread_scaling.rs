@@ -0,0 +1,43 @@
+//! Throughput of independent [`AbstractState`] instances against the number of threads.
+//!
+//! Run with:
+//!
+//! ```shell
+//! cargo bench -p rfluids --bench thread_scaling
+//! ```
+
+use std::{hint::black_box, thread::available_parallelism};
+
+use criterion::{BenchmarkId, Criterion, Throughput, criterion_group, criterion_main};
+use rayon::{ThreadPoolBuilder, prelude::*};
+use rfluids::prelude::*;
+
+const POINTS_PER_THREAD: usize = 2_000;
+
+fn thread_scaling(c: &mut Criterion) {
+    let mut group = c.benchmark_group("thread_scaling");
+    group.sample_size(20);
+    let max_threads = available_parallelism().map_or(1, usize::from);
+    let threads = (0..).map(|i| 1 << i).take_while(|&threads| threads < max_threads);
+    for threads in threads.chain([max_threads]) {
+        let pool = ThreadPoolBuilder::new().num_threads(threads).build().unwrap();
+        let mut states: Vec<AbstractState> =
+            (0..threads).map(|_| AbstractState::new("HEOS", "Water").unwrap()).collect();
+        group.throughput(Throughput::Elements((POINTS_PER_THREAD * threads) as u64));
+        group.bench_function(BenchmarkId::from_parameter(threads), |b| {
+            b.iter(|| pool.install(|| states.par_iter_mut().for_each(update_sequence)));
+        });
+    }
+    group.finish();
+}
+
+fn update_sequence(water: &mut AbstractState) {
+    for i in 0..POINTS_PER_THREAD {
+        let temperature = 293.15 + (i % 100) as f64 * 0.5;
+        water.update(FluidInputPair::PT, 101_325.0, temperature).unwrap();
+        black_box(water.keyed_output(FluidParam::DMass).unwrap());
+    }
+}
+
+criterion_group!(benches, thread_scaling);
+criterion_main!(benches);
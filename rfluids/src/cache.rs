@@ -0,0 +1,341 @@
+/// Key of the [`OutputCache`].
+pub(crate) trait CacheKey: Copy + Eq {
+    /// Index of the cache slot _(should be less than the cache capacity)_.
+    fn index(self) -> usize;
+}
+
+/// Dense fixed-size cache of output values indexed by key discriminants.
+///
+/// Successful values are stored inline in a slot array with occupancy bitmasks,
+/// so lookups, insertions and clearing don't hash or allocate, and cloning is a plain
+/// copy in the common case. Errors are rare, so they are kept aside.
+///
+/// `N` -- cache capacity _(should not exceed 128)_.
+#[derive(Clone, Debug)]
+pub(crate) struct OutputCache<K, E, const N: usize> {
+    values: [f64; N],
+    present: u128,
+    failed: u128,
+    errors: Vec<(K, E)>,
+}
+
+impl<K: CacheKey, E: Clone, const N: usize> OutputCache<K, E, N> {
+    #[must_use]
+    pub fn new() -> Self {
+        const { assert!(N <= 128, "cache capacity should not exceed 128") };
+        Self { values: [0.0; N], present: 0, failed: 0, errors: Vec::new() }
+    }
+
+    #[must_use]
+    pub fn get(&self, key: K) -> Option<Result<f64, E>> {
+        let (idx, bit) = Self::slot(key);
+        if self.present & bit == 0 {
+            return None;
+        }
+        if self.failed & bit == 0 {
+            return Some(Ok(self.values[idx]));
+        }
+        self.errors.iter().find(|(k, _)| *k == key).map(|(_, e)| Err(e.clone()))
+    }
+
+    #[must_use]
+    pub fn contains(&self, key: K) -> bool {
+        self.present & Self::slot(key).1 != 0
+    }
+
+    pub fn insert(&mut self, key: K, value: Result<f64, E>) {
+        let (idx, bit) = Self::slot(key);
+        if self.failed & bit != 0 {
+            self.errors.retain(|(k, _)| *k != key);
+            self.failed &= !bit;
+        }
+        match value {
+            Ok(value) => self.values[idx] = value,
+            Err(e) => {
+                self.errors.push((key, e));
+                self.failed |= bit;
+            }
+        }
+        self.present |= bit;
+    }
+
+    pub fn get_or_insert_with(
+        &mut self,
+        key: K,
+        f: impl FnOnce() -> Result<f64, E>,
+    ) -> Result<f64, E> {
+        if let Some(value) = self.get(key) {
+            return value;
+        }
+        let value = f();
+        self.insert(key, value.clone());
+        value
+    }
+
+    pub fn clear(&mut self) {
+        self.present = 0;
+        self.failed = 0;
+        self.errors.clear();
+    }
+
+    #[must_use]
+    #[cfg_attr(not(test), allow(dead_code))]
+    pub fn is_empty(&self) -> bool {
+        self.present == 0
+    }
+
+    fn slot(key: K) -> (usize, u128) {
+        let idx = key.index();
+        debug_assert!(idx < N, "cache key index `{idx}` is out of capacity `{N}`");
+        (idx, 1 << idx)
+    }
+}
+
+impl<K: CacheKey, E: Clone, const N: usize> Default for OutputCache<K, E, N> {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+impl<K: CacheKey, E: Clone + PartialEq, const N: usize> PartialEq for OutputCache<K, E, N> {
+    fn eq(&self, other: &Self) -> bool {
+        let values = self.present & !self.failed;
+        self.present == other.present
+            && self.failed == other.failed
+            && (0..N)
+                .filter(|&idx| values >> idx & 1 == 1)
+                .all(|idx| self.values[idx] == other.values[idx])
+            && self.errors.len() == other.errors.len()
+            && self.errors.iter().all(|x| other.errors.contains(x))
+    }
+}
+
+/// Small cache of output values for keys that can't be indexed densely
+/// (e.g., combinations of several parameters).
+///
+/// Only a few such outputs are usually requested per state,
+/// so entries are looked up by linear search, and clearing keeps the allocated capacity.
+#[derive(Clone, Debug, PartialEq)]
+pub(crate) struct SparseOutputCache<K, E> {
+    entries: Vec<(K, Result<f64, E>)>,
+}
+
+impl<K: Copy + PartialEq, E: Clone> SparseOutputCache<K, E> {
+    #[must_use]
+    pub fn new() -> Self {
+        Self { entries: Vec::new() }
+    }
+
+    #[must_use]
+    pub fn get(&self, key: K) -> Option<Result<f64, E>> {
+        self.entries.iter().find(|(k, _)| *k == key).map(|(_, value)| value.clone())
+    }
+
+    #[must_use]
+    pub fn contains(&self, key: K) -> bool {
+        self.entries.iter().any(|(k, _)| *k == key)
+    }
+
+    pub fn get_or_insert_with(
+        &mut self,
+        key: K,
+        f: impl FnOnce() -> Result<f64, E>,
+    ) -> Result<f64, E> {
+        if let Some(value) = self.get(key) {
+            return value;
+        }
+        let value = f();
+        self.entries.push((key, value.clone()));
+        value
+    }
+
+    pub fn clear(&mut self) {
+        self.entries.clear();
+    }
+
+    #[must_use]
+    #[cfg_attr(not(test), allow(dead_code))]
+    pub fn is_empty(&self) -> bool {
+        self.entries.is_empty()
+    }
+}
+
+impl<K: Copy + PartialEq, E: Clone> Default for SparseOutputCache<K, E> {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use rstest::*;
+
+    use super::*;
+
+    #[derive(Clone, Copy, Debug, Eq, PartialEq)]
+    struct Key(u8);
+
+    impl CacheKey for Key {
+        fn index(self) -> usize {
+            self.0.into()
+        }
+    }
+
+    type Sut = OutputCache<Key, String, 128>;
+
+    #[test]
+    fn new() {
+        // When
+        let sut = Sut::new();
+
+        // Then
+        assert!(sut.is_empty());
+        assert!(!sut.contains(Key(0)));
+        assert_eq!(sut.get(Key(0)), None);
+        assert_eq!(sut.get(Key(127)), None);
+    }
+
+    #[rstest]
+    #[case(Key(0), Ok(42.0))]
+    #[case(Key(127), Ok(-42.0))]
+    #[case(Key(64), Err("error".to_string()))]
+    fn insert(#[case] key: Key, #[case] value: Result<f64, String>) {
+        // Given
+        let mut sut = Sut::new();
+
+        // When
+        sut.insert(key, value.clone());
+
+        // Then
+        assert!(!sut.is_empty());
+        assert!(sut.contains(key));
+        assert_eq!(sut.get(key), Some(value));
+    }
+
+    #[test]
+    fn insert_overrides_error() {
+        // Given
+        let mut sut = Sut::new();
+        sut.insert(Key(1), Err("error".into()));
+
+        // When
+        sut.insert(Key(1), Ok(42.0));
+
+        // Then
+        assert_eq!(sut.get(Key(1)), Some(Ok(42.0)));
+        assert!(sut.errors.is_empty());
+    }
+
+    #[test]
+    fn get_or_insert_with() {
+        // Given
+        let mut sut = Sut::new();
+        let mut calls = 0;
+
+        // When
+        let res1 = sut.get_or_insert_with(Key(2), || {
+            calls += 1;
+            Ok(42.0)
+        });
+        let res2 = sut.get_or_insert_with(Key(2), || {
+            calls += 1;
+            Ok(0.0)
+        });
+
+        // Then
+        assert_eq!(res1, Ok(42.0));
+        assert_eq!(res2, Ok(42.0));
+        assert_eq!(calls, 1);
+    }
+
+    #[test]
+    fn clear() {
+        // Given
+        let mut sut = Sut::new();
+        sut.insert(Key(3), Ok(42.0));
+        sut.insert(Key(4), Err("error".into()));
+
+        // When
+        sut.clear();
+
+        // Then
+        assert!(sut.is_empty());
+        assert_eq!(sut.get(Key(3)), None);
+        assert_eq!(sut.get(Key(4)), None);
+    }
+
+    #[test]
+    fn eq_ignores_stale_slots() {
+        // Given
+        let mut sut = Sut::new();
+        sut.insert(Key(5), Ok(42.0));
+        sut.clear();
+        sut.insert(Key(6), Err("error".into()));
+        let mut other = Sut::new();
+        other.insert(Key(6), Err("error".into()));
+
+        // When
+        let res = sut == other;
+
+        // Then
+        assert!(res);
+    }
+
+    #[test]
+    fn clone() {
+        // Given
+        let mut sut = Sut::new();
+        sut.insert(Key(7), Ok(42.0));
+        sut.insert(Key(8), Err("error".into()));
+
+        // When
+        let clone = sut.clone();
+
+        // Then
+        assert_eq!(clone, sut);
+        assert_eq!(clone.get(Key(7)), Some(Ok(42.0)));
+        assert_eq!(clone.get(Key(8)), Some(Err("error".into())));
+    }
+
+    #[test]
+    fn sparse_get_or_insert_with() {
+        // Given
+        let mut sut = SparseOutputCache::<(Key, Key), String>::new();
+        let mut calls = 0;
+
+        // When
+        let res1 = sut.get_or_insert_with((Key(1), Key(2)), || {
+            calls += 1;
+            Ok(42.0)
+        });
+        let res2 = sut.get_or_insert_with((Key(1), Key(2)), || {
+            calls += 1;
+            Ok(0.0)
+        });
+        let res3 = sut.get_or_insert_with((Key(2), Key(1)), || {
+            calls += 1;
+            Err("error".into())
+        });
+
+        // Then
+        assert_eq!(res1, Ok(42.0));
+        assert_eq!(res2, Ok(42.0));
+        assert_eq!(res3, Err("error".into()));
+        assert_eq!(calls, 2);
+        assert!(sut.contains((Key(2), Key(1))));
+    }
+
+    #[test]
+    fn sparse_clear() {
+        // Given
+        let mut sut = SparseOutputCache::<Key, String>::new();
+        sut.get_or_insert_with(Key(1), || Ok(42.0)).unwrap();
+
+        // When
+        sut.clear();
+
+        // Then
+        assert!(sut.is_empty());
+        assert_eq!(sut.get(Key(1)), None);
+    }
+}
@@ -0,0 +1,73 @@
+//! Chebyshev series shared by the native evaluators of `CoolProp` correlations.
+
+use std::f64::consts::PI;
+
+/// Point of `[-1, 1]` at the `k`-th of `n` zeros of the Chebyshev polynomial of degree `n`
+/// _(collocation nodes)_. Half-integer `k` gives its extrema between the zeros _(check points)_.
+pub(crate) fn node(k: f64, n: usize) -> f64 {
+    (PI * (k + 0.5) / n as f64).cos()
+}
+
+/// Coefficients of the Chebyshev series interpolating the values at the collocation nodes
+/// _(in the same order as [`node`])_.
+pub(crate) fn coefficients(values: &[f64]) -> Vec<f64> {
+    let n = values.len() as f64;
+    (0..values.len())
+        .map(|j| {
+            let sum: f64 = values
+                .iter()
+                .enumerate()
+                .map(|(k, value)| value * (PI * j as f64 * (k as f64 + 0.5) / n).cos())
+                .sum();
+            if j == 0 { sum / n } else { 2.0 * sum / n }
+        })
+        .collect()
+}
+
+/// Evaluates the Chebyshev series of `len` coefficients by the Clenshaw recurrence
+/// over the lane array _(with the `j`-th coefficient of the `lane` from `coefficient(lane, j)`)_.
+pub(crate) fn eval<const L: usize>(
+    len: usize,
+    x: &[f64; L],
+    coefficient: impl Fn(usize, usize) -> f64,
+) -> [f64; L] {
+    let mut b1 = [0.0; L];
+    let mut b2 = [0.0; L];
+    for j in (1..len).rev() {
+        for lane in 0..L {
+            let b0 = 2.0 * x[lane] * b1[lane] - b2[lane] + coefficient(lane, j);
+            b2[lane] = b1[lane];
+            b1[lane] = b0;
+        }
+    }
+    let mut value = [0.0; L];
+    for lane in 0..L {
+        value[lane] = x[lane] * b1[lane] - b2[lane] + coefficient(lane, 0);
+    }
+    value
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::test::assert_relative_eq;
+
+    #[test]
+    fn cubic_is_exact() {
+        // Given
+        let f = |x: f64| 1.0 - 2.0 * x + 3.0 * x.powi(3);
+        let n = 6;
+        let values: Vec<f64> = (0..n).map(|k| f(node(k as f64, n))).collect();
+
+        // When
+        let coefficients = coefficients(&values);
+        let x = [-0.9, -0.3, 0.0, 0.7, 1.0];
+        let res = eval(coefficients.len(), &x, |_, j| coefficients[j]);
+
+        // Then
+        for (res, x) in res.into_iter().zip(x) {
+            assert_relative_eq!(res, f(x));
+        }
+        assert!(coefficients[4..].iter().all(|c| c.abs() < 1e-12));
+    }
+}
@@ -1,9 +1,17 @@
 use crate::{
-    fluid::{FluidBuildError, FluidOutputError, FluidPhaseError, FluidStateError},
-    humid_air::{HumidAirOutputError, HumidAirStateError},
+    fluid::{
+        FluidBatchError, FluidBuildError, FluidCompositionError, FluidEnvelopeError,
+        FluidOutputError, FluidPhaseError, FluidSolveError, FluidStateError,
+    },
+    humid_air::{HumidAirOutputError, HumidAirStateError, HumidAirTableError},
+    incomp::IncompError,
     io::AltitudeError,
     native::CoolPropError,
+    saturation::SaturationError,
     substance::{BinaryMixError, CustomMixError},
+    sweep::SweepError,
+    tabular::TabularError,
+    warmup::WarmupError,
 };
 
 /// Superset of all possible errors that can occur in the library.
@@ -30,6 +38,20 @@ pub enum Error {
     #[error(transparent)]
     FluidPhase(#[from] FluidPhaseError),
 
+    /// Error during calculation of the [`FluidBatch`](crate::fluid::FluidBatch).
+    #[error(transparent)]
+    FluidBatch(#[from] FluidBatchError),
+
+    /// Error during [`Fluid::set_composition`](crate::fluid::Fluid::set_composition)
+    /// or [`Fluid::set_fraction`](crate::fluid::Fluid::set_fraction).
+    #[error(transparent)]
+    FluidComposition(#[from] FluidCompositionError),
+
+    /// Error during calculation of the phase envelope, spinodal or critical points
+    /// of the [`Fluid`](crate::fluid::Fluid).
+    #[error(transparent)]
+    FluidEnvelope(#[from] FluidEnvelopeError),
+
     /// Error during [`Fluid::update`](crate::fluid::Fluid::update)
     /// or [`Fluid::in_state`](crate::fluid::Fluid::in_state).
     #[error(transparent)]
@@ -39,6 +61,10 @@ pub enum Error {
     #[error(transparent)]
     FluidOutput(#[from] FluidOutputError),
 
+    /// Error during [`Fluid::solve_for`](crate::fluid::Fluid::solve_for).
+    #[error(transparent)]
+    FluidSolve(#[from] FluidSolveError),
+
     /// Error during [`HumidAirInput::altitude`](crate::io::HumidAirInput::altitude).
     #[error(transparent)]
     Altitude(#[from] AltitudeError),
@@ -52,4 +78,32 @@ pub enum Error {
     /// output parameter value.
     #[error(transparent)]
     HumidAirOutput(#[from] HumidAirOutputError),
+
+    /// Error during calculation or evaluation of the
+    /// [`HumidAirTable`](crate::humid_air::HumidAirTable).
+    #[error(transparent)]
+    HumidAirTable(#[from] HumidAirTableError),
+
+    /// Error during recovery or evaluation of the
+    /// [`IncompCorrelation`](crate::incomp::IncompCorrelation).
+    #[error(transparent)]
+    Incomp(#[from] IncompError),
+
+    /// Error during fitting or evaluation of the
+    /// [`SaturationCurve`](crate::saturation::SaturationCurve).
+    #[error(transparent)]
+    Saturation(#[from] SaturationError),
+
+    /// Error during [`sweep::grid`](crate::sweep::grid).
+    #[error(transparent)]
+    Sweep(#[from] SweepError),
+
+    /// Error during [`tabular::prebuild`](crate::tabular::prebuild)
+    /// or [`tabular::load`](crate::tabular::load).
+    #[error(transparent)]
+    Tabular(#[from] TabularError),
+
+    /// Error during [`warmup`](crate::warmup).
+    #[error(transparent)]
+    Warmup(#[from] WarmupError),
 }
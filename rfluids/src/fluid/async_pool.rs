@@ -0,0 +1,593 @@
+use std::{
+    collections::{HashMap, VecDeque},
+    future::Future,
+    hash::{Hash, Hasher},
+    num::NonZeroUsize,
+    pin::Pin,
+    sync::{
+        Arc, Condvar, Mutex,
+        atomic::{AtomicU64, Ordering},
+    },
+    task::{Context, Poll, Waker},
+    thread::{self, JoinHandle},
+};
+
+use super::{
+    Fluid, FluidBuildError, FluidStateError, StateResult, pool::PooledState,
+    request::FluidUpdateRequest,
+};
+use crate::{
+    io::{FluidInput, FluidParam, Phase},
+    state_variant::StateVariant,
+    substance::SubstanceWithBackend,
+};
+
+/// Pool of dedicated native worker threads for property evaluation from async code
+/// _(requires the **`async`** feature)_.
+///
+/// Flash calculations can take milliseconds _(e.g., for `HEOS` mixtures)_, so calling
+/// [`Fluid::update`] from async tasks stalls the executor. Instead, the pool evaluates
+/// requests on its own threads, each one with its own native handle pinned for the whole
+/// lifetime of the pool, and [`AsyncFluidPool::evaluate`] returns a future that completes
+/// when the result is ready. It doesn't depend on any specific async runtime.
+///
+/// - **Bounded concurrency** -- at most `queue_capacity` requests are queued or running;
+///   further requests wait _(asynchronously)_ for a free slot, which provides backpressure
+/// - **Request coalescing** -- identical requests that are queued or running at the same time
+///   are evaluated only once, and all of them get the same result
+/// - **Metrics** -- see [`AsyncFluidPool::stats`]
+///
+/// # Examples
+///
+/// ```
+/// use approx::assert_relative_eq;
+/// use rfluids::{fluid::AsyncFluidPool, prelude::*};
+///
+/// # use std::{pin::pin, sync::Arc, task::{Context, Poll, Wake, Waker}, thread::{self, Thread}};
+/// # struct Unpark(Thread);
+/// # impl Wake for Unpark {
+/// #     fn wake(self: Arc<Self>) {
+/// #         self.0.unpark();
+/// #     }
+/// # }
+/// # fn block_on<F: Future>(future: F) -> F::Output {
+/// #     let waker = Waker::from(Arc::new(Unpark(thread::current())));
+/// #     let mut cx = Context::from_waker(&waker);
+/// #     let mut future = pin!(future);
+/// #     loop {
+/// #         match future.as_mut().poll(&mut cx) {
+/// #             Poll::Ready(res) => return res,
+/// #             Poll::Pending => thread::park(),
+/// #         }
+/// #     }
+/// # }
+/// let pool = AsyncFluidPool::new(&Fluid::from(Pure::Water), 2, 64)?;
+/// let (pressure, temperature) = (FluidInput::pressure(101_325.0), FluidInput::temperature(293.15));
+/// // Any async runtime can be used to await the result (e.g., `tokio`)
+/// let res = block_on(pool.evaluate(pressure, temperature, &[FluidParam::DMass]))?;
+/// assert_relative_eq!(res[0], 998.207_150_467_928_4, max_relative = 1e-6);
+/// # Ok::<(), rfluids::Error>(())
+/// ```
+#[derive(Debug)]
+pub struct AsyncFluidPool {
+    shared: Arc<Shared>,
+    workers: Vec<JoinHandle<()>>,
+}
+
+impl AsyncFluidPool {
+    /// Creates a new pool with the same substance, backend and specified phase
+    /// as the `fluid`.
+    ///
+    /// # Arguments
+    ///
+    /// - `fluid` -- fluid of any state variant
+    /// - `workers` -- number of worker threads _(if `0`,
+    ///   [`std::thread::available_parallelism`] is used)_
+    /// - `queue_capacity` -- maximum number of queued or running requests
+    ///   _(at least `1`)_
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`FluidBuildError`] if the native handles can't be created
+    /// or the phase can't be specified for them.
+    pub fn new<S: StateVariant>(
+        fluid: &Fluid<S>,
+        workers: usize,
+        queue_capacity: usize,
+    ) -> Result<Self, FluidBuildError> {
+        let request = SubstanceWithBackend {
+            substance: fluid.substance.clone(),
+            backend: fluid.backend_variant,
+        };
+        let workers = if workers == 0 {
+            thread::available_parallelism().map_or(1, NonZeroUsize::get)
+        } else {
+            workers
+        };
+        // Native handles are created upfront, so all errors are reported here
+        let states = (0..workers)
+            .map(|_| {
+                let mut state = PooledState::checkout(&request)?;
+                if fluid.specified_phase != Phase::NotImposed {
+                    state.specify_phase(fluid.specified_phase)?;
+                }
+                Ok(state)
+            })
+            .collect::<Result<Vec<_>, _>>()?;
+        let shared = Arc::new(Shared {
+            queue: Mutex::new(Queue::default()),
+            available: Condvar::new(),
+            capacity: queue_capacity.max(1),
+            stats: Stats::default(),
+        });
+        let workers = states
+            .into_iter()
+            .map(|state| {
+                let shared = Arc::clone(&shared);
+                thread::spawn(move || shared.work(state))
+            })
+            .collect();
+        Ok(Self { shared, workers })
+    }
+
+    /// Evaluates the output parameters in the specified thermodynamic state
+    /// on the worker thread.
+    ///
+    /// The returned future completes with the output values in the same order as `outputs`
+    /// _(values that can't be calculated are [`f64::NAN`])_.
+    ///
+    /// # Arguments
+    ///
+    /// - `input1` -- first input property
+    /// - `input2` -- second input property
+    /// - `outputs` -- output parameters
+    ///
+    /// # Errors
+    ///
+    /// The future completes with a [`FluidStateError`]
+    /// for invalid/unsupported inputs or invalid state.
+    pub fn evaluate(
+        &self,
+        input1: FluidInput,
+        input2: FluidInput,
+        outputs: &[FluidParam],
+    ) -> Evaluation<'_> {
+        let step = match FluidUpdateRequest::try_from((input1, input2)) {
+            Ok(request) => Step::Enqueue(JobKey::new(request, outputs), None),
+            Err(e) => Step::Done(Some(Err(e))),
+        };
+        Evaluation { pool: self, step }
+    }
+
+    /// Current metrics of the pool.
+    #[must_use]
+    pub fn stats(&self) -> AsyncFluidPoolStats {
+        let (queued, in_flight, waiting) = {
+            let queue = self.shared.queue.lock().unwrap();
+            (queue.jobs.len(), queue.in_flight.len(), queue.waiting.len())
+        };
+        let stats = &self.shared.stats;
+        AsyncFluidPoolStats {
+            queued,
+            in_flight,
+            waiting,
+            completed: stats.completed.load(Ordering::Relaxed),
+            coalesced: stats.coalesced.load(Ordering::Relaxed),
+            backpressured: stats.backpressured.load(Ordering::Relaxed),
+        }
+    }
+}
+
+impl Drop for AsyncFluidPool {
+    /// Waits for all queued requests to complete and stops the worker threads.
+    fn drop(&mut self) {
+        self.shared.queue.lock().unwrap().closed = true;
+        self.shared.available.notify_all();
+        for worker in self.workers.drain(..) {
+            let _unused = worker.join();
+        }
+    }
+}
+
+/// Metrics of the [`AsyncFluidPool`].
+#[derive(Clone, Copy, Debug, Default, Eq, PartialEq)]
+pub struct AsyncFluidPoolStats {
+    /// Number of requests waiting for a worker thread.
+    pub queued: usize,
+
+    /// Number of distinct requests queued or running.
+    pub in_flight: usize,
+
+    /// Number of requests waiting for a free slot in the queue.
+    pub waiting: usize,
+
+    /// Total number of evaluated requests.
+    pub completed: u64,
+
+    /// Total number of requests coalesced with identical requests in flight.
+    pub coalesced: u64,
+
+    /// Total number of times the request had to wait for a free slot in the queue.
+    pub backpressured: u64,
+}
+
+/// Future of the [`AsyncFluidPool::evaluate`] result.
+#[derive(Debug)]
+#[must_use = "futures do nothing unless you `.await` or poll them"]
+pub struct Evaluation<'a> {
+    pool: &'a AsyncFluidPool,
+    step: Step,
+}
+
+#[derive(Debug)]
+enum Step {
+    /// Request to enqueue and the ID of its waker waiting for a free slot _(if any)_.
+    Enqueue(JobKey, Option<u64>),
+    Wait(Arc<Job>),
+    Done(Option<StateResult<Vec<f64>>>),
+}
+
+impl Future for Evaluation<'_> {
+    type Output = StateResult<Vec<f64>>;
+
+    fn poll(self: Pin<&mut Self>, cx: &mut Context<'_>) -> Poll<Self::Output> {
+        let this = self.get_mut();
+        if let Step::Enqueue(key, waiter) = &mut this.step {
+            match this.pool.shared.enqueue(key, waiter, cx.waker()) {
+                Some(job) => this.step = Step::Wait(job),
+                None => return Poll::Pending,
+            }
+        }
+        match &mut this.step {
+            Step::Wait(job) => {
+                // The outcome is set before the wakers are taken,
+                // so the waker can't be missed while the outcome is locked
+                let outcome = job.outcome.lock().unwrap();
+                if let Some(res) = &*outcome {
+                    return Poll::Ready(res.clone());
+                }
+                register(&mut job.wakers.lock().unwrap(), cx.waker());
+                Poll::Pending
+            }
+            Step::Done(res) => Poll::Ready(res.take().expect("future polled after completion")),
+            Step::Enqueue(..) => unreachable!(),
+        }
+    }
+}
+
+impl Drop for Evaluation<'_> {
+    fn drop(&mut self) {
+        if let Step::Enqueue(_, Some(waiter)) = self.step {
+            self.pool.shared.cancel(waiter);
+        }
+    }
+}
+
+/// Registers the waker, unless the same one is already registered.
+fn register(wakers: &mut Vec<Waker>, waker: &Waker) {
+    if !wakers.iter().any(|x| x.will_wake(waker)) {
+        wakers.push(waker.clone());
+    }
+}
+
+/// Identity of the request used for coalescing _(input values are compared bitwise)_.
+#[derive(Clone, Debug)]
+struct JobKey {
+    request: FluidUpdateRequest,
+    outputs: Vec<FluidParam>,
+}
+
+impl JobKey {
+    fn new(request: FluidUpdateRequest, outputs: &[FluidParam]) -> Self {
+        Self { request, outputs: outputs.to_vec() }
+    }
+
+    fn bits(&self) -> (u8, u64, u64) {
+        let FluidUpdateRequest { input_pair, value1, value2 } = self.request;
+        (input_pair.into(), value1.to_bits(), value2.to_bits())
+    }
+}
+
+impl PartialEq for JobKey {
+    fn eq(&self, other: &Self) -> bool {
+        self.bits() == other.bits() && self.outputs == other.outputs
+    }
+}
+
+impl Eq for JobKey {}
+
+impl Hash for JobKey {
+    fn hash<H: Hasher>(&self, state: &mut H) {
+        self.bits().hash(state);
+        self.outputs.hash(state);
+    }
+}
+
+#[derive(Debug)]
+struct Job {
+    key: JobKey,
+    outcome: Mutex<Option<StateResult<Vec<f64>>>>,
+    wakers: Mutex<Vec<Waker>>,
+}
+
+#[derive(Debug, Default)]
+struct Queue {
+    jobs: VecDeque<Arc<Job>>,
+    in_flight: HashMap<JobKey, Arc<Job>>,
+    waiting: VecDeque<(u64, Waker)>,
+    last_waiter: u64,
+    closed: bool,
+}
+
+impl Queue {
+    /// Takes the first waker waiting for a free slot, if there is one.
+    fn next_waiter(&mut self, capacity: usize) -> Option<Waker> {
+        if self.in_flight.len() < capacity {
+            self.waiting.pop_front().map(|(_, waker)| waker)
+        } else {
+            None
+        }
+    }
+}
+
+#[derive(Debug, Default)]
+struct Stats {
+    completed: AtomicU64,
+    coalesced: AtomicU64,
+    backpressured: AtomicU64,
+}
+
+#[derive(Debug)]
+struct Shared {
+    queue: Mutex<Queue>,
+    available: Condvar,
+    capacity: usize,
+    stats: Stats,
+}
+
+impl Shared {
+    /// Returns the job for the request _(new or identical one in flight)_
+    /// or `None` if the queue is full.
+    ///
+    /// In the latter case, the waker is registered under the `waiter` ID
+    /// _(assigned on the first call)_ and woken once a slot is freed.
+    fn enqueue(&self, key: &JobKey, waiter: &mut Option<u64>, waker: &Waker) -> Option<Arc<Job>> {
+        let mut queue = self.queue.lock().unwrap();
+        let job = if let Some(job) = queue.in_flight.get(key) {
+            self.stats.coalesced.fetch_add(1, Ordering::Relaxed);
+            Arc::clone(job)
+        } else if queue.in_flight.len() >= self.capacity {
+            self.stats.backpressured.fetch_add(1, Ordering::Relaxed);
+            // The request that is still waiting keeps its place in the line
+            match waiter.and_then(|id| queue.waiting.iter_mut().find(|(x, _)| *x == id)) {
+                Some((_, registered)) => registered.clone_from(waker),
+                None => {
+                    queue.last_waiter += 1;
+                    let id = queue.last_waiter;
+                    queue.waiting.push_back((id, waker.clone()));
+                    *waiter = Some(id);
+                }
+            }
+            return None;
+        } else {
+            let job = Arc::new(Job {
+                key: key.clone(),
+                outcome: Mutex::new(None),
+                wakers: Mutex::new(Vec::new()),
+            });
+            queue.in_flight.insert(key.clone(), Arc::clone(&job));
+            queue.jobs.push_back(Arc::clone(&job));
+            self.available.notify_one();
+            job
+        };
+        if let Some(id) = waiter.take() {
+            queue.waiting.retain(|(x, _)| *x != id);
+        }
+        // The slot this request was woken for may be left free _(e.g., after coalescing)_
+        let next = queue.next_waiter(self.capacity);
+        drop(queue);
+        if let Some(waker) = next {
+            waker.wake();
+        }
+        Some(job)
+    }
+
+    /// Removes the waker of the dropped request waiting for a free slot.
+    fn cancel(&self, waiter: u64) {
+        let mut queue = self.queue.lock().unwrap();
+        queue.waiting.retain(|(x, _)| *x != waiter);
+        // The request could be already woken for a free slot, so it's passed on
+        let next = queue.next_waiter(self.capacity);
+        drop(queue);
+        if let Some(waker) = next {
+            waker.wake();
+        }
+    }
+
+    fn work(&self, mut state: PooledState) {
+        loop {
+            let job = {
+                let mut queue = self.queue.lock().unwrap();
+                loop {
+                    if let Some(job) = queue.jobs.pop_front() {
+                        break job;
+                    }
+                    if queue.closed {
+                        return;
+                    }
+                    queue = self.available.wait(queue).unwrap();
+                }
+            };
+            let res = evaluate(&mut state, &job.key);
+            *job.outcome.lock().unwrap() = Some(res);
+            let next = {
+                let mut queue = self.queue.lock().unwrap();
+                queue.in_flight.remove(&job.key);
+                queue.next_waiter(self.capacity)
+            };
+            self.stats.completed.fetch_add(1, Ordering::Relaxed);
+            job.wakers.lock().unwrap().drain(..).chain(next).for_each(Waker::wake);
+        }
+    }
+}
+
+fn evaluate(state: &mut PooledState, key: &JobKey) -> StateResult<Vec<f64>> {
+    let request = key.request;
+    state
+        .update(request.input_pair, request.value1, request.value2)
+        .map_err(FluidStateError::UpdateFailed)?;
+    Ok(key.outputs.iter().map(|&output| state.keyed_output(output).unwrap_or(f64::NAN)).collect())
+}
+
+#[cfg(test)]
+mod tests {
+    use std::{
+        pin::pin,
+        task::Wake,
+        thread::{self, Thread},
+    };
+
+    use super::*;
+    use crate::{substance::Pure, test::assert_relative_eq};
+
+    struct Unpark(Thread);
+
+    impl Wake for Unpark {
+        fn wake(self: Arc<Self>) {
+            self.0.unpark();
+        }
+    }
+
+    fn block_on<F: Future>(future: F) -> F::Output {
+        let waker = Waker::from(Arc::new(Unpark(thread::current())));
+        let mut cx = Context::from_waker(&waker);
+        let mut future = pin!(future);
+        loop {
+            match future.as_mut().poll(&mut cx) {
+                Poll::Ready(res) => return res,
+                Poll::Pending => thread::park(),
+            }
+        }
+    }
+
+    #[test]
+    fn evaluate_valid_inputs() {
+        // Given
+        let sut = AsyncFluidPool::new(&Fluid::from(Pure::Water), 2, 8).unwrap();
+
+        // When
+        let res = block_on(sut.evaluate(
+            FluidInput::temperature(293.15),
+            FluidInput::pressure(101_325.0),
+            &[FluidParam::DMass, FluidParam::P],
+        ))
+        .unwrap();
+
+        // Then
+        assert_relative_eq!(res[0], 998.207_150_467_928_4);
+        assert_relative_eq!(res[1], 101_325.0);
+        assert_eq!(sut.stats().completed, 1);
+    }
+
+    #[test]
+    fn evaluate_invalid_inputs() {
+        // Given
+        let sut = AsyncFluidPool::new(&Fluid::from(Pure::Water), 1, 8).unwrap();
+        let pressure = FluidInput::pressure(101_325.0);
+
+        // When
+        let invalid_pair = block_on(sut.evaluate(pressure, pressure, &[FluidParam::DMass]));
+        let invalid_state = block_on(sut.evaluate(
+            FluidInput::pressure(-1.0),
+            FluidInput::temperature(293.15),
+            &[FluidParam::DMass],
+        ));
+
+        // Then
+        assert_eq!(
+            invalid_pair,
+            Err(FluidStateError::InvalidInputPair(pressure.key, pressure.key))
+        );
+        assert!(matches!(invalid_state, Err(FluidStateError::UpdateFailed(_))));
+    }
+
+    #[test]
+    fn evaluate_concurrent_requests() {
+        // Given
+        let sut = AsyncFluidPool::new(&Fluid::from(Pure::Water), 2, 2).unwrap();
+        let temperatures: Vec<f64> = (0..32).map(|i| 283.15 + f64::from(i % 8)).collect();
+
+        // When
+        let res: Vec<_> = thread::scope(|scope| {
+            let handles: Vec<_> = temperatures
+                .iter()
+                .map(|&temperature| {
+                    let sut = &sut;
+                    scope.spawn(move || {
+                        block_on(sut.evaluate(
+                            FluidInput::pressure(101_325.0),
+                            FluidInput::temperature(temperature),
+                            &[FluidParam::T],
+                        ))
+                    })
+                })
+                .collect();
+            handles.into_iter().map(|handle| handle.join().unwrap().unwrap()[0]).collect()
+        });
+
+        // Then
+        for (value, temperature) in res.into_iter().zip(temperatures) {
+            assert_relative_eq!(value, temperature);
+        }
+        let stats = sut.stats();
+        assert_eq!(stats.completed + stats.coalesced, 32);
+        assert_eq!(stats.in_flight, 0);
+    }
+
+    #[test]
+    fn dropped_evaluation_stops_waiting() {
+        // Given
+        let sut = AsyncFluidPool {
+            shared: Arc::new(Shared {
+                queue: Mutex::new(Queue::default()),
+                available: Condvar::new(),
+                capacity: 1,
+                stats: Stats::default(),
+            }),
+            workers: Vec::new(),
+        };
+        let waker = Waker::from(Arc::new(Unpark(thread::current())));
+        let mut cx = Context::from_waker(&waker);
+        let pressure = FluidInput::pressure(101_325.0);
+        let mut first = pin!(sut.evaluate(pressure, FluidInput::temperature(293.15), &[]));
+        let mut second = Box::pin(sut.evaluate(pressure, FluidInput::temperature(303.15), &[]));
+        assert!(first.as_mut().poll(&mut cx).is_pending());
+        assert!(second.as_mut().poll(&mut cx).is_pending());
+        assert_eq!(sut.stats().waiting, 1);
+
+        // When
+        drop(second);
+
+        // Then
+        assert_eq!(sut.stats().waiting, 0);
+        assert_eq!(sut.stats().in_flight, 1);
+    }
+
+    #[test]
+    fn new_specified_phase() {
+        // Given
+        let fluid = Fluid::from(Pure::Water).specify_phase(Phase::Liquid).unwrap();
+        let sut = AsyncFluidPool::new(&fluid, 1, 1).unwrap();
+
+        // When
+        let res = block_on(sut.evaluate(
+            FluidInput::pressure(101_325.0),
+            FluidInput::temperature(293.15),
+            &[FluidParam::Phase],
+        ))
+        .unwrap();
+
+        // Then
+        assert_eq!(res[0], f64::from(u8::from(Phase::Liquid)));
+    }
+}
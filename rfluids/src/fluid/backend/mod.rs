@@ -33,7 +33,7 @@ mod base;
 mod default;
 mod tabular;
 
-use std::borrow::Cow;
+use std::{borrow::Cow, str::FromStr};
 
 pub use base::*;
 pub use default::*;
@@ -67,6 +67,15 @@ pub use tabular::*;
 /// let tabular = BaseBackend::Heos.with(TabularMethod::Ttse);
 /// assert_eq!(tabular.name(), "TTSE&HEOS");
 /// ```
+///
+/// Parsing from the name recognized by `CoolProp` _(case-insensitive)_:
+///
+/// ```
+/// use rfluids::prelude::*;
+///
+/// assert_eq!("HEOS".parse(), Ok(Backend::Base(BaseBackend::Heos)));
+/// assert_eq!("ttse&heos".parse(), Ok(BaseBackend::Heos.with(TabularMethod::Ttse)));
+/// ```
 #[derive(Clone, Copy, Debug, Eq, Hash, PartialEq)]
 pub enum Backend {
     /// Base backend.
@@ -115,6 +124,20 @@ impl From<BaseBackend> for Backend {
     }
 }
 
+impl FromStr for Backend {
+    type Err = strum::ParseError;
+
+    fn from_str(s: &str) -> Result<Self, Self::Err> {
+        match s.split_once('&') {
+            Some((method, base)) => Ok(Self::Tabular {
+                base: BaseBackend::from_str(base)?,
+                method: TabularMethod::from_str(method)?,
+            }),
+            None => BaseBackend::from_str(s).map(Self::Base),
+        }
+    }
+}
+
 #[cfg(test)]
 mod tests {
     use rstest::*;
@@ -157,4 +180,31 @@ mod tests {
         assert_eq!(res, expected);
         assert_eq!(matches!(res, Cow::Owned(_)), is_owned);
     }
+
+    #[rstest]
+    #[case("HEOS", Heos.into())]
+    #[case("if97", If97.into())]
+    #[case("TTSE&HEOS", Heos.with(Ttse))]
+    #[case("bicubic&refprop", Refprop.with(Bicubic))]
+    fn from_valid_str(#[case] s: &str, #[case] expected: Backend) {
+        // When
+        let res = Backend::from_str(s);
+
+        // Then
+        assert_eq!(res, Ok(expected));
+    }
+
+    #[rstest]
+    #[case("")]
+    #[case("Hello, World!")]
+    #[case("HEOS&TTSE")]
+    #[case("TTSE&")]
+    #[case("TTSE&BICUBIC&HEOS")]
+    fn from_invalid_str(#[case] s: &str) {
+        // When
+        let res = Backend::from_str(s);
+
+        // Then
+        assert!(res.is_err());
+    }
 }
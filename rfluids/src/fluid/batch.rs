@@ -0,0 +1,391 @@
+use std::{num::NonZeroUsize, thread};
+
+use super::{Fluid, FluidBatchError, pool::PooledState};
+use crate::{
+    io::{FluidInputPair, FluidParam, Phase},
+    native::CoolPropError,
+    state_variant::StateVariant,
+    substance::SubstanceWithBackend,
+};
+
+/// Minimum number of states calculated per thread.
+const MIN_CHUNK_LEN: usize = 256;
+
+/// Columnar storage of many thermodynamic states of the same substance.
+///
+/// Unlike the collection of [`Fluid`] instances, it shares one substance, backend and
+/// specified phase across all states, and stores inputs and outputs as contiguous
+/// [`f64`] columns, so it's suitable for millions of states _(e.g., nodes of the pipeline
+/// network simulation)_. On [`FluidBatch::calculate`], the states are split into
+/// contiguous chunks, which are calculated in parallel over native handles checked out
+/// from the pool of the calling thread _(so they are reused by the further calls)_.
+///
+/// Outputs are stored in column-major order _(see [`FluidBatch::outputs`])_,
+/// so they can be viewed without copying by any array library
+/// _(e.g., as `ndarray::ArrayView2` of shape `(output_keys.len(), len)`)_.
+///
+/// # Examples
+///
+/// ```
+/// use approx::assert_relative_eq;
+/// use rfluids::{fluid::FluidBatch, prelude::*};
+///
+/// let water = Fluid::from(Pure::Water);
+/// let mut batch =
+///     FluidBatch::new(&water, FluidInputPair::PT, &[FluidParam::DMass, FluidParam::CpMass]);
+/// batch.extend_from_slices(&[101_325.0, 101_325.0], &[293.15, 313.15])?;
+/// batch.calculate()?;
+/// let density = batch.output(FluidParam::DMass).unwrap();
+/// assert_relative_eq!(density[0], 998.207_150_467_928_4, max_relative = 1e-6);
+/// # Ok::<(), rfluids::Error>(())
+/// ```
+///
+/// # See Also
+///
+/// - [`AbstractState::update_batch`](crate::native::AbstractState::update_batch)
+#[derive(Clone, Debug)]
+pub struct FluidBatch {
+    request: SubstanceWithBackend,
+    specified_phase: Phase,
+    input_pair: FluidInputPair,
+    output_keys: Vec<FluidParam>,
+    input1: Vec<f64>,
+    input2: Vec<f64>,
+    outputs: Vec<f64>,
+}
+
+impl FluidBatch {
+    /// Creates an empty batch with the same substance, backend and specified phase
+    /// as the `fluid`.
+    ///
+    /// # Arguments
+    ///
+    /// - `fluid` -- fluid of any state variant
+    /// - `input_pair` -- input pair of all states
+    /// - `output_keys` -- output parameters calculated for all states
+    #[must_use]
+    pub fn new<S: StateVariant>(
+        fluid: &Fluid<S>,
+        input_pair: FluidInputPair,
+        output_keys: &[FluidParam],
+    ) -> Self {
+        Self {
+            request: SubstanceWithBackend {
+                substance: fluid.substance.clone(),
+                backend: fluid.backend_variant,
+            },
+            specified_phase: fluid.specified_phase,
+            input_pair,
+            output_keys: output_keys.to_vec(),
+            input1: Vec::new(),
+            input2: Vec::new(),
+            outputs: Vec::new(),
+        }
+    }
+
+    /// Number of states.
+    #[must_use]
+    pub fn len(&self) -> usize {
+        self.input1.len()
+    }
+
+    /// Returns `true` if there are no states.
+    #[must_use]
+    pub fn is_empty(&self) -> bool {
+        self.input1.is_empty()
+    }
+
+    /// Input pair of all states.
+    #[must_use]
+    pub fn input_pair(&self) -> FluidInputPair {
+        self.input_pair
+    }
+
+    /// Output parameters calculated for all states.
+    #[must_use]
+    pub fn output_keys(&self) -> &[FluidParam] {
+        &self.output_keys
+    }
+
+    /// Values of the first input property of the pair for all states **\[SI units\]**.
+    #[must_use]
+    pub fn input1(&self) -> &[f64] {
+        &self.input1
+    }
+
+    /// Values of the second input property of the pair for all states **\[SI units\]**.
+    #[must_use]
+    pub fn input2(&self) -> &[f64] {
+        &self.input2
+    }
+
+    /// Appends the state and returns a mutable reference to itself.
+    ///
+    /// Previously calculated outputs are discarded.
+    ///
+    /// # Arguments
+    ///
+    /// - `value1` -- value of the first input property of the pair **\[SI units\]**
+    /// - `value2` -- value of the second input property of the pair **\[SI units\]**
+    pub fn push(&mut self, value1: f64, value2: f64) -> &mut Self {
+        self.input1.push(value1);
+        self.input2.push(value2);
+        self.outputs.clear();
+        self
+    }
+
+    /// Appends the states and returns a mutable reference to itself.
+    ///
+    /// Previously calculated outputs are discarded.
+    ///
+    /// # Arguments
+    ///
+    /// - `input1` -- values of the first input property of the pair **\[SI units\]**
+    /// - `input2` -- values of the second input property of the pair **\[SI units\]**
+    ///   _(should have the same length as `input1`)_
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`FluidBatchError`] if the inputs have different lengths.
+    pub fn extend_from_slices(
+        &mut self,
+        input1: &[f64],
+        input2: &[f64],
+    ) -> Result<&mut Self, FluidBatchError> {
+        if input1.len() != input2.len() {
+            return Err(CoolPropError::InvalidLength {
+                arg: "input2",
+                expected: input1.len(),
+                actual: input2.len(),
+            }
+            .into());
+        }
+        self.input1.extend_from_slice(input1);
+        self.input2.extend_from_slice(input2);
+        self.outputs.clear();
+        Ok(self)
+    }
+
+    /// Removes all states and returns a mutable reference to itself.
+    ///
+    /// Allocated capacity of the columns is kept, so the batch can be refilled
+    /// without any allocations.
+    pub fn clear(&mut self) -> &mut Self {
+        self.input1.clear();
+        self.input2.clear();
+        self.outputs.clear();
+        self
+    }
+
+    /// Calculates the outputs for all states and returns a mutable reference to itself.
+    ///
+    /// States are split into contiguous chunks _(at least 256 states each)_,
+    /// which are calculated in parallel on up to
+    /// [`std::thread::available_parallelism`] threads.
+    /// If the calculation fails for some state, its outputs are set to [`f64::NAN`].
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`FluidBatchError`] if the native handle can't be created
+    /// or the phase can't be specified.
+    pub fn calculate(&mut self) -> Result<&mut Self, FluidBatchError> {
+        let len = self.len();
+        self.outputs.clear();
+        self.outputs.resize(len * self.output_keys.len(), f64::NAN);
+        if len == 0 || self.output_keys.is_empty() {
+            return Ok(self);
+        }
+        let threads = thread::available_parallelism()
+            .map_or(1, NonZeroUsize::get)
+            .min(len.div_ceil(MIN_CHUNK_LEN));
+        let chunk_len = len.div_ceil(threads);
+        let Self { request, specified_phase, input_pair, output_keys, input1, input2, outputs } =
+            &mut *self;
+        let chunks_count = len.div_ceil(chunk_len);
+        // Native handles are checked out on the current thread and returned to its pool
+        // after the workers are joined, so they are reused by the further calls
+        let states = (0..chunks_count)
+            .map(|_| {
+                let mut state = PooledState::checkout(request)?;
+                if *specified_phase != Phase::NotImposed {
+                    state.specify_phase(*specified_phase)?;
+                }
+                Ok(state)
+            })
+            .collect::<Result<Vec<_>, CoolPropError>>()?;
+        let job = &Job { input_pair: *input_pair, output_keys: output_keys.as_slice() };
+        let mut chunks: Vec<Vec<&mut [f64]>> =
+            (0..chunks_count).map(|_| Vec::with_capacity(output_keys.len())).collect();
+        for column in outputs.chunks_mut(len) {
+            for (chunk, values) in chunks.iter_mut().zip(column.chunks_mut(chunk_len)) {
+                chunk.push(values);
+            }
+        }
+        let mut chunks = states
+            .into_iter()
+            .zip(chunks)
+            .zip(input1.chunks(chunk_len).zip(input2.chunks(chunk_len)))
+            .map(|((state, columns), (input1, input2))| (state, input1, input2, columns));
+        let (mut first_state, first_input1, first_input2, mut first_columns) =
+            chunks.next().unwrap();
+        thread::scope(|scope| {
+            let workers: Vec<_> = chunks
+                .map(|(mut state, input1, input2, mut columns)| {
+                    scope.spawn(move || {
+                        let res = job.calculate(&mut state, input1, input2, &mut columns);
+                        (res, state)
+                    })
+                })
+                .collect();
+            let res =
+                job.calculate(&mut first_state, first_input1, first_input2, &mut first_columns);
+            // Handles are moved back, so they are dropped into the pool of the current thread
+            workers
+                .into_iter()
+                .map(|worker| worker.join().unwrap())
+                .fold(res, |res, (worker_res, _state)| res.and(worker_res))
+        })?;
+        Ok(self)
+    }
+
+    /// Calculated values of the output parameter for all states **\[SI units\]**
+    /// _(`None` if it's not requested or the outputs are not calculated yet)_.
+    ///
+    /// # Arguments
+    ///
+    /// - `key` -- output parameter
+    #[must_use]
+    pub fn output(&self, key: FluidParam) -> Option<&[f64]> {
+        let index = self.output_keys.iter().position(|&x| x == key)?;
+        let len = self.len();
+        (!self.outputs.is_empty()).then(|| &self.outputs[index * len..][..len])
+    }
+
+    /// All calculated outputs in column-major order **\[SI units\]**
+    /// _(empty if the outputs are not calculated yet)_,
+    /// i.e., the value of the `j`-th output parameter for the `i`-th state
+    /// is at index `j * len() + i`.
+    #[must_use]
+    pub fn outputs(&self) -> &[f64] {
+        &self.outputs
+    }
+}
+
+/// Shared parameters of the chunk calculations.
+struct Job<'a> {
+    input_pair: FluidInputPair,
+    output_keys: &'a [FluidParam],
+}
+
+impl Job<'_> {
+    fn calculate(
+        &self,
+        state: &mut PooledState,
+        input1: &[f64],
+        input2: &[f64],
+        columns: &mut [&mut [f64]],
+    ) -> Result<(), CoolPropError> {
+        state.update_batch_columns(self.input_pair, input1, input2, self.output_keys, columns)
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::{fluid::pool::idle_len, io::FluidInput, substance::Pure, test::assert_relative_eq};
+
+    #[test]
+    fn calculate_matches_fluid() {
+        // Given
+        let water = Fluid::from(Pure::Water);
+        let temperatures: Vec<f64> = (0..1_000).map(|i| 280.0 + 0.05 * f64::from(i)).collect();
+        let pressures = vec![101_325.0; temperatures.len()];
+        let mut sut = FluidBatch::new(&water, FluidInputPair::PT, &[FluidParam::DMass]);
+        sut.extend_from_slices(&pressures, &temperatures).unwrap();
+
+        // When
+        sut.calculate().unwrap();
+
+        // Then
+        let res = sut.output(FluidParam::DMass).unwrap();
+        assert_eq!(res.len(), temperatures.len());
+        for (i, &temperature) in temperatures.iter().enumerate().step_by(111) {
+            let mut expected = Fluid::from(Pure::Water)
+                .in_state(FluidInput::pressure(101_325.0), FluidInput::temperature(temperature))
+                .unwrap();
+            assert_relative_eq!(res[i], expected.density().unwrap());
+        }
+    }
+
+    #[test]
+    fn calculate_returns_handles_to_current_thread() {
+        // Given
+        let water = Fluid::from(Pure::Water);
+        let temperatures: Vec<f64> = (0..2_048).map(|i| 280.0 + 0.01 * f64::from(i)).collect();
+        let pressures = vec![101_325.0; temperatures.len()];
+        let mut sut = FluidBatch::new(&water, FluidInputPair::PT, &[FluidParam::DMass]);
+        sut.extend_from_slices(&pressures, &temperatures).unwrap();
+        let threads = thread::available_parallelism()
+            .map_or(1, NonZeroUsize::get)
+            .min(temperatures.len().div_ceil(MIN_CHUNK_LEN));
+        let expected = temperatures.len().div_ceil(temperatures.len().div_ceil(threads));
+
+        // When
+        sut.calculate().unwrap();
+        let idle = idle_len();
+        sut.calculate().unwrap();
+
+        // Then
+        assert_eq!(idle, expected);
+        assert_eq!(idle_len(), expected);
+    }
+
+    #[test]
+    fn calculate_invalid_state() {
+        // Given
+        let water = Fluid::from(Pure::Water);
+        let mut sut =
+            FluidBatch::new(&water, FluidInputPair::PT, &[FluidParam::DMass, FluidParam::HMass]);
+        sut.push(101_325.0, 293.15).push(-1.0, 293.15);
+
+        // When
+        sut.calculate().unwrap();
+
+        // Then
+        assert_eq!(sut.outputs().len(), 4);
+        assert_relative_eq!(sut.output(FluidParam::DMass).unwrap()[0], 998.207_150_467_928_4);
+        assert!(sut.output(FluidParam::DMass).unwrap()[1].is_nan());
+        assert!(sut.output(FluidParam::HMass).unwrap()[1].is_nan());
+    }
+
+    #[test]
+    fn output_not_calculated_or_not_requested() {
+        // Given
+        let water = Fluid::from(Pure::Water);
+        let mut sut = FluidBatch::new(&water, FluidInputPair::PT, &[FluidParam::DMass]);
+        sut.push(101_325.0, 293.15);
+
+        // When
+        let not_calculated = sut.output(FluidParam::DMass).is_none();
+        sut.calculate().unwrap();
+        let not_requested = sut.output(FluidParam::HMass).is_none();
+
+        // Then
+        assert!(not_calculated);
+        assert!(not_requested);
+    }
+
+    #[test]
+    fn extend_from_slices_invalid_length() {
+        // Given
+        let water = Fluid::from(Pure::Water);
+        let mut sut = FluidBatch::new(&water, FluidInputPair::PT, &[FluidParam::DMass]);
+
+        // When
+        let res = sut.extend_from_slices(&[101_325.0], &[]);
+
+        // Then
+        assert!(res.is_err());
+        assert!(sut.is_empty());
+    }
+}
@@ -1,24 +1,106 @@
-use std::{collections::HashMap, hash::Hash};
-
 use super::{FluidOutputError, OutputResult};
 use crate::{
+    cache::{CacheKey, OutputCache, SparseOutputCache},
     io::{FluidParam, FluidTrivialParam},
     native::{AbstractState, CoolPropError},
 };
 
-pub(crate) fn cached_output<K>(
-    cache: &mut HashMap<K, OutputResult<f64>>,
+/// Cache of non-trivial outputs, indexed by [`FluidParam`] discriminants.
+pub(crate) type Outputs =
+    OutputCache<FluidParam, FluidOutputError, { FluidParam::Phase as usize + 1 }>;
+
+/// Cache of trivial outputs, indexed by [`FluidTrivialParam`] discriminants.
+pub(crate) type TrivialOutputs =
+    OutputCache<FluidTrivialParam, FluidOutputError, { FluidTrivialParam::ODP as usize + 1 }>;
+
+/// Key of the derivative outputs cache.
+#[derive(Clone, Copy, Debug, PartialEq)]
+pub(crate) enum Derivative {
+    FirstPartial(FluidParam, FluidParam, FluidParam),
+    SecondPartial(FluidParam, FluidParam, FluidParam, FluidParam, FluidParam),
+    FirstSaturation(FluidParam, FluidParam),
+    FirstTwoPhase(FluidParam, FluidParam, FluidParam),
+    FirstTwoPhaseSplined(FluidParam, FluidParam, FluidParam, f64),
+}
+
+impl Derivative {
+    /// Key of the parameter to differentiate.
+    #[must_use]
+    pub fn of(self) -> FluidParam {
+        match self {
+            Derivative::FirstPartial(of, ..)
+            | Derivative::SecondPartial(of, ..)
+            | Derivative::FirstSaturation(of, ..)
+            | Derivative::FirstTwoPhase(of, ..)
+            | Derivative::FirstTwoPhaseSplined(of, ..) => of,
+        }
+    }
+
+    pub fn eval(self, backend: &AbstractState) -> Result<f64, CoolPropError> {
+        match self {
+            Derivative::FirstPartial(of, wrt, constant) => {
+                backend.first_partial_deriv(of, wrt, constant)
+            }
+            Derivative::SecondPartial(of, wrt1, constant1, wrt2, constant2) => {
+                backend.second_partial_deriv(of, wrt1, constant1, wrt2, constant2)
+            }
+            Derivative::FirstSaturation(of, wrt) => backend.first_saturation_deriv(of, wrt),
+            Derivative::FirstTwoPhase(of, wrt, constant) => {
+                backend.first_two_phase_deriv(of, wrt, constant)
+            }
+            Derivative::FirstTwoPhaseSplined(of, wrt, constant, x_end) => {
+                backend.first_two_phase_deriv_splined(of, wrt, constant, x_end)
+            }
+        }
+    }
+}
+
+/// Cache of outputs that are derived from the current state without updating it
+/// _(saturated liquid/vapor outputs and derivatives)_.
+#[derive(Clone, Debug, Default, PartialEq)]
+pub(crate) struct DerivedOutputs {
+    pub saturated_liquid: Outputs,
+    pub saturated_vapor: Outputs,
+    pub derivatives: SparseOutputCache<Derivative, FluidOutputError>,
+}
+
+impl DerivedOutputs {
+    pub fn clear(&mut self) {
+        self.saturated_liquid.clear();
+        self.saturated_vapor.clear();
+        self.derivatives.clear();
+    }
+}
+
+/// Envelopes already built and kept by the native handle.
+#[derive(Clone, Copy, Debug, Default, PartialEq)]
+pub(crate) struct BuiltEnvelopes {
+    pub phase: bool,
+    pub spinodal: bool,
+}
+
+impl CacheKey for FluidParam {
+    fn index(self) -> usize {
+        self as usize
+    }
+}
+
+impl CacheKey for FluidTrivialParam {
+    fn index(self) -> usize {
+        self as usize
+    }
+}
+
+pub(crate) fn cached_output<K, const N: usize>(
+    cache: &mut OutputCache<K, FluidOutputError, N>,
     backend: &mut AbstractState,
     key: K,
     f: impl FnOnce(CoolPropError) -> FluidOutputError,
 ) -> OutputResult<f64>
 where
-    K: Into<u8> + Eq + Hash + Copy,
+    K: Into<u8> + CacheKey,
 {
-    match cache.entry(key).or_insert_with(|| backend.keyed_output(key).map_err(f)).as_ref() {
-        Ok(&x) => Ok(x),
-        Err(e) => Err(e.clone()),
-    }
+    cache.get_or_insert_with(key, || backend.keyed_output(key).map_err(f))
 }
 
 #[derive(Clone, Copy)]
@@ -55,6 +137,21 @@ mod tests {
 
     use super::*;
 
+    #[test]
+    fn cache_key_index_within_capacity() {
+        // Given
+        let params = (0..=u8::MAX).filter_map(FluidParam::from_repr);
+        let trivial_params = (0..=u8::MAX).filter_map(FluidTrivialParam::from_repr);
+
+        // When
+        let res = params.map(CacheKey::index).max().unwrap();
+        let trivial_res = trivial_params.map(CacheKey::index).max().unwrap();
+
+        // Then
+        assert_eq!(res, FluidParam::Phase as usize);
+        assert_eq!(trivial_res, FluidTrivialParam::ODP as usize);
+    }
+
     #[rstest]
     #[case(
         FluidTrivialParam::TCritical,
@@ -1,12 +1,20 @@
 // cSpell:disable
 
+use std::ops::RangeInclusive;
+
 use super::{
-    Fluid, FluidOutputError, FluidPhaseError, OutputResult, StateResult,
-    common::{cached_output, guard},
+    Fluid, FluidOutputError, FluidPhaseError, FluidSolution, FluidSolveError, OutputResult,
+    StateResult,
+    common::{Derivative, DerivedOutputs, Outputs, cached_output, guard},
+    request::FluidUpdateRequest,
+    solve::{self, Problem},
 };
 use crate::{
-    io::{FluidInput, FluidParam, Phase},
+    io::{FluidInput, FluidInputPair, FluidParam, Phase},
+    metrics,
+    native::{AbstractState, CoolPropError},
     ops::div,
+    state_variant::Undefined,
 };
 
 impl Fluid {
@@ -408,6 +416,47 @@ impl Fluid {
         self.positive_output(FluidParam::CvMolar)
     }
 
+    /// First partial derivative of the output parameter with respect to another parameter
+    /// at a constant third parameter **\[SI units\]**, i.e., `(∂of/∂wrt)_constant`.
+    ///
+    /// It's evaluated analytically in the current state, so no additional state updates
+    /// are required _(unlike finite differences)_.
+    ///
+    /// # Arguments
+    ///
+    /// - `of` -- parameter to differentiate
+    /// - `wrt` -- parameter to differentiate with respect to
+    /// - `constant` -- parameter held constant
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`FluidOutputError`] if the derivative is not available or calculation fails.
+    ///
+    /// # Examples
+    ///
+    /// ```
+    /// use approx::assert_relative_eq;
+    /// use rfluids::prelude::*;
+    ///
+    /// let mut water = Fluid::from(Pure::Water)
+    ///     .in_state(FluidInput::pressure(101_325.0), FluidInput::temperature(293.15))?;
+    /// let res = water.partial_derivative(FluidParam::HMass, FluidParam::T, FluidParam::P)?;
+    /// assert_relative_eq!(res, water.specific_heat()?, max_relative = 1e-6);
+    /// # Ok::<(), rfluids::Error>(())
+    /// ```
+    ///
+    /// # See Also
+    ///
+    /// - [Partial Derivatives](https://coolprop.org/coolprop/LowLevelAPI.html#partial-derivatives)
+    pub fn partial_derivative(
+        &mut self,
+        of: FluidParam,
+        wrt: FluidParam,
+        constant: FluidParam,
+    ) -> OutputResult<f64> {
+        self.derivative(Derivative::FirstPartial(of, wrt, constant))
+    }
+
     /// Phase state.
     pub fn phase(&mut self) -> Phase {
         Phase::try_from(
@@ -481,6 +530,138 @@ impl Fluid {
         self.output(FluidParam::GMolarResidual)
     }
 
+    /// Output parameter value of the saturated liquid **\[SI units\]**
+    /// for the current two-phase state, without any additional state updates.
+    ///
+    /// # Arguments
+    ///
+    /// - `key` -- output parameter
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`FluidOutputError`] if the current state is not two-phase,
+    /// the property is not available or calculation fails.
+    ///
+    /// # Examples
+    ///
+    /// ```
+    /// use rfluids::prelude::*;
+    ///
+    /// let mut water = Fluid::from(Pure::Water)
+    ///     .in_state(FluidInput::pressure(101_325.0), FluidInput::quality(0.5))?;
+    /// let res = water.saturated_liquid(FluidParam::DMass)?;
+    /// assert!(res > water.density()?);
+    /// # Ok::<(), rfluids::Error>(())
+    /// ```
+    ///
+    /// # See Also
+    ///
+    /// - [`Fluid::saturated_vapor`](crate::fluid::Fluid::saturated_vapor)
+    pub fn saturated_liquid(&mut self, key: FluidParam) -> OutputResult<f64> {
+        self.saturated_output(
+            key,
+            |outputs| &mut outputs.saturated_liquid,
+            |backend, key| backend.saturated_liquid_keyed_output(key),
+        )
+    }
+
+    /// Output parameter value of the saturated vapor **\[SI units\]**
+    /// for the current two-phase state, without any additional state updates.
+    ///
+    /// # Arguments
+    ///
+    /// - `key` -- output parameter
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`FluidOutputError`] if the current state is not two-phase,
+    /// the property is not available or calculation fails.
+    ///
+    /// # Examples
+    ///
+    /// ```
+    /// use rfluids::prelude::*;
+    ///
+    /// let mut water = Fluid::from(Pure::Water)
+    ///     .in_state(FluidInput::pressure(101_325.0), FluidInput::quality(0.5))?;
+    /// let res = water.saturated_vapor(FluidParam::DMass)?;
+    /// assert!(res < water.density()?);
+    /// # Ok::<(), rfluids::Error>(())
+    /// ```
+    ///
+    /// # See Also
+    ///
+    /// - [`Fluid::saturated_liquid`](crate::fluid::Fluid::saturated_liquid)
+    pub fn saturated_vapor(&mut self, key: FluidParam) -> OutputResult<f64> {
+        self.saturated_output(
+            key,
+            |outputs| &mut outputs.saturated_vapor,
+            |backend, key| backend.saturated_vapor_keyed_output(key),
+        )
+    }
+
+    /// First derivative of the output parameter along the saturation curve
+    /// **\[SI units\]**, i.e., `(d of/d wrt)_σ`.
+    ///
+    /// # Arguments
+    ///
+    /// - `of` -- parameter to differentiate
+    /// - `wrt` -- parameter to differentiate with respect to
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`FluidOutputError`] if the current state is not saturated,
+    /// the derivative is not available or calculation fails.
+    ///
+    /// # Examples
+    ///
+    /// ```
+    /// use rfluids::prelude::*;
+    ///
+    /// let mut water = Fluid::from(Pure::Water)
+    ///     .in_state(FluidInput::pressure(101_325.0), FluidInput::quality(1.0))?;
+    /// let res = water.saturation_derivative(FluidParam::T, FluidParam::P)?;
+    /// assert!(res > 0.0);
+    /// # Ok::<(), rfluids::Error>(())
+    /// ```
+    ///
+    /// # See Also
+    ///
+    /// - [Partial Derivatives](https://coolprop.org/coolprop/LowLevelAPI.html#partial-derivatives)
+    pub fn saturation_derivative(&mut self, of: FluidParam, wrt: FluidParam) -> OutputResult<f64> {
+        self.derivative(Derivative::FirstSaturation(of, wrt))
+    }
+
+    /// Second partial derivative of the output parameter **\[SI units\]**,
+    /// i.e., `(∂/∂wrt2 (∂of/∂wrt1)_constant1)_constant2`.
+    ///
+    /// # Arguments
+    ///
+    /// - `of` -- parameter to differentiate
+    /// - `wrt1` -- parameter of the first differentiation
+    /// - `constant1` -- parameter held constant during the first differentiation
+    /// - `wrt2` -- parameter of the second differentiation
+    /// - `constant2` -- parameter held constant during the second differentiation
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`FluidOutputError`] if the derivative is not available or calculation fails.
+    ///
+    /// # See Also
+    ///
+    /// - [Partial Derivatives](https://coolprop.org/coolprop/LowLevelAPI.html#partial-derivatives)
+    /// - [`Fluid::partial_derivative`](crate::fluid::Fluid::partial_derivative)
+    pub fn second_partial_derivative(
+        &mut self,
+        of: FluidParam,
+        wrt1: FluidParam,
+        constant1: FluidParam,
+        wrt2: FluidParam,
+        constant2: FluidParam,
+    ) -> OutputResult<f64> {
+        self.derivative(Derivative::SecondPartial(of, wrt1, constant1, wrt2, constant2))
+    }
+
     /// Sound speed **\[m/s\]**.
     ///
     /// # Errors
@@ -548,6 +729,63 @@ impl Fluid {
         self.positive_output(FluidParam::T)
     }
 
+    /// First partial derivative of the output parameter in the two-phase region
+    /// **\[SI units\]**, i.e., `(∂of/∂wrt)_constant`.
+    ///
+    /// # Arguments
+    ///
+    /// - `of` -- parameter to differentiate
+    /// - `wrt` -- parameter to differentiate with respect to
+    /// - `constant` -- parameter held constant
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`FluidOutputError`] if the current state is not two-phase,
+    /// the derivative is not available or calculation fails.
+    ///
+    /// # See Also
+    ///
+    /// - [Two-Phase Derivatives](https://coolprop.org/coolprop/LowLevelAPI.html#two-phase-and-saturation-derivatives)
+    /// - [`Fluid::two_phase_derivative_splined`](crate::fluid::Fluid::two_phase_derivative_splined)
+    pub fn two_phase_derivative(
+        &mut self,
+        of: FluidParam,
+        wrt: FluidParam,
+        constant: FluidParam,
+    ) -> OutputResult<f64> {
+        self.derivative(Derivative::FirstTwoPhase(of, wrt, constant))
+    }
+
+    /// First partial derivative of the output parameter in the two-phase region
+    /// **\[SI units\]** smoothed by a spline near the saturated liquid state,
+    /// i.e., `(∂of/∂wrt)_constant`.
+    ///
+    /// # Arguments
+    ///
+    /// - `of` -- parameter to differentiate
+    /// - `wrt` -- parameter to differentiate with respect to
+    /// - `constant` -- parameter held constant
+    /// - `x_end` -- vapor quality at the end of the spline **\[dimensionless, from 0 to 1\]**
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`FluidOutputError`] if the current state is not two-phase,
+    /// the derivative is not available or calculation fails.
+    ///
+    /// # See Also
+    ///
+    /// - [Two-Phase Derivatives](https://coolprop.org/coolprop/LowLevelAPI.html#two-phase-and-saturation-derivatives)
+    /// - [`Fluid::two_phase_derivative`](crate::fluid::Fluid::two_phase_derivative)
+    pub fn two_phase_derivative_splined(
+        &mut self,
+        of: FluidParam,
+        wrt: FluidParam,
+        constant: FluidParam,
+        x_end: f64,
+    ) -> OutputResult<f64> {
+        self.derivative(Derivative::FirstTwoPhaseSplined(of, wrt, constant, x_end))
+    }
+
     /// Specifies a phase hint for future state updates.
     ///
     /// The current state and cached outputs are not recalculated or invalidated.
@@ -649,6 +887,191 @@ impl Fluid {
         Ok(self)
     }
 
+    /// Updates the thermodynamic state in place, starting the calculation from the state
+    /// of the `previous` instance, and returns a mutable reference to itself.
+    ///
+    /// It's useful for sequential calculations of close states (e.g., neighbouring cells
+    /// of the heat exchanger discretization), since for a close `previous` state
+    /// the flash calculation converges in a few cheap iterations.
+    /// If it doesn't converge or the inputs are not supported _(e.g., vapor quality)_,
+    /// a regular [`Fluid::update`](crate::fluid::Fluid::update) is performed,
+    /// so the result is the same in any case.
+    ///
+    /// # Arguments
+    ///
+    /// - `previous` -- instance in the state close to the new one
+    ///   _(it can be `self` cloned before)_
+    /// - `input1` -- first input property
+    /// - `input2` -- second input property
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`FluidStateError`](crate::fluid::FluidStateError)
+    /// for invalid/unsupported inputs or invalid state.
+    ///
+    /// # Examples
+    ///
+    /// ```
+    /// use approx::assert_relative_eq;
+    /// use rfluids::prelude::*;
+    ///
+    /// let mut inlet = Fluid::from(Pure::Water)
+    ///     .in_state(FluidInput::pressure(101_325.0), FluidInput::temperature(293.15))?;
+    /// let (pressure, enthalpy) =
+    ///     (FluidInput::pressure(101_000.0), FluidInput::enthalpy(inlet.enthalpy()? + 100.0));
+    /// let mut outlet = inlet.clone();
+    /// outlet.update_near(&inlet, pressure, enthalpy)?;
+    /// let mut expected = inlet.in_state(pressure, enthalpy)?;
+    /// assert_relative_eq!(outlet.temperature()?, expected.temperature()?, max_relative = 1e-6);
+    /// # Ok::<(), rfluids::Error>(())
+    /// ```
+    ///
+    /// # See Also
+    ///
+    /// - [`Fluid::update`](crate::fluid::Fluid::update)
+    pub fn update_near(
+        &mut self,
+        previous: &Fluid,
+        input1: FluidInput,
+        input2: FluidInput,
+    ) -> StateResult<&mut Self> {
+        self.inner_update_near(previous.state_guess(), input1, input2)?;
+        Ok(self)
+    }
+
+    /// Finds the value of the `free` parameter at which the `target` is met
+    /// with the `fixed` input, and updates the thermodynamic state in place to the solution.
+    ///
+    /// It's useful for inverse problems which are not supported by `CoolProp` directly
+    /// _(e.g., temperature at which the Prandtl number has the specified value at the specified
+    /// pressure)_. The solver uses Newton iterations with the analytical derivative of the target
+    /// _(or the secant slope for transport properties)_, safeguarded by bisection of the bracket.
+    /// Each state update on the way is warm-started from the previous one
+    /// _(see [`Fluid::update_near`](crate::fluid::Fluid::update_near))_,
+    /// and the same native handle is used for the whole process.
+    ///
+    /// # Arguments
+    ///
+    /// - `target` -- target output parameter and its value
+    /// - `fixed` -- fixed input property
+    /// - `free` -- free input parameter _(it should make a valid input pair with `fixed`)_
+    /// - `bracket` -- range of the free parameter values which contains the solution
+    ///   **\[SI units\]**
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`FluidSolveError`](crate::fluid::FluidSolveError) if the bracket doesn't
+    /// contain the solution, the iterations don't converge, or for invalid/unsupported inputs.
+    /// In this case, the previous state is kept.
+    ///
+    /// # Examples
+    ///
+    /// ```
+    /// use approx::assert_relative_eq;
+    /// use rfluids::prelude::*;
+    ///
+    /// let pressure = FluidInput::pressure(101_325.0);
+    /// let mut water =
+    ///     Fluid::from(Pure::Water).in_state(pressure, FluidInput::temperature(293.15))?;
+    /// let prandtl = FluidInput { key: FluidParam::Prandtl, value: 5.0 };
+    /// let solution = water.solve_for(prandtl, pressure, FluidParam::T, 280.0..=360.0)?;
+    /// assert_relative_eq!(water.prandtl()?, 5.0, max_relative = 1e-6);
+    /// assert_relative_eq!(water.temperature()?, solution.value);
+    /// # Ok::<(), rfluids::Error>(())
+    /// ```
+    ///
+    /// # See Also
+    ///
+    /// - [`Fluid::update_near`](crate::fluid::Fluid::update_near)
+    pub fn solve_for(
+        &mut self,
+        target: FluidInput,
+        fixed: FluidInput,
+        free: FluidParam,
+        bracket: RangeInclusive<f64>,
+    ) -> Result<FluidSolution, FluidSolveError> {
+        let guess = self.state_guess();
+        let problem = Problem { target, fixed, free };
+        let res =
+            solve::solve(&mut self.backend, problem, (*bracket.start(), *bracket.end()), guess);
+        // The native state is no longer consistent with the previous request
+        self.stale_backend = self.update_request.is_some();
+        let solution = res?;
+        // The native state is already the last evaluated one, i.e., the solution
+        let free = FluidInput { key: free, value: solution.value };
+        self.accept_update((fixed, free).try_into()?, fixed, free);
+        Ok(solution)
+    }
+
+    /// Updates the thermodynamic state in place without validating the inputs
+    /// and returns a mutable reference to itself.
+    ///
+    /// It's intended for solver inner loops with trusted inputs: the input pair is
+    /// passed as is _(no key lookup, reordering or finiteness checks)_ and the state
+    /// is neither looked up in nor inserted into the attached
+    /// [`FluidCache`](crate::fluid::FluidCache). Combined with
+    /// [`Fluid::specify_phase`](crate::fluid::Fluid::specify_phase), it also skips
+    /// the phase determination of `CoolProp`. Further speed-up is possible by
+    /// disabling the property limits checks via
+    /// [`Config::dont_check_prop_limits`](crate::config::Config::dont_check_prop_limits).
+    ///
+    /// # Arguments
+    ///
+    /// - `input_pair` -- input pair
+    /// - `value1` -- value of the first input property of the pair
+    ///   _(e.g., pressure **\[Pa\]** for [`FluidInputPair::PT`])_
+    /// - `value2` -- value of the second input property of the pair
+    ///   _(e.g., temperature **\[K\]** for [`FluidInputPair::PT`])_
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`FluidStateError::UpdateFailed`](crate::fluid::FluidStateError::UpdateFailed)
+    /// if `CoolProp` rejects the inputs or fails to calculate the state.
+    /// In this case, the previous state is kept.
+    ///
+    /// # Examples
+    ///
+    /// ```
+    /// use approx::assert_relative_eq;
+    /// use rfluids::prelude::*;
+    ///
+    /// let mut water = Fluid::from(Pure::Water)
+    ///     .in_state(FluidInput::pressure(101_325.0), FluidInput::temperature(293.15))?;
+    /// water.specify_phase(Phase::Liquid)?;
+    /// water.update_unchecked(FluidInputPair::PT, 202_650.0, 313.15)?;
+    /// let mut expected =
+    ///     water.in_state(FluidInput::pressure(202_650.0), FluidInput::temperature(313.15))?;
+    /// assert_relative_eq!(water.density()?, expected.density()?);
+    /// # Ok::<(), rfluids::Error>(())
+    /// ```
+    ///
+    /// # See Also
+    ///
+    /// - [`Fluid::update`](crate::fluid::Fluid::update)
+    /// - [`Fluid::specify_phase`](crate::fluid::Fluid::specify_phase)
+    pub fn update_unchecked(
+        &mut self,
+        input_pair: FluidInputPair,
+        value1: f64,
+        value2: f64,
+    ) -> StateResult<&mut Self> {
+        if let Err(e) = self.backend.update(input_pair, value1, value2) {
+            // The native state is no longer consistent with the previous request
+            self.stale_backend = self.update_request.is_some();
+            metrics::record_failed_flash(input_pair);
+            return Err(e.into());
+        }
+        self.stale_backend = false;
+        self.outputs.clear();
+        self.derived_outputs.clear();
+        self.update_request = Some(FluidUpdateRequest { input_pair, value1, value2 });
+        if let Some(link) = &mut self.cache {
+            // Outputs of the unchecked state are not shared via the cache
+            link.state = None;
+        }
+        Ok(self)
+    }
+
     /// Returns a new instance in the specified thermodynamic state.
     ///
     /// # Arguments
@@ -694,17 +1117,8 @@ impl Fluid {
     ///
     /// - [`Fluid::update`](crate::fluid::Fluid::update)
     pub fn in_state(&self, input1: FluidInput, input2: FluidInput) -> StateResult<Self> {
-        let mut fluid = Fluid::builder()
-            .substance(self.substance.clone())
-            .with_backend(self.backend_variant)
-            .build()
-            .unwrap();
-        if self.specified_phase != Phase::NotImposed {
-            fluid = fluid.specify_phase(self.specified_phase).unwrap();
-        }
-        let mut fluid = fluid.in_state(input1, input2)?;
-        fluid.trivial_outputs.clone_from(&self.trivial_outputs);
-        Ok(fluid)
+        let fluid: Fluid<Undefined> = self.duplicate();
+        fluid.in_state(input1, input2)
     }
 
     fn positive_output(&mut self, key: FluidParam) -> OutputResult<f64> {
@@ -716,28 +1130,83 @@ impl Fluid {
     }
 
     fn output(&mut self, key: FluidParam) -> OutputResult<f64> {
-        cached_output(&mut self.outputs, &mut self.backend, key, |e| {
+        let cached = self.outputs.contains(key);
+        metrics::record_fluid_output(cached);
+        if self.stale_backend && !cached {
+            self.sync_backend().map_err(|e| FluidOutputError::CalculationFailed(key, e))?;
+        }
+        let res = cached_output(&mut self.outputs, &mut self.backend, key, |e| {
             FluidOutputError::CalculationFailed(key, e)
+        });
+        if let (false, Some(link)) = (cached, &self.cache) {
+            link.insert_output(key, &res);
+        }
+        res.and_then(|value| guard(key.into(), value, f64::is_finite))
+    }
+
+    fn derivative(&mut self, key: Derivative) -> OutputResult<f64> {
+        if self.stale_backend && !self.derived_outputs.derivatives.contains(key) {
+            self.sync_backend().map_err(|e| FluidOutputError::CalculationFailed(key.of(), e))?;
+        }
+        let backend = &self.backend;
+        self.derived_outputs.derivatives.get_or_insert_with(key, || {
+            key.eval(backend).map_err(|e| FluidOutputError::CalculationFailed(key.of(), e))
         })
-        .and_then(|value| guard(key.into(), value, f64::is_finite))
+    }
+
+    fn saturated_output(
+        &mut self,
+        key: FluidParam,
+        cache: fn(&mut DerivedOutputs) -> &mut Outputs,
+        f: fn(&AbstractState, FluidParam) -> Result<f64, CoolPropError>,
+    ) -> OutputResult<f64> {
+        if self.stale_backend && !cache(&mut self.derived_outputs).contains(key) {
+            self.sync_backend().map_err(|e| FluidOutputError::CalculationFailed(key, e))?;
+        }
+        let backend = &self.backend;
+        cache(&mut self.derived_outputs).get_or_insert_with(key, || {
+            f(backend, key).map_err(|e| FluidOutputError::CalculationFailed(key, e))
+        })
+    }
+
+    /// Mass density and temperature of the current state _(if available without
+    /// recalculation)_ to be used as a guess for the close states.
+    fn state_guess(&self) -> Option<(f64, f64)> {
+        let value = |key: FluidParam| match self.outputs.get(key) {
+            Some(Ok(value)) => Some(value),
+            _ if self.stale_backend => None,
+            _ => self.backend.keyed_output(key).ok(),
+        };
+        Some((value(FluidParam::DMass)?, value(FluidParam::T)?))
+    }
+
+    /// Recalculates the native state from the current request.
+    ///
+    /// It may fail even for the valid instance, since the states reached by the warm-started
+    /// flash or the inverse-property solver are not guaranteed to be reproducible by the cold
+    /// one. In this case, the native state is kept stale _(so the next output retries it)_.
+    fn sync_backend(&mut self) -> Result<(), CoolPropError> {
+        if let Some(request) = self.update_request {
+            self.backend.update(request.input_pair, request.value1, request.value2)?;
+        }
+        self.stale_backend = false;
+        Ok(())
     }
 }
 
 impl Clone for Fluid {
+    /// Returns a copy of the instance in the same state.
+    ///
+    /// Native handle is checked out from the per-thread pool
+    /// and all cached outputs are copied, so the native state is not recalculated
+    /// until the first output that is not cached yet is requested.
     fn clone(&self) -> Self {
-        let inputs: (FluidInput, FluidInput) = self.update_request.unwrap().into();
-        let mut fluid = Fluid::builder()
-            .substance(self.substance.clone())
-            .with_backend(self.backend_variant)
-            .build()
-            .unwrap()
-            .in_state(inputs.0, inputs.1)
-            .unwrap();
-        if self.specified_phase != Phase::NotImposed {
-            fluid.specify_phase(self.specified_phase).unwrap();
-        }
+        let mut fluid: Fluid = self.duplicate();
+        fluid.update_request = self.update_request;
         fluid.outputs.clone_from(&self.outputs);
-        fluid.trivial_outputs.clone_from(&self.trivial_outputs);
+        fluid.derived_outputs.clone_from(&self.derived_outputs);
+        fluid.cache.clone_from(&self.cache);
+        fluid.stale_backend = true;
         fluid
     }
 }
@@ -753,13 +1222,15 @@ impl PartialEq for Fluid {
 
 #[cfg(test)]
 mod tests {
+    use std::sync::Arc;
+
     use rstest::*;
 
     use super::*;
     use crate::{
         Undefined,
-        fluid::FluidStateError,
-        native::CoolPropError,
+        fluid::{FluidCache, FluidCompositionError, FluidStateError},
+        native::PhaseEnvelope,
         substance::*,
         test::{SutFactory, assert_relative_eq, test_output},
     };
@@ -1085,105 +1556,624 @@ mod tests {
     }
 
     #[rstest]
-    fn update_valid_inputs(ctx: Context) {
+    fn partial_derivative_water(ctx: Context) {
         // Given
-        let Context { pressure, temperature, water, .. } = ctx;
+        let Context { water, .. } = ctx;
         let mut sut = ctx.sut(water);
 
         // When
-        let res = sut.update(pressure, temperature);
+        let res = sut.partial_derivative(FluidParam::HMass, FluidParam::T, FluidParam::P);
 
         // Then
-        assert!(res.is_ok());
+        assert_relative_eq!(res.unwrap(), 4_184.050_924_523_541);
     }
 
     #[rstest]
-    fn update_same_inputs(ctx: Context) {
+    fn partial_derivative_cached(ctx: Context) {
         // Given
-        let Context { pressure, water, .. } = ctx;
+        let Context { water, .. } = ctx;
+        let key = Derivative::FirstPartial(FluidParam::HMass, FluidParam::T, FluidParam::P);
         let mut sut = ctx.sut(water);
 
         // When
-        let res = sut.update(pressure, pressure);
+        let res1 = sut.partial_derivative(FluidParam::HMass, FluidParam::T, FluidParam::P);
+        let res2 = sut.partial_derivative(FluidParam::HMass, FluidParam::T, FluidParam::P);
 
         // Then
-        assert_eq!(res, Err(FluidStateError::InvalidInputPair(pressure.key, pressure.key)));
+        assert!(sut.derived_outputs.derivatives.contains(key));
+        assert_eq!(res1, res2);
     }
 
     #[rstest]
-    fn update_invalid_inputs(ctx: Context) {
+    fn partial_derivative_invalid_inputs(ctx: Context) {
         // Given
-        let Context { temperature, water, .. } = ctx;
-        let infinite_pressure = FluidInput::pressure(f64::INFINITY);
+        let Context { water, .. } = ctx;
         let mut sut = ctx.sut(water);
 
         // When
-        let res = sut.update(infinite_pressure, temperature);
+        let res = sut.partial_derivative(FluidParam::HMass, FluidParam::T, FluidParam::T);
 
         // Then
-        assert_eq!(res, Err(FluidStateError::InvalidInputValue));
+        assert!(matches!(res, Err(FluidOutputError::CalculationFailed(FluidParam::HMass, _))));
     }
 
     #[rstest]
-    fn update_invalid_state(ctx: Context) {
+    fn second_partial_derivative_water(ctx: Context) {
         // Given
-        let Context { temperature, water, .. } = ctx;
-        let negative_pressure = FluidInput::pressure(-1.0);
+        let Context { water, .. } = ctx;
         let mut sut = ctx.sut(water);
 
         // When
-        let res = sut.update(negative_pressure, temperature);
+        let res = sut.second_partial_derivative(
+            FluidParam::HMass,
+            FluidParam::T,
+            FluidParam::P,
+            FluidParam::T,
+            FluidParam::P,
+        );
 
         // Then
-        assert!(matches!(res, Err(FluidStateError::UpdateFailed(_))));
+        assert!(res.is_ok());
     }
 
     #[rstest]
-    fn in_state_valid_inputs(ctx: Context) {
+    #[case(0.0)]
+    #[case(1.0)]
+    fn saturated_outputs_water(ctx: Context, #[case] quality: f64) {
         // Given
-        let Context { pressure, temperature, water, .. } = ctx;
-        let sut = ctx.sut(water);
+        let Context { pressure, water, .. } = ctx;
+        let mut sut = Fluid::from(water).in_state(pressure, FluidInput::quality(0.5)).unwrap();
+        let mut expected =
+            Fluid::from(water).in_state(pressure, FluidInput::quality(quality)).unwrap();
 
         // When
-        let res = sut.in_state(pressure, temperature);
+        let res = if quality == 0.0 {
+            sut.saturated_liquid(FluidParam::DMass)
+        } else {
+            sut.saturated_vapor(FluidParam::DMass)
+        };
 
         // Then
-        assert!(res.is_ok());
+        assert_relative_eq!(res.unwrap(), expected.density().unwrap());
     }
 
     #[rstest]
-    fn in_state_same_inputs(ctx: Context) {
+    fn saturated_outputs_pg(ctx: Context) {
         // Given
-        let Context { pressure, water, .. } = ctx;
-        let sut = ctx.sut(water);
+        let Context { pg, .. } = ctx;
+        let mut sut = ctx.sut(pg);
 
         // When
-        let res = sut.in_state(pressure, pressure);
+        let liquid_res = sut.saturated_liquid(FluidParam::DMass);
+        let vapor_res = sut.saturated_vapor(FluidParam::DMass);
 
         // Then
-        assert_eq!(res, Err(FluidStateError::InvalidInputPair(pressure.key, pressure.key)));
+        assert!(liquid_res.is_err());
+        assert!(vapor_res.is_err());
     }
 
     #[rstest]
-    fn in_state_invalid_inputs(ctx: Context) {
+    fn saturation_derivative_water(ctx: Context) {
         // Given
-        let Context { temperature, water, .. } = ctx;
-        let infinite_pressure = FluidInput::pressure(f64::INFINITY);
-        let sut = ctx.sut(water);
+        let Context { pressure, water, .. } = ctx;
+        let mut sut = Fluid::from(water).in_state(pressure, FluidInput::quality(1.0)).unwrap();
 
         // When
-        let res = sut.in_state(infinite_pressure, temperature);
+        let res = sut.saturation_derivative(FluidParam::T, FluidParam::P);
 
         // Then
-        assert_eq!(res, Err(FluidStateError::InvalidInputValue));
+        assert!(res.unwrap() > 0.0);
     }
 
     #[rstest]
-    fn in_state_invalid_state(ctx: Context) {
+    fn two_phase_derivatives_water(ctx: Context) {
         // Given
-        let Context { temperature, water, .. } = ctx;
-        let negative_pressure = FluidInput::pressure(-1.0);
-        let sut = ctx.sut(water);
+        let Context { pressure, water, .. } = ctx;
+        let mut sut = Fluid::from(water).in_state(pressure, FluidInput::quality(0.05)).unwrap();
+
+        // When
+        let res = sut.two_phase_derivative(FluidParam::DMass, FluidParam::HMass, FluidParam::P);
+        let splined_res = sut.two_phase_derivative_splined(
+            FluidParam::DMass,
+            FluidParam::HMass,
+            FluidParam::P,
+            0.1,
+        );
+
+        // Then
+        assert!(res.is_ok());
+        assert!(splined_res.is_ok());
+    }
+
+    #[rstest]
+    fn update_clears_derived_outputs(ctx: Context) {
+        // Given
+        let Context { pressure, temperature, water, .. } = ctx;
+        let mut sut = ctx.sut(water);
+        sut.partial_derivative(FluidParam::HMass, FluidParam::T, FluidParam::P).unwrap();
+
+        // When
+        sut.update(pressure, temperature).unwrap();
+
+        // Then
+        assert!(sut.derived_outputs.derivatives.is_empty());
+    }
+
+    #[rstest]
+    fn update_valid_inputs(ctx: Context) {
+        // Given
+        let Context { pressure, temperature, water, .. } = ctx;
+        let mut sut = ctx.sut(water);
+
+        // When
+        let res = sut.update(pressure, temperature);
+
+        // Then
+        assert!(res.is_ok());
+    }
+
+    #[rstest]
+    fn update_same_inputs(ctx: Context) {
+        // Given
+        let Context { pressure, water, .. } = ctx;
+        let mut sut = ctx.sut(water);
+
+        // When
+        let res = sut.update(pressure, pressure);
+
+        // Then
+        assert_eq!(res, Err(FluidStateError::InvalidInputPair(pressure.key, pressure.key)));
+    }
+
+    #[rstest]
+    fn update_invalid_inputs(ctx: Context) {
+        // Given
+        let Context { temperature, water, .. } = ctx;
+        let infinite_pressure = FluidInput::pressure(f64::INFINITY);
+        let mut sut = ctx.sut(water);
+
+        // When
+        let res = sut.update(infinite_pressure, temperature);
+
+        // Then
+        assert_eq!(res, Err(FluidStateError::InvalidInputValue));
+    }
+
+    #[rstest]
+    fn update_invalid_state(ctx: Context) {
+        // Given
+        let Context { temperature, water, .. } = ctx;
+        let negative_pressure = FluidInput::pressure(-1.0);
+        let mut sut = ctx.sut(water);
+
+        // When
+        let res = sut.update(negative_pressure, temperature);
+
+        // Then
+        assert!(matches!(res, Err(FluidStateError::UpdateFailed(_))));
+    }
+
+    #[rstest]
+    fn update_invalid_state_keeps_previous_state(ctx: Context) {
+        // Given
+        let Context { temperature, water, .. } = ctx;
+        let negative_pressure = FluidInput::pressure(-1.0);
+        let mut sut = ctx.sut(water);
+        let _unused = sut.update(negative_pressure, temperature);
+
+        // When
+        let res = sut.density().unwrap();
+
+        // Then
+        assert_relative_eq!(res, 998.207_150_467_928_4);
+    }
+
+    #[rstest]
+    fn update_unchecked_valid_inputs(ctx: Context) {
+        // Given
+        let Context { water, .. } = ctx;
+        let mut sut = ctx.sut(water);
+        let mut expected = ctx
+            .sut(water)
+            .in_state(FluidInput::pressure(202_650.0), FluidInput::temperature(313.15))
+            .unwrap();
+
+        // When
+        sut.update_unchecked(FluidInputPair::PT, 202_650.0, 313.15).unwrap();
+
+        // Then
+        assert_eq!(sut, expected);
+        assert_relative_eq!(sut.density().unwrap(), expected.density().unwrap());
+        assert_relative_eq!(sut.pressure().unwrap(), 202_650.0);
+    }
+
+    #[rstest]
+    fn update_unchecked_specified_phase(ctx: Context) {
+        // Given
+        let Context { water, .. } = ctx;
+        let mut sut = ctx.sut(water);
+        sut.specify_phase(Phase::Liquid).unwrap();
+
+        // When
+        let res = sut.update_unchecked(FluidInputPair::PT, 202_650.0, 313.15);
+
+        // Then
+        assert!(res.is_ok());
+        assert_eq!(sut.phase(), Phase::Liquid);
+    }
+
+    #[rstest]
+    fn update_unchecked_invalid_state_keeps_previous_state(ctx: Context) {
+        // Given
+        let Context { water, .. } = ctx;
+        let mut sut = ctx.sut(water);
+
+        // When
+        let res = sut.update_unchecked(FluidInputPair::PT, f64::NAN, 293.15);
+
+        // Then
+        assert!(matches!(res, Err(FluidStateError::UpdateFailed(_))));
+        assert_relative_eq!(sut.density().unwrap(), 998.207_150_467_928_4);
+    }
+
+    #[rstest]
+    fn update_near_valid_inputs(ctx: Context) {
+        // Given
+        let Context { pressure, water, .. } = ctx;
+        let mut previous = ctx.sut(water);
+        let enthalpy = FluidInput::enthalpy(previous.enthalpy().unwrap() + 100.0);
+        let mut expected = previous.in_state(pressure, enthalpy).unwrap();
+        let mut sut = ctx.sut(water);
+
+        // When
+        sut.update_near(&previous, pressure, enthalpy).unwrap();
+
+        // Then
+        assert_relative_eq!(sut.temperature().unwrap(), expected.temperature().unwrap());
+        assert_relative_eq!(sut.density().unwrap(), expected.density().unwrap());
+        assert_eq!(sut, expected);
+    }
+
+    #[rstest]
+    fn update_near_quality_inputs(ctx: Context) {
+        // Given
+        let Context { pressure, water, .. } = ctx;
+        let previous = ctx.sut(water);
+        let mut sut = ctx.sut(water);
+
+        // When
+        let res = sut.update_near(&previous, pressure, FluidInput::quality(0.5));
+
+        // Then
+        assert!(res.is_ok());
+        assert_eq!(sut.phase(), Phase::TwoPhase);
+    }
+
+    #[rstest]
+    fn solve_for_valid_inputs(ctx: Context) {
+        // Given
+        let Context { pressure, water, .. } = ctx;
+        let mut sut = ctx.sut(water);
+        let density = FluidInput::density(990.0);
+
+        // When
+        let res = sut.solve_for(density, pressure, FluidParam::T, 280.0..=360.0).unwrap();
+
+        // Then
+        let mut expected = sut.in_state(pressure, density).unwrap();
+        assert_relative_eq!(res.value, expected.temperature().unwrap());
+        assert_relative_eq!(sut.temperature().unwrap(), res.value);
+        assert_relative_eq!(sut.density().unwrap(), 990.0);
+        assert!(res.iterations > 0);
+    }
+
+    #[rstest]
+    fn solve_for_invalid_inputs(ctx: Context) {
+        // Given
+        let Context { pressure, temperature, water, .. } = ctx;
+        let mut sut = ctx.sut(water);
+        let density = FluidInput::density(990.0);
+
+        // When
+        let res1 = sut.solve_for(density, pressure, FluidParam::P, 1e5..=2e5);
+        let res2 = sut.solve_for(density, pressure, FluidParam::T, 280.0..=300.0);
+
+        // Then
+        assert_eq!(
+            res1,
+            Err(FluidSolveError::State(FluidStateError::InvalidInputPair(
+                FluidParam::P,
+                FluidParam::P
+            )))
+        );
+        assert_eq!(res2, Err(FluidSolveError::NotBracketed(280.0, 300.0)));
+        assert_relative_eq!(sut.temperature().unwrap(), temperature.value);
+        assert_relative_eq!(sut.density().unwrap(), ctx.sut(water).density().unwrap());
+    }
+
+    #[rstest]
+    fn update_near_stale_previous(ctx: Context) {
+        // Given
+        let Context { pressure, water, .. } = ctx;
+        let previous = ctx.sut(water).clone();
+        let mut sut = ctx.sut(water);
+
+        // When
+        let res = sut.update_near(&previous, pressure, FluidInput::temperature(313.15));
+
+        // Then
+        assert!(res.is_ok());
+        assert_relative_eq!(sut.temperature().unwrap(), 313.15);
+    }
+
+    #[rstest]
+    fn update_near_invalid_state(ctx: Context) {
+        // Given
+        let Context { temperature, water, .. } = ctx;
+        let previous = ctx.sut(water);
+        let mut sut = ctx.sut(water);
+
+        // When
+        let res = sut.update_near(&previous, FluidInput::pressure(-1.0), temperature);
+
+        // Then
+        assert!(matches!(res, Err(FluidStateError::UpdateFailed(_))));
+    }
+
+    #[rstest]
+    fn evaluate_many_valid_inputs(ctx: Context) {
+        // Given
+        let Context { water, .. } = ctx;
+        let temperatures = [293.15, 313.15, 353.15];
+        let pressures = [101_325.0, 202_650.0, 405_300.0];
+        let outputs = [FluidParam::DMass, FluidParam::CpMass];
+        let mut out = [0.0; 6];
+        let mut sut = ctx.sut(water);
+        let density = sut.density().unwrap();
+
+        // When
+        let res = sut.evaluate_many(
+            FluidParam::T,
+            &temperatures,
+            FluidParam::P,
+            &pressures,
+            &outputs,
+            &mut out,
+        );
+
+        // Then
+        assert!(res.is_ok());
+        for (i, (t, p)) in temperatures.into_iter().zip(pressures).enumerate() {
+            let mut expected =
+                sut.in_state(FluidInput::temperature(t), FluidInput::pressure(p)).unwrap();
+            assert_relative_eq!(out[i], expected.density().unwrap());
+            assert_relative_eq!(out[3 + i], expected.specific_heat().unwrap());
+        }
+        assert_relative_eq!(sut.density().unwrap(), density);
+        assert_relative_eq!(sut.backend.keyed_output(FluidParam::DMass).unwrap(), density);
+    }
+
+    #[rstest]
+    fn evaluate_many_same_inputs(ctx: Context) {
+        // Given
+        let Context { water, .. } = ctx;
+        let mut out = [0.0; 1];
+        let mut sut = ctx.sut(water);
+
+        // When
+        let res = sut.evaluate_many(
+            FluidParam::P,
+            &[101_325.0],
+            FluidParam::P,
+            &[101_325.0],
+            &[FluidParam::DMass],
+            &mut out,
+        );
+
+        // Then
+        assert_eq!(res, Err(FluidStateError::InvalidInputPair(FluidParam::P, FluidParam::P)));
+    }
+
+    #[rstest]
+    fn evaluate_many_invalid_inputs(ctx: Context) {
+        // Given
+        let Context { water, .. } = ctx;
+        let mut out = [0.0; 1];
+        let mut sut = ctx.sut(water);
+
+        // When
+        let res = sut.evaluate_many(
+            FluidParam::P,
+            &[f64::INFINITY],
+            FluidParam::T,
+            &[293.15],
+            &[FluidParam::DMass],
+            &mut out,
+        );
+
+        // Then
+        assert_eq!(res, Err(FluidStateError::InvalidInputValue));
+    }
+
+    #[rstest]
+    fn evaluate_many_invalid_out_length(ctx: Context) {
+        // Given
+        let Context { water, .. } = ctx;
+        let mut out = [0.0; 1];
+        let mut sut = ctx.sut(water);
+
+        // When
+        let res = sut.evaluate_many(
+            FluidParam::P,
+            &[101_325.0],
+            FluidParam::T,
+            &[293.15],
+            &[FluidParam::DMass, FluidParam::CpMass],
+            &mut out,
+        );
+
+        // Then
+        assert_eq!(
+            res,
+            Err(FluidStateError::UpdateFailed(CoolPropError::InvalidLength {
+                arg: "out",
+                expected: 2,
+                actual: 1
+            }))
+        );
+    }
+
+    #[rstest]
+    fn set_fraction(ctx: Context) {
+        // Given
+        let Context { pg, .. } = ctx;
+        let other = pg.kind.with_fraction(0.6).unwrap();
+        let mut sut = ctx.sut(pg);
+        let key = Arc::clone(sut.backend.key());
+        sut.density().unwrap();
+
+        // When
+        let res = sut.set_fraction(0.6).map(|fluid| fluid.density());
+
+        // Then
+        assert_relative_eq!(res.unwrap().unwrap(), ctx.sut(other).density().unwrap());
+        assert_eq!(sut.substance, Substance::from(other));
+        assert_ne!(sut.backend.key(), &key);
+    }
+
+    #[rstest]
+    fn set_composition_custom_mix(ctx: Context) {
+        // Given
+        let mix = |water: f64, ethanol: f64| {
+            CustomMix::mole_based([(Pure::Water, water), (Pure::Ethanol, ethanol)]).unwrap()
+        };
+        let mut sut = ctx.sut(Fluid::try_from(mix(0.8, 0.2)).unwrap());
+
+        // When
+        let res = sut.set_composition(mix(0.6, 0.4)).map(|fluid| fluid.density());
+
+        // Then
+        assert_relative_eq!(
+            res.unwrap().unwrap(),
+            ctx.sut(Fluid::try_from(mix(0.6, 0.4)).unwrap()).density().unwrap()
+        );
+    }
+
+    #[rstest]
+    fn set_composition_incompatible_substance(ctx: Context) {
+        // Given
+        let Context { water, pg, .. } = ctx;
+        let mut sut = ctx.sut(pg);
+
+        // When
+        let res = sut.set_composition(water).map(|_| ());
+
+        // Then
+        assert_eq!(res, Err(FluidCompositionError::IncompatibleSubstance));
+        assert_eq!(sut.substance, Substance::from(pg));
+    }
+
+    #[rstest]
+    fn set_fraction_invalid_fraction(ctx: Context) {
+        // Given
+        let Context { water, pg, .. } = ctx;
+        let mut sut = ctx.sut(pg);
+
+        // When
+        let res = sut.set_fraction(1.5).map(|_| ());
+
+        // Then
+        assert!(matches!(res, Err(FluidCompositionError::InvalidFraction(_))));
+        assert_eq!(
+            ctx.sut(water).set_fraction(0.6).map(|_| ()),
+            Err(FluidCompositionError::IncompatibleSubstance)
+        );
+    }
+
+    #[rstest]
+    fn phase_envelope(ctx: Context) {
+        // Given
+        let mix = CustomMix::mole_based([(Pure::Methane, 0.5), (Pure::Ethane, 0.5)]).unwrap();
+        let mut sut = ctx.sut(Fluid::try_from(mix.clone()).unwrap());
+        let density = sut.density().unwrap();
+        let mut out = PhaseEnvelope::new();
+
+        // When
+        let res = sut.phase_envelope(&mut out);
+
+        // Then
+        assert!(res.is_ok());
+        assert!(sut.envelopes.phase);
+        assert!(!out.is_empty());
+        assert_eq!(out.components(), 2);
+        assert_relative_eq!(sut.specific_heat().unwrap(), {
+            let mut expected = ctx.sut(Fluid::try_from(mix).unwrap());
+            expected.specific_heat().unwrap()
+        });
+        assert_eq!(sut.density(), Ok(density));
+    }
+
+    #[rstest]
+    fn phase_envelope_unsupported_substance(ctx: Context) {
+        // Given
+        let Context { incomp_water, .. } = ctx;
+        let mut sut = ctx.sut(incomp_water);
+        let mut out = PhaseEnvelope::new();
+
+        // When
+        let res = sut.phase_envelope(&mut out);
+
+        // Then
+        assert!(res.is_err());
+        assert!(!sut.envelopes.phase);
+    }
+
+    #[rstest]
+    fn in_state_valid_inputs(ctx: Context) {
+        // Given
+        let Context { pressure, temperature, water, .. } = ctx;
+        let sut = ctx.sut(water);
+
+        // When
+        let res = sut.in_state(pressure, temperature);
+
+        // Then
+        assert!(res.is_ok());
+    }
+
+    #[rstest]
+    fn in_state_same_inputs(ctx: Context) {
+        // Given
+        let Context { pressure, water, .. } = ctx;
+        let sut = ctx.sut(water);
+
+        // When
+        let res = sut.in_state(pressure, pressure);
+
+        // Then
+        assert_eq!(res, Err(FluidStateError::InvalidInputPair(pressure.key, pressure.key)));
+    }
+
+    #[rstest]
+    fn in_state_invalid_inputs(ctx: Context) {
+        // Given
+        let Context { temperature, water, .. } = ctx;
+        let infinite_pressure = FluidInput::pressure(f64::INFINITY);
+        let sut = ctx.sut(water);
+
+        // When
+        let res = sut.in_state(infinite_pressure, temperature);
+
+        // Then
+        assert_eq!(res, Err(FluidStateError::InvalidInputValue));
+    }
+
+    #[rstest]
+    fn in_state_invalid_state(ctx: Context) {
+        // Given
+        let Context { temperature, water, .. } = ctx;
+        let negative_pressure = FluidInput::pressure(-1.0);
+        let sut = ctx.sut(water);
 
         // When
         let res = sut.in_state(negative_pressure, temperature);
@@ -1222,4 +2212,113 @@ mod tests {
         assert_eq!(clone.outputs, sut.outputs);
         assert_eq!(clone.trivial_outputs, sut.trivial_outputs);
     }
+
+    #[rstest]
+    fn clone_calculates_not_cached_outputs(ctx: Context) {
+        // Given
+        let Context { water, .. } = ctx;
+        let mut sut = ctx.sut(water);
+        let density = sut.density().unwrap();
+
+        // When
+        let mut clone = sut.clone();
+
+        // Then
+        assert_relative_eq!(clone.density().unwrap(), density);
+        assert_relative_eq!(clone.specific_heat().unwrap(), sut.specific_heat().unwrap());
+        assert_eq!(clone.outputs, sut.outputs);
+    }
+
+    #[rstest]
+    fn in_state_from_clone(ctx: Context) {
+        // Given
+        let Context { pressure, water, .. } = ctx;
+        let sut = ctx.sut(water).clone();
+
+        // When
+        let mut res = sut.in_state(pressure, FluidInput::temperature(423.15)).unwrap();
+
+        // Then
+        assert_eq!(res.phase(), Phase::Gas);
+        assert_eq!(res.trivial_outputs, sut.trivial_outputs);
+    }
+
+    #[rstest]
+    fn clone_calculates_not_cached_derivatives(ctx: Context) {
+        // Given
+        let Context { water, .. } = ctx;
+        let mut sut = ctx.sut(water);
+        sut.partial_derivative(FluidParam::HMass, FluidParam::T, FluidParam::P).unwrap();
+        let mut clone = sut.clone();
+
+        // When
+        let res = clone.partial_derivative(FluidParam::DMass, FluidParam::T, FluidParam::P);
+
+        // Then
+        assert_eq!(res, sut.partial_derivative(FluidParam::DMass, FluidParam::T, FluidParam::P));
+        assert_eq!(clone.derived_outputs, sut.derived_outputs);
+    }
+
+    #[rstest]
+    fn output_stale_backend_sync_failed(ctx: Context) {
+        // Given
+        let mut sut = ctx.sut(ctx.water);
+        sut.update_request = Some(FluidUpdateRequest {
+            input_pair: FluidInputPair::PT,
+            value1: -1.0,
+            value2: 293.15,
+        });
+        sut.stale_backend = true;
+
+        // When
+        let res = sut.density();
+
+        // Then
+        assert!(matches!(res, Err(FluidOutputError::CalculationFailed(FluidParam::DMass, _))));
+        assert!(sut.stale_backend);
+    }
+
+    #[rstest]
+    fn update_cached_state(ctx: Context) {
+        // Given
+        let Context { pressure, temperature, water, .. } = ctx;
+        let cache = Arc::new(FluidCache::new(1 << 20));
+        let mut sut = Fluid::builder()
+            .substance(water)
+            .with_cache(Arc::clone(&cache))
+            .build()
+            .unwrap()
+            .in_state(pressure, temperature)
+            .unwrap();
+        let density = sut.density().unwrap();
+        sut.update(pressure, FluidInput::temperature(313.15)).unwrap();
+
+        // When
+        sut.update(pressure, temperature).unwrap();
+
+        // Then
+        assert!(sut.stale_backend);
+        assert_eq!(sut.density(), Ok(density));
+        assert_relative_eq!(sut.specific_heat().unwrap(), 4_184.050_924_523_541);
+        assert_eq!((cache.hits(), cache.misses()), (1, 2));
+    }
+
+    #[rstest]
+    fn update_cached_state_shared_between_instances(ctx: Context) {
+        // Given
+        let Context { pressure, temperature, water, .. } = ctx;
+        let cache = Arc::new(FluidCache::new(1 << 20));
+        let fluid =
+            || Fluid::builder().substance(water).with_cache(Arc::clone(&cache)).build().unwrap();
+        let mut other = fluid().in_state(pressure, temperature).unwrap();
+        let density = other.density().unwrap();
+
+        // When
+        let mut sut = fluid().in_state(pressure, temperature).unwrap();
+
+        // Then
+        assert_eq!(sut.outputs.get(FluidParam::DMass), Some(Ok(density)));
+        assert_eq!(sut.density(), Ok(density));
+        assert_eq!(cache.hits(), 1);
+    }
 }
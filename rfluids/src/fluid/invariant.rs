@@ -1,11 +1,18 @@
+use std::{marker::PhantomData, sync::Arc};
+
 use super::{
-    Fluid, FluidOutputError, FluidPhaseError, OutputResult, StateResult,
+    Fluid, FluidCompositionError, FluidEnvelopeError, FluidOutputError, FluidPhaseError,
+    FluidStateError, OutputResult, StateResult,
     backend::Backend,
-    common::{cached_output, guard},
+    common::{BuiltEnvelopes, DerivedOutputs, Outputs, guard},
     request::FluidUpdateRequest,
+    state_cache::{CacheLink, StateKey},
+    trivial, warm_start,
 };
 use crate::{
-    io::{FluidInput, FluidTrivialParam, Phase},
+    io::{FluidInput, FluidInputPair, FluidParam, FluidTrivialParam, Phase},
+    metrics,
+    native::{CriticalPoints, PhaseEnvelope, Spinodal},
     ops::mul,
     state_variant::StateVariant,
     substance::Substance,
@@ -261,6 +268,306 @@ impl<S: StateVariant> Fluid<S> {
         self.positive_trivial_output(FluidTrivialParam::TTriple)
     }
 
+    /// Calculates the specified output parameters for each pair of input values
+    /// with a minimal number of FFI calls and without any allocations.
+    ///
+    /// Results are written into `out` in column-major order, i.e., the value of the `j`-th
+    /// output parameter for the `i`-th state is written into `out[j * input1.len() + i]`.
+    /// If the calculation fails for some state, the corresponding output values
+    /// are set to [`f64::NAN`]. The current state and cached outputs of the instance
+    /// _(if any)_ remain unchanged.
+    ///
+    /// # Arguments
+    ///
+    /// - `input1_key` -- first input parameter key
+    /// - `input1` -- values of the first input parameter **\[SI units\]**
+    /// - `input2_key` -- second input parameter key
+    /// - `input2` -- values of the second input parameter **\[SI units\]**
+    ///   _(should have the same length as `input1`)_
+    /// - `outputs` -- output parameter keys
+    /// - `out` -- output buffer **\[SI units\]**
+    ///   _(should have length `input1.len() * outputs.len()`)_
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`FluidStateError`] for invalid/unsupported inputs
+    /// or inputs/output buffer of invalid length.
+    ///
+    /// # Examples
+    ///
+    /// ```
+    /// use approx::assert_relative_eq;
+    /// use rfluids::prelude::*;
+    ///
+    /// let mut water = Fluid::from(Pure::Water);
+    /// let mut out = [0.0; 4];
+    /// water.evaluate_many(
+    ///     FluidParam::T,
+    ///     &[293.15, 313.15],
+    ///     FluidParam::P,
+    ///     &[101_325.0, 101_325.0],
+    ///     &[FluidParam::DMass, FluidParam::CpMass],
+    ///     &mut out,
+    /// )?;
+    /// assert_relative_eq!(out[0], 998.207_150_467_928_4, max_relative = 1e-6);
+    /// assert_relative_eq!(out[2], 4_184.050_924_523_541, max_relative = 1e-6);
+    /// # Ok::<(), rfluids::Error>(())
+    /// ```
+    ///
+    /// # See Also
+    ///
+    /// - [`AbstractState::update_batch`](crate::native::AbstractState::update_batch)
+    pub fn evaluate_many(
+        &mut self,
+        input1_key: FluidParam,
+        input1: &[f64],
+        input2_key: FluidParam,
+        input2: &[f64],
+        outputs: &[FluidParam],
+        out: &mut [f64],
+    ) -> StateResult<()> {
+        let input_pair = FluidInputPair::try_from((input1_key, input2_key))
+            .map_err(|_| FluidStateError::InvalidInputPair(input1_key, input2_key))?;
+        if input1.iter().chain(input2).any(|value| !value.is_finite()) {
+            return Err(FluidStateError::InvalidInputValue);
+        }
+        let (input1, input2) =
+            if <(FluidParam, FluidParam)>::from(input_pair) == (input1_key, input2_key) {
+                (input1, input2)
+            } else {
+                (input2, input1)
+            };
+        let res = self.backend.update_batch(input_pair, input1, input2, outputs, out);
+        if let Some(request) = self.update_request.filter(|_| !self.stale_backend) {
+            self.backend.update(request.input_pair, request.value1, request.value2)?;
+        }
+        Ok(res?)
+    }
+
+    /// Changes the fractions of the mixture components in place, reusing the native handle,
+    /// and returns a mutable reference to itself.
+    ///
+    /// Rebuilding the [`Fluid`] for each composition is expensive
+    /// (mixture parameters loading, etc.), so it's useful for composition sweeps.
+    /// All cached outputs are invalidated, and the current state _(if it's defined)_
+    /// is recalculated with the new composition.
+    ///
+    /// # Arguments
+    ///
+    /// - `substance` -- mixture of the same components as the specified substance,
+    ///   but with different fractions _(the same [`BinaryMixKind`](crate::substance::BinaryMixKind)
+    ///   for [`BinaryMix`](crate::substance::BinaryMix) or the same set of components
+    ///   for [`CustomMix`](crate::substance::CustomMix))_
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`FluidCompositionError`] if the specified substance is not a mixture
+    /// of the same components or the current state cannot be recalculated
+    /// with the new composition _(in this case, the previous composition is kept)_.
+    ///
+    /// # Examples
+    ///
+    /// ```
+    /// use approx::assert_relative_eq;
+    /// use rfluids::prelude::*;
+    ///
+    /// let mut mix = Fluid::try_from(CustomMix::mass_based([
+    ///     (Pure::Water, 0.6),
+    ///     (Pure::Ethanol, 0.4),
+    /// ])?)?
+    /// .in_state(FluidInput::pressure(200e3), FluidInput::temperature(277.15))?;
+    /// mix.set_composition(CustomMix::mass_based([(Pure::Water, 0.8), (Pure::Ethanol, 0.2)])?)?;
+    /// let expected = Fluid::try_from(CustomMix::mass_based([
+    ///     (Pure::Water, 0.8),
+    ///     (Pure::Ethanol, 0.2),
+    /// ])?)?
+    /// .in_state(FluidInput::pressure(200e3), FluidInput::temperature(277.15))?
+    /// .density()?;
+    /// assert_relative_eq!(mix.density()?, expected);
+    /// # Ok::<(), rfluids::Error>(())
+    /// ```
+    ///
+    /// # See Also
+    ///
+    /// - [`Fluid::set_fraction`]
+    pub fn set_composition(
+        &mut self,
+        substance: impl Into<Substance>,
+    ) -> Result<&mut Self, FluidCompositionError> {
+        let substance = substance.into();
+        let fractions = self
+            .backend
+            .fractions_of(&substance)
+            .ok_or(FluidCompositionError::IncompatibleSubstance)?;
+        let previous = self.backend.fractions();
+        self.backend.set_fractions(&fractions)?;
+        if let Some(request) = self.update_request {
+            let res = self.backend.update(request.input_pair, request.value1, request.value2);
+            if let Err(e) = res {
+                // The native state is no longer consistent with the previous request
+                self.stale_backend = true;
+                self.backend.set_fractions(&previous)?;
+                return Err(FluidCompositionError::UpdateFailed(e));
+            }
+        }
+        self.substance = substance;
+        self.stale_backend = false;
+        self.outputs.clear();
+        self.derived_outputs.clear();
+        self.trivial_outputs.clear();
+        self.envelopes = BuiltEnvelopes::default();
+        if let Some(request) = self.update_request {
+            let (key1, key2) = request.input_pair.into();
+            self.outputs.insert(key1, Ok(request.value1));
+            self.outputs.insert(key2, Ok(request.value2));
+            if let Some(link) = &mut self.cache {
+                link.insert(
+                    StateKey::new(self.backend.key(), self.specified_phase, request),
+                    &self.outputs,
+                );
+            }
+        }
+        Ok(self)
+    }
+
+    /// Changes the fraction of the binary mixture in place, reusing the native handle,
+    /// and returns a mutable reference to itself.
+    ///
+    /// # Arguments
+    ///
+    /// - `fraction` -- new fraction of the binary mixture **\[dimensionless, from 0 to 1\]**
+    ///   _(its kind is kept)_
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`FluidCompositionError`] if the specified substance is not a
+    /// [`BinaryMix`](crate::substance::BinaryMix), the fraction is out of possible range
+    /// or the current state cannot be recalculated with the new fraction.
+    ///
+    /// # Examples
+    ///
+    /// ```
+    /// use approx::assert_relative_eq;
+    /// use rfluids::prelude::*;
+    ///
+    /// let mut propylene_glycol = Fluid::from(BinaryMixKind::MPG.with_fraction(0.4)?)
+    ///     .in_state(FluidInput::pressure(100e3), FluidInput::temperature(253.15))?;
+    /// propylene_glycol.set_fraction(0.6)?;
+    /// let expected = Fluid::from(BinaryMixKind::MPG.with_fraction(0.6)?)
+    ///     .in_state(FluidInput::pressure(100e3), FluidInput::temperature(253.15))?
+    ///     .dynamic_viscosity()?;
+    /// assert_relative_eq!(propylene_glycol.dynamic_viscosity()?, expected);
+    /// # Ok::<(), rfluids::Error>(())
+    /// ```
+    ///
+    /// # See Also
+    ///
+    /// - [`Fluid::set_composition`]
+    pub fn set_fraction(&mut self, fraction: f64) -> Result<&mut Self, FluidCompositionError> {
+        let Substance::BinaryMix(mix) = self.substance else {
+            return Err(FluidCompositionError::IncompatibleSubstance);
+        };
+        self.set_composition(mix.kind.with_fraction(fraction)?)
+    }
+
+    /// Writes the phase envelope of the mixture into the reusable `out` buffer.
+    ///
+    /// The envelope is traced natively only once per instance and composition,
+    /// so further calls just copy it into the buffer. It's much faster and more robust
+    /// than tracing the envelope by the saturation state updates.
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`FluidEnvelopeError`] if the backend doesn't support phase envelopes
+    /// _(e.g., for incompressible substances)_ or the envelope can't be traced.
+    ///
+    /// # Examples
+    ///
+    /// ```
+    /// use rfluids::{native::PhaseEnvelope, prelude::*};
+    ///
+    /// let mut mix =
+    ///     Fluid::try_from(CustomMix::mole_based([(Pure::Methane, 0.5), (Pure::Ethane, 0.5)])?)?;
+    /// let mut envelope = PhaseEnvelope::new();
+    /// mix.phase_envelope(&mut envelope)?;
+    /// assert!(!envelope.is_empty());
+    /// assert_eq!(envelope.components(), 2);
+    /// # Ok::<(), rfluids::Error>(())
+    /// ```
+    ///
+    /// # See Also
+    ///
+    /// - [`AbstractState::phase_envelope`](crate::native::AbstractState::phase_envelope)
+    pub fn phase_envelope(&mut self, out: &mut PhaseEnvelope) -> Result<(), FluidEnvelopeError> {
+        if !self.envelopes.phase {
+            self.invalidate_backend();
+            self.backend.build_phase_envelope()?;
+            self.envelopes.phase = true;
+        }
+        Ok(self.backend.phase_envelope(out)?)
+    }
+
+    /// Writes the spinodal curve of the substance into the reusable `out` buffer.
+    ///
+    /// The spinodal is traced natively only once per instance and composition,
+    /// so further calls just copy it into the buffer.
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`FluidEnvelopeError`] if the backend doesn't support spinodals
+    /// or the spinodal can't be traced.
+    ///
+    /// # See Also
+    ///
+    /// - [`AbstractState::spinodal`](crate::native::AbstractState::spinodal)
+    pub fn spinodal(&mut self, out: &mut Spinodal) -> Result<(), FluidEnvelopeError> {
+        if !self.envelopes.spinodal {
+            self.invalidate_backend();
+            self.backend.build_spinodal()?;
+            self.envelopes.spinodal = true;
+        }
+        Ok(self.backend.spinodal(out)?)
+    }
+
+    /// Writes all critical points of the mixture into the reusable `out` buffer.
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`FluidEnvelopeError`] if the backend doesn't support
+    /// critical points search.
+    ///
+    /// # See Also
+    ///
+    /// - [`AbstractState::critical_points`](crate::native::AbstractState::critical_points)
+    pub fn critical_points(&mut self, out: &mut CriticalPoints) -> Result<(), FluidEnvelopeError> {
+        self.invalidate_backend();
+        Ok(self.backend.critical_points(out)?)
+    }
+
+    /// Returns a new instance with the same substance, backend and specified phase,
+    /// but without any state. The native handle is checked out from the per-thread pool,
+    /// and trivial outputs are copied, so nothing is recalculated.
+    pub(crate) fn duplicate<T: StateVariant>(&self) -> Fluid<T> {
+        let mut fluid = Fluid {
+            backend: self.backend.duplicate().unwrap(),
+            backend_variant: self.backend_variant,
+            substance: self.substance.clone(),
+            specified_phase: Phase::NotImposed,
+            update_request: None,
+            outputs: Outputs::new(),
+            derived_outputs: DerivedOutputs::default(),
+            trivial_outputs: self.trivial_outputs.clone(),
+            stale_backend: false,
+            envelopes: BuiltEnvelopes::default(),
+            cache: self.cache.as_ref().map(|link| CacheLink::new(Arc::clone(&link.cache))),
+            state: PhantomData,
+        };
+        if self.specified_phase != Phase::NotImposed {
+            fluid.inner_specify_phase(self.specified_phase).unwrap();
+        }
+        fluid
+    }
+
     pub(crate) fn inner_specify_phase(&mut self, phase: Phase) -> Result<(), FluidPhaseError> {
         if phase == Phase::NotImposed {
             self.inner_unspecify_phase();
@@ -280,14 +587,73 @@ impl<S: StateVariant> Fluid<S> {
         &mut self,
         input1: FluidInput,
         input2: FluidInput,
+    ) -> StateResult<()> {
+        self.inner_update_near(None, input1, input2)
+    }
+
+    /// Updates the state, trying a flash warm-started from the `guess`
+    /// _(mass density **\[kg/m³\]** and temperature **\[K\]**)_ first, if it's specified.
+    pub(crate) fn inner_update_near(
+        &mut self,
+        guess: Option<(f64, f64)>,
+        input1: FluidInput,
+        input2: FluidInput,
     ) -> StateResult<()> {
         let request: FluidUpdateRequest = (input1, input2).try_into()?;
-        self.backend.update(request.input_pair, request.value1, request.value2)?;
+        if let Some(link) = &mut self.cache {
+            let key = StateKey::new(self.backend.key(), self.specified_phase, request);
+            if link.lookup(key, &mut self.outputs) {
+                // The native state is recalculated only if a not cached output is requested
+                self.stale_backend = true;
+                self.derived_outputs.clear();
+                self.update_request = Some(request);
+                return Ok(());
+            }
+        }
+        let warm_started = guess.is_some_and(|guess| {
+            warm_start::update_near(&mut self.backend, request, guess).is_some()
+        });
+        let res = if warm_started {
+            Ok(())
+        } else {
+            self.backend.update(request.input_pair, request.value1, request.value2)
+        };
+        if let Err(e) = res {
+            // The native state is no longer consistent with the previous request
+            self.stale_backend = self.update_request.is_some();
+            metrics::record_failed_flash(request.input_pair);
+            return Err(e.into());
+        }
+        self.accept_update(request, input1, input2);
+        Ok(())
+    }
+
+    /// Stores the `request` as the current one, once the native state is already updated to it
+    /// _(e.g., by the flash or the inverse-property solver)_.
+    pub(crate) fn accept_update(
+        &mut self,
+        request: FluidUpdateRequest,
+        input1: FluidInput,
+        input2: FluidInput,
+    ) {
+        self.stale_backend = false;
         self.outputs.clear();
+        self.derived_outputs.clear();
         self.outputs.insert(input1.key, Ok(input1.value));
         self.outputs.insert(input2.key, Ok(input2.value));
         self.update_request = Some(request);
-        Ok(())
+        if let Some(link) = &mut self.cache {
+            link.insert(
+                StateKey::new(self.backend.key(), self.specified_phase, request),
+                &self.outputs,
+            );
+        }
+    }
+
+    /// Marks the native state as no longer consistent with the current request
+    /// _(e.g., before tracing envelopes, which updates the native state)_.
+    fn invalidate_backend(&mut self) {
+        self.stale_backend = self.update_request.is_some();
     }
 
     fn positive_trivial_output(&mut self, key: FluidTrivialParam) -> OutputResult<f64> {
@@ -299,9 +665,7 @@ impl<S: StateVariant> Fluid<S> {
     }
 
     fn trivial_output(&mut self, key: FluidTrivialParam) -> OutputResult<f64> {
-        cached_output(&mut self.trivial_outputs, &mut self.backend, key, |_| {
-            FluidOutputError::UnavailableTrivialOutput(key)
-        })
-        .and_then(|value| guard(key.into(), value, f64::is_finite))
+        trivial::trivial_output(&mut self.trivial_outputs, &mut self.backend, key)
+            .and_then(|value| guard(key.into(), value, f64::is_finite))
     }
 }
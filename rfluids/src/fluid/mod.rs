@@ -17,24 +17,47 @@
 //! or [`CustomMix`] using the [`TryFrom`]/[`TryInto`] traits. This is due to the fact
 //! that [`CustomMix`] can potentially be unsupported by `CoolProp`.
 //! For advanced control over backend selection, use [`Fluid::builder`].
-
+//!
+//! For many states of the same substance _(e.g., millions of nodes of the simulation)_,
+//! use [`FluidBatch`], which stores them as contiguous columns
+//! and calculates them in parallel.
+//! To calculate properties from async code without blocking the executor,
+//! use `AsyncFluidPool` _(requires the **`async`** feature)_.
+
+#[cfg(feature = "async")]
+mod async_pool;
 pub mod backend;
+mod batch;
 mod common;
 mod defined;
 mod invariant;
+mod pool;
 mod request;
+mod solve;
+mod state_cache;
+mod trivial;
 mod undefined;
+mod warm_start;
 
-use std::{collections::HashMap, fmt::Debug, marker::PhantomData};
+use std::{fmt::Debug, marker::PhantomData};
 
+#[cfg(feature = "async")]
+pub use async_pool::{AsyncFluidPool, AsyncFluidPoolStats, Evaluation};
 use backend::Backend;
+pub use batch::FluidBatch;
+use common::{BuiltEnvelopes, DerivedOutputs, Outputs, TrivialOutputs};
+pub(crate) use pool::PooledState;
 use request::FluidUpdateRequest;
+pub use solve::FluidSolution;
+use state_cache::CacheLink;
+pub use state_cache::FluidCache;
+pub(crate) use trivial::{pure_trivial_output, trivial_outputs};
 
 use crate::{
     io::{FluidParam, FluidTrivialParam, Phase},
-    native::{AbstractState, CoolPropError},
+    native::CoolPropError,
     state_variant::{Defined, StateVariant, Undefined},
-    substance::{BinaryMix, CustomMix, IncompPure, PredefinedMix, Pure, Substance},
+    substance::{BinaryMix, BinaryMixError, CustomMix, IncompPure, PredefinedMix, Pure, Substance},
 };
 
 /// Result type for operations that could fail while updating fluid state.
@@ -57,13 +80,17 @@ pub type OutputResult<T> = Result<T, FluidOutputError>;
 /// - [Fluid Properties](https://coolprop.org/fluid_properties/index.html)
 #[derive(Debug)]
 pub struct Fluid<S: StateVariant = Defined> {
-    backend: AbstractState,
+    backend: PooledState,
     backend_variant: Backend,
     substance: Substance,
     specified_phase: Phase,
     update_request: Option<FluidUpdateRequest>,
-    outputs: HashMap<FluidParam, OutputResult<f64>>,
-    trivial_outputs: HashMap<FluidTrivialParam, OutputResult<f64>>,
+    outputs: Outputs,
+    derived_outputs: DerivedOutputs,
+    trivial_outputs: TrivialOutputs,
+    stale_backend: bool,
+    envelopes: BuiltEnvelopes,
+    cache: Option<CacheLink>,
     state: PhantomData<S>,
 }
 
@@ -232,6 +259,17 @@ impl TryFrom<CustomMix> for Fluid<Undefined> {
 #[error("unable to build fluid: {0}")]
 pub struct FluidBuildError(#[from] CoolPropError);
 
+/// Error during calculation of the [`FluidBatch`].
+#[derive(Clone, Debug, Eq, PartialEq, thiserror::Error)]
+#[error("unable to calculate the fluid batch: {0}")]
+pub struct FluidBatchError(#[from] CoolPropError);
+
+/// Error during calculation of the phase envelope, spinodal or critical points
+/// of the [`Fluid`].
+#[derive(Clone, Debug, Eq, PartialEq, thiserror::Error)]
+#[error("unable to calculate the fluid envelope: {0}")]
+pub struct FluidEnvelopeError(#[from] CoolPropError);
+
 /// Error during specifying the phase for a [`Fluid`].
 #[derive(Clone, Debug, Eq, PartialEq, thiserror::Error)]
 pub enum FluidPhaseError {
@@ -240,6 +278,26 @@ pub enum FluidPhaseError {
     SpecifyFailed(#[from] CoolPropError),
 }
 
+/// Error during [`Fluid::set_composition`] or [`Fluid::set_fraction`].
+#[derive(Clone, Debug, PartialEq, thiserror::Error)]
+pub enum FluidCompositionError {
+    /// Specified substance is not a mixture of the same components.
+    #[error("specified substance must be a mixture of the same components")]
+    IncompatibleSubstance,
+
+    /// Specified fraction is out of possible range.
+    #[error(transparent)]
+    InvalidFraction(#[from] BinaryMixError),
+
+    /// Failed to set the fractions of the mixture components.
+    #[error("failed to set the fluid composition: {0}")]
+    SetFailed(#[from] CoolPropError),
+
+    /// Failed to recalculate the current state with the new composition.
+    #[error("failed to update the fluid state with the new composition: {0}")]
+    UpdateFailed(CoolPropError),
+}
+
 /// Error during [`Fluid::update`] or [`Fluid::in_state`].
 #[derive(Clone, Debug, Eq, PartialEq, thiserror::Error)]
 pub enum FluidStateError {
@@ -256,6 +314,26 @@ pub enum FluidStateError {
     UpdateFailed(#[from] CoolPropError),
 }
 
+/// Error during [`Fluid::solve_for`].
+#[derive(Clone, Debug, PartialEq, thiserror::Error)]
+pub enum FluidSolveError {
+    /// Specified range of the free parameter is invalid or doesn't bracket the target.
+    #[error("target is not bracketed by the free parameter range {0}..={1}")]
+    NotBracketed(f64, f64),
+
+    /// Solver didn't converge in the maximum number of iterations.
+    #[error("solver didn't converge in {0} iterations")]
+    NotConverged(usize),
+
+    /// Failed to update the fluid state during the iterations.
+    #[error(transparent)]
+    State(#[from] FluidStateError),
+
+    /// Failed to calculate the target output parameter value during the iterations.
+    #[error(transparent)]
+    Output(#[from] FluidOutputError),
+}
+
 /// Error during calculation of the [`Fluid`] output parameter value.
 #[derive(Clone, Debug, Eq, PartialEq, thiserror::Error)]
 pub enum FluidOutputError {
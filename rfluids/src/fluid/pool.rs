@@ -0,0 +1,348 @@
+use std::{
+    cell::RefCell,
+    mem::ManuallyDrop,
+    ops::{Deref, DerefMut},
+    sync::Arc,
+};
+
+use super::backend::Backend;
+use crate::{
+    native::{AbstractState, CoolPropError, composition},
+    substance::{Substance, SubstanceWithBackend},
+};
+
+/// Maximum number of idle native handles kept per thread.
+const MAX_IDLE_HANDLES: usize = 64;
+
+thread_local! {
+    static POOL: RefCell<Pool> = RefCell::new(Pool::default());
+}
+
+/// Everything required to build an equivalent native handle.
+#[derive(Debug, Eq, Hash, PartialEq)]
+pub(crate) struct PoolKey {
+    backend: Backend,
+    composition_id: String,
+    fractions: Vec<u64>,
+}
+
+impl PoolKey {
+    fn build(&self) -> Result<AbstractState, CoolPropError> {
+        let mut state = AbstractState::new(self.backend.name(), &self.composition_id)?;
+        if !self.fractions.is_empty() {
+            state.set_fractions(&self.fractions()).unwrap();
+        }
+        Ok(state)
+    }
+
+    /// Fractions of the mixture components in the order of the composition ID.
+    fn fractions(&self) -> Vec<f64> {
+        self.fractions.iter().map(|&x| f64::from_bits(x)).collect()
+    }
+}
+
+/// Per-thread pool of idle native handles.
+///
+/// It's bounded, and the least recently used handles are evicted first
+/// _(the most recently used handles are at the back)_.
+#[derive(Default)]
+struct Pool {
+    idle: Vec<(Arc<PoolKey>, AbstractState)>,
+}
+
+impl Pool {
+    fn take(&mut self, key: &PoolKey) -> Option<AbstractState> {
+        let i = self.idle.iter().rposition(|(x, _)| x.as_ref() == key)?;
+        Some(self.idle.remove(i).1)
+    }
+
+    fn put(&mut self, key: Arc<PoolKey>, state: AbstractState) {
+        if self.idle.len() >= MAX_IDLE_HANDLES {
+            self.idle.remove(0);
+        }
+        self.idle.push((key, state));
+    }
+}
+
+impl Drop for Pool {
+    /// Frees the idle native handles of the exiting thread right away,
+    /// instead of leaving them in the queue of pending frees.
+    fn drop(&mut self) {
+        self.idle.clear();
+        AbstractState::free_pending();
+    }
+}
+
+/// Native handle checked out from the per-thread pool.
+///
+/// Creating a native handle is expensive (fluid data parsing, table loading, etc.),
+/// so on drop the handle is returned to the pool of the current thread
+/// _(with unspecified phase)_ and reused by the next checkout with the same
+/// backend and composition.
+#[derive(Debug)]
+pub(crate) struct PooledState {
+    state: ManuallyDrop<AbstractState>,
+    key: Arc<PoolKey>,
+}
+
+impl PooledState {
+    pub fn checkout(request: &SubstanceWithBackend) -> Result<Self, CoolPropError> {
+        let (composition_id, fractions) = composition(&request.substance);
+        Self::checkout_by_key(Arc::new(PoolKey {
+            backend: request.backend,
+            composition_id: composition_id.into_owned(),
+            fractions: fractions.unwrap_or_default().into_iter().map(f64::to_bits).collect(),
+        }))
+    }
+
+    /// Backend and composition of the native handle.
+    pub fn key(&self) -> &Arc<PoolKey> {
+        &self.key
+    }
+
+    /// Returns `true` if the native handle has no adjustable fractions
+    /// _(i.e., it's not a binary or custom mixture)_.
+    pub fn has_fixed_composition(&self) -> bool {
+        self.key.fractions.is_empty()
+    }
+
+    /// Fractions of the mixture components of the native handle.
+    pub fn fractions(&self) -> Vec<f64> {
+        self.key.fractions()
+    }
+
+    /// Fractions of the `substance` components in the order of the native handle
+    /// _(if it's a mixture of the same components)_.
+    pub fn fractions_of(&self, substance: &Substance) -> Option<Vec<f64>> {
+        let (composition_id, fractions) = composition(substance);
+        let fractions = fractions.filter(|_| !self.key.fractions.is_empty())?;
+        if composition_id == self.key.composition_id {
+            return Some(fractions);
+        }
+        // Components of the custom mixtures can be listed in any order
+        let components: Vec<&str> = composition_id.split('&').collect();
+        self.key
+            .composition_id
+            .split('&')
+            .map(|name| components.iter().position(|&x| x == name).map(|i| fractions[i]))
+            .collect::<Option<Vec<f64>>>()
+            .filter(|x| x.len() == fractions.len())
+    }
+
+    /// Updates fractions of the mixture components without rebuilding the native handle.
+    pub fn set_fractions(&mut self, fractions: &[f64]) -> Result<(), CoolPropError> {
+        self.state.set_fractions(fractions)?;
+        self.key = Arc::new(PoolKey {
+            backend: self.key.backend,
+            composition_id: self.key.composition_id.clone(),
+            fractions: fractions.iter().map(|x| x.to_bits()).collect(),
+        });
+        Ok(())
+    }
+
+    pub fn duplicate(&self) -> Result<Self, CoolPropError> {
+        Self::checkout_by_key(Arc::clone(&self.key))
+    }
+
+    fn checkout_by_key(key: Arc<PoolKey>) -> Result<Self, CoolPropError> {
+        let state = POOL.try_with(|pool| pool.borrow_mut().take(&key)).ok().flatten();
+        let state = match state {
+            Some(state) => state,
+            None => key.build()?,
+        };
+        Ok(Self { state: ManuallyDrop::new(state), key })
+    }
+}
+
+impl Deref for PooledState {
+    type Target = AbstractState;
+
+    fn deref(&self) -> &Self::Target {
+        &self.state
+    }
+}
+
+impl DerefMut for PooledState {
+    fn deref_mut(&mut self) -> &mut Self::Target {
+        &mut self.state
+    }
+}
+
+impl Drop for PooledState {
+    fn drop(&mut self) {
+        let mut state = unsafe { ManuallyDrop::take(&mut self.state) };
+        state.unspecify_phase();
+        let key = Arc::clone(&self.key);
+        // If the pool is already destroyed (i.e., the thread is exiting),
+        // the handle is just released
+        let _unused = POOL.try_with(move |pool| pool.borrow_mut().put(key, state));
+    }
+}
+
+/// Number of idle native handles in the pool of the current thread.
+#[cfg(test)]
+pub(crate) fn idle_len() -> usize {
+    POOL.with(|pool| pool.borrow().idle.len())
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::{
+        fluid::backend::BaseBackend,
+        io::{FluidInputPair, Phase},
+        substance::{BinaryMixKind, CustomMix, Pure},
+    };
+
+    fn water() -> SubstanceWithBackend {
+        Substance::from(Pure::Water).into_with_default_backend()
+    }
+
+    #[test]
+    fn checkout_reuses_idle_handle() {
+        // Given
+        let sut = PooledState::checkout(&water()).unwrap();
+        drop(sut);
+
+        // When
+        let res = PooledState::checkout(&water());
+
+        // Then
+        assert!(res.is_ok());
+        assert_eq!(idle_len(), 0);
+    }
+
+    #[test]
+    fn checkout_different_composition() {
+        // Given
+        let pg = Substance::from(BinaryMixKind::MPG.with_fraction(0.4).unwrap());
+        let sut = PooledState::checkout(&pg.into_with_default_backend()).unwrap();
+        drop(sut);
+
+        // When
+        let res = PooledState::checkout(&water());
+
+        // Then
+        assert!(res.is_ok());
+        assert_eq!(idle_len(), 1);
+    }
+
+    #[test]
+    fn checkout_invalid_composition() {
+        // Given
+        let key = PoolKey {
+            backend: Backend::Base(BaseBackend::Heos),
+            composition_id: "Hello, World!".into(),
+            fractions: Vec::new(),
+        };
+
+        // When
+        let res = PooledState::checkout_by_key(Arc::new(key));
+
+        // Then
+        assert!(res.is_err());
+        assert_eq!(idle_len(), 0);
+    }
+
+    #[test]
+    fn duplicate() {
+        // Given
+        let sut = PooledState::checkout(&water()).unwrap();
+
+        // When
+        let res = sut.duplicate().unwrap();
+
+        // Then
+        assert_eq!(res.key, sut.key);
+        assert_eq!(idle_len(), 0);
+    }
+
+    #[test]
+    fn set_fractions() {
+        // Given
+        let mix = |fraction: f64| {
+            Substance::from(BinaryMixKind::MPG.with_fraction(fraction).unwrap())
+                .into_with_default_backend()
+        };
+        let mut sut = PooledState::checkout(&mix(0.4)).unwrap();
+
+        // When
+        sut.set_fractions(&[0.6]).unwrap();
+
+        // Then
+        assert_eq!(sut.fractions(), vec![0.6]);
+        assert_eq!(sut.key, PooledState::checkout(&mix(0.6)).unwrap().key);
+    }
+
+    #[test]
+    fn fractions_of() {
+        // Given
+        let mix = |water: f64, ethanol: f64| {
+            Substance::from(
+                CustomMix::mole_based([(Pure::Water, water), (Pure::Ethanol, ethanol)]).unwrap(),
+            )
+        };
+        let sut = PooledState::checkout(&mix(0.8, 0.2).into_with_default_backend()).unwrap();
+        let expected: Vec<f64> = sut
+            .key
+            .composition_id
+            .split('&')
+            .map(|name| if name == "Water" { 0.6 } else { 0.4 })
+            .collect();
+
+        // When
+        let res = sut.fractions_of(&mix(0.6, 0.4));
+
+        // Then
+        assert_eq!(res, Some(expected));
+        assert_eq!(sut.fractions_of(&Substance::from(Pure::Water)), None);
+        assert_eq!(
+            sut.fractions_of(&Substance::from(BinaryMixKind::MPG.with_fraction(0.4).unwrap())),
+            None
+        );
+    }
+
+    #[test]
+    fn drop_unspecifies_phase() {
+        // Given
+        let mut sut = PooledState::checkout(&water()).unwrap();
+        sut.specify_phase(Phase::Gas).unwrap();
+        drop(sut);
+
+        // When
+        let mut res = PooledState::checkout(&water()).unwrap();
+
+        // Then
+        assert!(res.update(FluidInputPair::PT, 101_325.0, 293.15).is_ok());
+    }
+
+    #[test]
+    fn drop_respects_max_idle_handles() {
+        // Given
+        let handles: Vec<PooledState> =
+            (0..=MAX_IDLE_HANDLES).map(|_| PooledState::checkout(&water()).unwrap()).collect();
+
+        // When
+        drop(handles);
+
+        // Then
+        assert_eq!(idle_len(), MAX_IDLE_HANDLES);
+    }
+
+    #[test]
+    fn drop_evicts_least_recently_used() {
+        // Given
+        let r32 = Substance::from(Pure::R32).into_with_default_backend();
+        drop(PooledState::checkout(&r32).unwrap());
+        let handles: Vec<PooledState> =
+            (0..MAX_IDLE_HANDLES).map(|_| PooledState::checkout(&water()).unwrap()).collect();
+        let water_key = Arc::clone(handles[0].key());
+
+        // When
+        drop(handles);
+
+        // Then
+        assert_eq!(idle_len(), MAX_IDLE_HANDLES);
+        assert!(POOL.with(|pool| pool.borrow().idle.iter().all(|(x, _)| *x == water_key)));
+    }
+}
@@ -0,0 +1,206 @@
+use super::{
+    FluidOutputError, FluidSolveError, FluidStateError, request::FluidUpdateRequest, warm_start,
+};
+use crate::{
+    io::{FluidInput, FluidParam},
+    metrics,
+    native::AbstractState,
+};
+
+/// Maximum number of iterations of the solver.
+const MAX_ITERATIONS: usize = 64;
+
+/// Relative tolerance of the target residual and the free parameter bracket.
+const TOLERANCE: f64 = 1e-10;
+
+/// Result of [`Fluid::solve_for`](crate::fluid::Fluid::solve_for).
+#[derive(Clone, Copy, Debug, PartialEq)]
+pub struct FluidSolution {
+    /// Value of the free parameter at which the target is met **\[SI units\]**.
+    pub value: f64,
+    /// Number of state updates of the native handle _(including the bracket ends)_.
+    pub iterations: usize,
+}
+
+/// Inverse-property problem: find the value of the `free` parameter
+/// at which the `target` is met with the `fixed` input.
+#[derive(Clone, Copy, Debug)]
+pub(crate) struct Problem {
+    pub(crate) target: FluidInput,
+    pub(crate) fixed: FluidInput,
+    pub(crate) free: FluidParam,
+}
+
+/// Solves the problem by Newton iterations safeguarded by bisection of the bracket.
+///
+/// The Newton step uses the analytical derivative of the target at constant fixed input
+/// _(or the secant slope, if it's not available, e.g., for transport properties)_,
+/// and each state update is warm-started from the previous one,
+/// so the same native handle is reused for the whole process.
+/// The native state after the solution is the last evaluated one.
+pub(crate) fn solve(
+    backend: &mut AbstractState,
+    problem: Problem,
+    bracket: (f64, f64),
+    guess: Option<(f64, f64)>,
+) -> Result<FluidSolution, FluidSolveError> {
+    let mut solver = Solver { backend, problem, guess, iterations: 0 };
+    let (mut lo, mut hi) = bracket;
+    if !(lo.is_finite() && hi.is_finite() && lo != hi) {
+        return Err(FluidSolveError::NotBracketed(lo, hi));
+    }
+    let f_lo = solver.residual(lo)?;
+    if solver.converged(f_lo) {
+        return Ok(solver.solution(lo));
+    }
+    let f_hi = solver.residual(hi)?;
+    if solver.converged(f_hi) {
+        return Ok(solver.solution(hi));
+    }
+    if f_lo.signum() == f_hi.signum() {
+        return Err(FluidSolveError::NotBracketed(lo, hi));
+    }
+    // From now on, the residual is negative at `lo` and positive at `hi`
+    let (mut previous, mut f_previous) = (hi, f_hi);
+    let mut x = lo - f_lo * (hi - lo) / (f_hi - f_lo);
+    if f_lo > 0.0 {
+        (lo, hi) = (hi, lo);
+    }
+    while solver.iterations < MAX_ITERATIONS {
+        let (f, slope) = solver.residual_with_slope(x)?;
+        if solver.converged(f) {
+            return Ok(solver.solution(x));
+        }
+        if f < 0.0 {
+            lo = x;
+        } else {
+            hi = x;
+        }
+        if (hi - lo).abs() <= TOLERANCE * x.abs().max(1.0) {
+            return Ok(solver.solution(x));
+        }
+        let slope = slope.unwrap_or((f - f_previous) / (x - previous));
+        let next = x - f / slope;
+        (previous, f_previous) = (x, f);
+        x = if next.is_finite() && (next - lo) * (next - hi) < 0.0 {
+            next
+        } else {
+            0.5 * (lo + hi)
+        };
+    }
+    Err(FluidSolveError::NotConverged(solver.iterations))
+}
+
+struct Solver<'a> {
+    backend: &'a mut AbstractState,
+    problem: Problem,
+    guess: Option<(f64, f64)>,
+    iterations: usize,
+}
+
+impl Solver<'_> {
+    /// Updates the state at the free parameter value and returns the target residual.
+    fn residual(&mut self, value: f64) -> Result<f64, FluidSolveError> {
+        let request: FluidUpdateRequest =
+            (self.problem.fixed, FluidInput { key: self.problem.free, value }).try_into()?;
+        self.iterations += 1;
+        let warm_started = self
+            .guess
+            .is_some_and(|guess| warm_start::update_near(self.backend, request, guess).is_some());
+        let res = if warm_started {
+            Ok(())
+        } else {
+            self.backend.update(request.input_pair, request.value1, request.value2)
+        };
+        if let Err(e) = res {
+            metrics::record_failed_flash(request.input_pair);
+            return Err(FluidStateError::UpdateFailed(e).into());
+        }
+        self.guess = self
+            .backend
+            .keyed_output(FluidParam::DMass)
+            .and_then(|density| Ok((density, self.backend.keyed_output(FluidParam::T)?)))
+            .ok();
+        let target = self.problem.target;
+        self.backend
+            .keyed_output(target.key)
+            .map(|value| value - target.value)
+            .map_err(|e| FluidOutputError::CalculationFailed(target.key, e).into())
+    }
+
+    /// Same as [`Solver::residual`], but also returns the derivative of the target
+    /// with respect to the free parameter _(if it's available)_.
+    fn residual_with_slope(&mut self, value: f64) -> Result<(f64, Option<f64>), FluidSolveError> {
+        let residual = self.residual(value)?;
+        let Problem { target, fixed, free } = self.problem;
+        let slope = self
+            .backend
+            .first_partial_deriv(target.key, free, fixed.key)
+            .ok()
+            .filter(|x| x.is_finite() && *x != 0.0);
+        Ok((residual, slope))
+    }
+
+    fn converged(&self, residual: f64) -> bool {
+        residual.abs() <= TOLERANCE * self.problem.target.value.abs().max(1.0)
+    }
+
+    fn solution(&self, value: f64) -> FluidSolution {
+        FluidSolution { value, iterations: self.iterations }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::test::assert_relative_eq;
+
+    fn water() -> AbstractState {
+        AbstractState::new("HEOS", "Water").unwrap()
+    }
+
+    fn problem(target: FluidInput) -> Problem {
+        Problem { target, fixed: FluidInput::pressure(101_325.0), free: FluidParam::T }
+    }
+
+    #[test]
+    fn solve_with_analytical_derivative() {
+        // Given
+        let mut sut = water();
+
+        // When
+        let res =
+            solve(&mut sut, problem(FluidInput::density(990.0)), (280.0, 360.0), None).unwrap();
+
+        // Then
+        assert_relative_eq!(sut.keyed_output(FluidParam::DMass).unwrap(), 990.0);
+        assert_relative_eq!(sut.keyed_output(FluidParam::T).unwrap(), res.value);
+        assert!(res.iterations < 10);
+    }
+
+    #[test]
+    fn solve_without_analytical_derivative() {
+        // Given
+        let mut sut = water();
+        let target = FluidInput { key: FluidParam::Prandtl, value: 5.0 };
+
+        // When
+        let res = solve(&mut sut, problem(target), (280.0, 360.0), None).unwrap();
+
+        // Then
+        assert_relative_eq!(sut.keyed_output(FluidParam::Prandtl).unwrap(), 5.0);
+        assert!(res.iterations < 20);
+    }
+
+    #[test]
+    fn solve_not_bracketed() {
+        // Given
+        let mut sut = water();
+
+        // When
+        let res = solve(&mut sut, problem(FluidInput::density(990.0)), (280.0, 300.0), None);
+
+        // Then
+        assert_eq!(res, Err(FluidSolveError::NotBracketed(280.0, 300.0)));
+    }
+}
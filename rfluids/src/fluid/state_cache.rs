@@ -0,0 +1,364 @@
+use std::{
+    collections::HashMap,
+    hash::{BuildHasher, RandomState},
+    sync::{
+        Arc, Mutex,
+        atomic::{AtomicU64, Ordering},
+    },
+};
+
+use super::{OutputResult, common::Outputs, pool::PoolKey, request::FluidUpdateRequest};
+use crate::io::{FluidParam, Phase};
+
+/// Number of independently locked shards of the [`FluidCache`].
+const SHARDS: usize = 16;
+
+/// Thread safe bounded cache of fluid states shared between [`Fluid`](crate::fluid::Fluid)
+/// instances.
+///
+/// Entries are keyed by the backend, substance, imposed phase and exact input values,
+/// and hold all outputs calculated for the state by any attached instance.
+/// When an attached instance is updated to a cached state, the native flash calculation
+/// is skipped and cached outputs are reused; the native state is recalculated only
+/// when an output that is not cached yet is requested.
+///
+/// The cache is split into independently locked shards, so it can be shared
+/// between threads _(e.g., wrapped in [`Arc`])_. When a shard is full,
+/// entries are evicted using the CLOCK _(second chance)_ algorithm.
+///
+/// # Examples
+///
+/// ```
+/// use std::sync::Arc;
+///
+/// use rfluids::{fluid::FluidCache, prelude::*};
+///
+/// let cache = Arc::new(FluidCache::new(1 << 20));
+/// let mut water = Fluid::builder()
+///     .substance(Pure::Water)
+///     .with_cache(Arc::clone(&cache))
+///     .build()?
+///     .in_state(FluidInput::pressure(101_325.0), FluidInput::temperature(293.15))?;
+/// let density = water.density()?;
+/// water.update(FluidInput::pressure(202_650.0), FluidInput::temperature(313.15))?;
+/// water.update(FluidInput::pressure(101_325.0), FluidInput::temperature(293.15))?;
+/// assert_eq!(water.density()?, density);
+/// assert_eq!(cache.hits(), 1);
+/// assert_eq!(cache.misses(), 2);
+/// # Ok::<(), rfluids::Error>(())
+/// ```
+#[derive(Debug)]
+pub struct FluidCache {
+    shards: Box<[Mutex<Shard>]>,
+    hasher: RandomState,
+    hits: AtomicU64,
+    misses: AtomicU64,
+}
+
+impl FluidCache {
+    /// Creates and returns a new empty [`FluidCache`] instance.
+    ///
+    /// # Arguments
+    ///
+    /// - `capacity_bytes` -- approximate memory bound of the cache **\[bytes\]**
+    ///   _(error messages of failed outputs are not taken into account;
+    ///   at least one entry per shard is always kept)_
+    #[must_use]
+    pub fn new(capacity_bytes: usize) -> Self {
+        let entry_bytes = size_of::<Slot>() + size_of::<(StateKey, usize)>();
+        let shard_capacity = (capacity_bytes / entry_bytes / SHARDS).max(1);
+        Self {
+            shards: (0..SHARDS).map(|_| Mutex::new(Shard::new(shard_capacity))).collect(),
+            hasher: RandomState::new(),
+            hits: AtomicU64::new(0),
+            misses: AtomicU64::new(0),
+        }
+    }
+
+    /// Maximum number of cached states.
+    #[must_use]
+    pub fn capacity(&self) -> usize {
+        self.shards.iter().map(|shard| shard.lock().unwrap().capacity).sum()
+    }
+
+    /// Number of cached states.
+    #[must_use]
+    pub fn len(&self) -> usize {
+        self.shards.iter().map(|shard| shard.lock().unwrap().slots.len()).sum()
+    }
+
+    /// Returns `true` if there are no cached states.
+    #[must_use]
+    pub fn is_empty(&self) -> bool {
+        self.len() == 0
+    }
+
+    /// Number of state updates served from the cache.
+    #[must_use]
+    pub fn hits(&self) -> u64 {
+        self.hits.load(Ordering::Relaxed)
+    }
+
+    /// Number of state updates not found in the cache.
+    #[must_use]
+    pub fn misses(&self) -> u64 {
+        self.misses.load(Ordering::Relaxed)
+    }
+
+    /// Removes all cached states and resets hit/miss counters.
+    pub fn clear(&self) {
+        for shard in &self.shards {
+            shard.lock().unwrap().clear();
+        }
+        self.hits.store(0, Ordering::Relaxed);
+        self.misses.store(0, Ordering::Relaxed);
+    }
+
+    pub(crate) fn get(&self, key: &StateKey, outputs: &mut Outputs) -> bool {
+        let found = match self.shard(key).lock().unwrap().get(key) {
+            Some(slot) => {
+                outputs.clone_from(&slot.outputs);
+                true
+            }
+            None => false,
+        };
+        let counter = if found { &self.hits } else { &self.misses };
+        counter.fetch_add(1, Ordering::Relaxed);
+        found
+    }
+
+    pub(crate) fn insert(&self, key: StateKey, outputs: &Outputs) {
+        self.shard(&key).lock().unwrap().insert(key, outputs);
+    }
+
+    pub(crate) fn insert_output(
+        &self,
+        key: &StateKey,
+        param: FluidParam,
+        value: &OutputResult<f64>,
+    ) {
+        if let Some(slot) = self.shard(key).lock().unwrap().get(key) {
+            slot.outputs.insert(param, value.clone());
+        }
+    }
+
+    fn shard(&self, key: &StateKey) -> &Mutex<Shard> {
+        &self.shards[self.hasher.hash_one(key) as usize % SHARDS]
+    }
+}
+
+/// Key of the [`FluidCache`] entry.
+#[derive(Clone, Debug, Eq, Hash, PartialEq)]
+pub(crate) struct StateKey {
+    composition: Arc<PoolKey>,
+    phase: u8,
+    input_pair: u8,
+    value1: u64,
+    value2: u64,
+}
+
+impl StateKey {
+    pub fn new(composition: &Arc<PoolKey>, phase: Phase, request: FluidUpdateRequest) -> Self {
+        Self {
+            composition: Arc::clone(composition),
+            phase: phase.into(),
+            input_pair: request.input_pair.into(),
+            value1: request.value1.to_bits(),
+            value2: request.value2.to_bits(),
+        }
+    }
+}
+
+/// Attachment of the [`FluidCache`] to the [`Fluid`](crate::fluid::Fluid) instance.
+#[derive(Clone, Debug)]
+pub(crate) struct CacheLink {
+    pub cache: Arc<FluidCache>,
+    /// Key of the current state _(if it's defined)_.
+    pub state: Option<StateKey>,
+}
+
+impl CacheLink {
+    pub fn new(cache: Arc<FluidCache>) -> Self {
+        Self { cache, state: None }
+    }
+
+    /// Looks up the state in the cache and makes it current on hit.
+    pub fn lookup(&mut self, key: StateKey, outputs: &mut Outputs) -> bool {
+        let found = self.cache.get(&key, outputs);
+        self.state = found.then_some(key);
+        found
+    }
+
+    /// Inserts the state into the cache and makes it current.
+    pub fn insert(&mut self, key: StateKey, outputs: &Outputs) {
+        self.cache.insert(key.clone(), outputs);
+        self.state = Some(key);
+    }
+
+    pub fn insert_output(&self, param: FluidParam, value: &OutputResult<f64>) {
+        if let Some(state) = &self.state {
+            self.cache.insert_output(state, param, value);
+        }
+    }
+}
+
+#[derive(Debug)]
+struct Slot {
+    key: StateKey,
+    outputs: Outputs,
+    referenced: bool,
+}
+
+#[derive(Debug)]
+struct Shard {
+    index: HashMap<StateKey, usize>,
+    slots: Vec<Slot>,
+    hand: usize,
+    capacity: usize,
+}
+
+impl Shard {
+    fn new(capacity: usize) -> Self {
+        Self { index: HashMap::new(), slots: Vec::new(), hand: 0, capacity }
+    }
+
+    fn get(&mut self, key: &StateKey) -> Option<&mut Slot> {
+        let slot = &mut self.slots[*self.index.get(key)?];
+        slot.referenced = true;
+        Some(slot)
+    }
+
+    fn insert(&mut self, key: StateKey, outputs: &Outputs) {
+        if let Some(slot) = self.get(&key) {
+            slot.outputs.clone_from(outputs);
+            return;
+        }
+        let slot = Slot { key: key.clone(), outputs: outputs.clone(), referenced: false };
+        if self.slots.len() < self.capacity {
+            self.index.insert(key, self.slots.len());
+            self.slots.push(slot);
+            return;
+        }
+        while self.slots[self.hand].referenced {
+            self.slots[self.hand].referenced = false;
+            self.hand = (self.hand + 1) % self.capacity;
+        }
+        self.index.remove(&self.slots[self.hand].key);
+        self.index.insert(key, self.hand);
+        self.slots[self.hand] = slot;
+        self.hand = (self.hand + 1) % self.capacity;
+    }
+
+    fn clear(&mut self) {
+        self.index.clear();
+        self.slots.clear();
+        self.hand = 0;
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::{
+        fluid::pool::PooledState,
+        io::FluidInputPair,
+        substance::{Pure, Substance},
+    };
+
+    fn key(temperature: f64) -> StateKey {
+        let water = Substance::from(Pure::Water).into_with_default_backend();
+        let composition = Arc::clone(PooledState::checkout(&water).unwrap().key());
+        let request = FluidUpdateRequest {
+            input_pair: FluidInputPair::PT,
+            value1: 101_325.0,
+            value2: temperature,
+        };
+        StateKey::new(&composition, Phase::NotImposed, request)
+    }
+
+    fn outputs(density: f64) -> Outputs {
+        let mut outputs = Outputs::new();
+        outputs.insert(FluidParam::DMass, Ok(density));
+        outputs
+    }
+
+    #[test]
+    fn new() {
+        // When
+        let sut = FluidCache::new(0);
+
+        // Then
+        assert!(sut.is_empty());
+        assert_eq!(sut.capacity(), SHARDS);
+        assert_eq!(sut.hits(), 0);
+        assert_eq!(sut.misses(), 0);
+    }
+
+    #[test]
+    fn get_counts_hits_and_misses() {
+        // Given
+        let sut = FluidCache::new(1 << 20);
+        sut.insert(key(293.15), &outputs(998.0));
+        let mut res = Outputs::new();
+
+        // When
+        let hit = sut.get(&key(293.15), &mut res);
+        let miss = sut.get(&key(313.15), &mut Outputs::new());
+
+        // Then
+        assert!(hit);
+        assert!(!miss);
+        assert_eq!(res, outputs(998.0));
+        assert_eq!((sut.hits(), sut.misses()), (1, 1));
+    }
+
+    #[test]
+    fn insert_output() {
+        // Given
+        let sut = FluidCache::new(1 << 20);
+        sut.insert(key(293.15), &outputs(998.0));
+        let mut res = Outputs::new();
+
+        // When
+        sut.insert_output(&key(293.15), FluidParam::CpMass, &Ok(4_184.0));
+        sut.insert_output(&key(313.15), FluidParam::CpMass, &Ok(4_179.0));
+
+        // Then
+        assert!(sut.get(&key(293.15), &mut res));
+        assert_eq!(res.get(FluidParam::CpMass), Some(Ok(4_184.0)));
+        assert_eq!(sut.len(), 1);
+    }
+
+    #[test]
+    fn insert_evicts_not_referenced_entries() {
+        // Given
+        let mut sut = Shard::new(2);
+        sut.insert(key(1.0), &outputs(1.0));
+        sut.insert(key(2.0), &outputs(2.0));
+        let _referenced = sut.get(&key(1.0));
+
+        // When
+        sut.insert(key(3.0), &outputs(3.0));
+
+        // Then
+        assert_eq!(sut.slots.len(), 2);
+        assert!(sut.get(&key(1.0)).is_some());
+        assert!(sut.get(&key(2.0)).is_none());
+        assert!(sut.get(&key(3.0)).is_some());
+    }
+
+    #[test]
+    fn clear() {
+        // Given
+        let sut = FluidCache::new(1 << 20);
+        sut.insert(key(293.15), &outputs(998.0));
+        let _hit = sut.get(&key(293.15), &mut Outputs::new());
+
+        // When
+        sut.clear();
+
+        // Then
+        assert!(sut.is_empty());
+        assert_eq!(sut.hits(), 0);
+    }
+}
@@ -0,0 +1,182 @@
+use std::{
+    collections::HashMap,
+    sync::{Arc, LazyLock, OnceLock, RwLock},
+};
+
+use strum::EnumCount;
+
+use super::{
+    FluidOutputError, OutputResult,
+    common::{TrivialOutputs, guard},
+    pool::{PoolKey, PooledState},
+};
+use crate::{
+    io::FluidTrivialParam,
+    native::CoolPropError,
+    substance::{Pure, Substance},
+};
+
+/// Trivial outputs shared between all [`Fluid`](crate::fluid::Fluid) instances
+/// of the process, keyed by the backend and composition of the native handle.
+///
+/// Trivial outputs are constants of the substance, so each of them is calculated
+/// natively at most once per process. Only substances with fixed composition are shared,
+/// so composition sweeps of mixtures don't grow the table without bound.
+static SHARED: LazyLock<RwLock<HashMap<Arc<PoolKey>, TrivialOutputs>>> =
+    LazyLock::new(RwLock::default);
+
+/// Trivial outputs of pure substances with the default backend, indexed by [`Pure`]
+/// discriminants. Each entry is filled with all trivial outputs on the first access,
+/// so further accesses need neither a native handle nor any FFI call.
+static PURE: [OnceLock<TrivialOutputs>; Pure::COUNT] = [const { OnceLock::new() }; Pure::COUNT];
+
+/// Returns the trivial output of the pure substance with the default backend
+/// from the process-wide table, guarded by `ok`.
+pub(crate) fn pure_trivial_output(
+    substance: Pure,
+    key: FluidTrivialParam,
+    ok: fn(f64) -> bool,
+) -> OutputResult<f64> {
+    let entry = &PURE[substance as usize];
+    let outputs = match entry.get() {
+        Some(outputs) => outputs,
+        None => {
+            let outputs = pure_trivial_outputs(substance)
+                .map_err(|_| FluidOutputError::UnavailableTrivialOutput(key))?;
+            entry.get_or_init(|| outputs)
+        }
+    };
+    let value = outputs.get(key).unwrap_or(Err(FluidOutputError::UnavailableTrivialOutput(key)))?;
+    guard(key.into(), value, f64::is_finite).and_then(|value| guard(key.into(), value, ok))
+}
+
+/// Calculates all trivial outputs of the pure substance on the pooled native handle
+/// _(also filling the shared table of [`Fluid`](crate::fluid::Fluid) instances)_.
+fn pure_trivial_outputs(substance: Pure) -> Result<TrivialOutputs, CoolPropError> {
+    let mut backend =
+        PooledState::checkout(&Substance::from(substance).into_with_default_backend())?;
+    let keys = (0..=FluidTrivialParam::ODP as u8).filter_map(FluidTrivialParam::from_repr);
+    Ok(trivial_outputs(&mut backend, keys))
+}
+
+/// Calculates the specified trivial outputs on the pooled native handle
+/// through [`trivial_output`] _(so substances with fixed composition also fill
+/// the shared table)_. Failures are cached as well.
+pub(crate) fn trivial_outputs(
+    backend: &mut PooledState,
+    keys: impl IntoIterator<Item = FluidTrivialParam>,
+) -> TrivialOutputs {
+    let mut outputs = TrivialOutputs::new();
+    for key in keys {
+        let _unused = trivial_output(&mut outputs, backend, key);
+    }
+    outputs
+}
+
+/// Returns the trivial output from the local `cache`, the shared table or the `backend`
+/// _(in that order)_, filling the local `cache` with all shared outputs on the way.
+pub(crate) fn trivial_output(
+    cache: &mut TrivialOutputs,
+    backend: &mut PooledState,
+    key: FluidTrivialParam,
+) -> OutputResult<f64> {
+    if let Some(res) = cache.get(key) {
+        return res;
+    }
+    let calculate = |backend: &mut PooledState| {
+        backend.keyed_output(key).map_err(|_| FluidOutputError::UnavailableTrivialOutput(key))
+    };
+    if !backend.has_fixed_composition() {
+        return cache.get_or_insert_with(key, || calculate(backend));
+    }
+    if let Some(shared) = SHARED.read().unwrap().get(backend.key()).filter(|x| x.contains(key)) {
+        cache.clone_from(shared);
+        return shared.get(key).unwrap();
+    }
+    let res = calculate(backend);
+    let mut table = SHARED.write().unwrap();
+    let shared = table.entry(Arc::clone(backend.key())).or_default();
+    shared.insert(key, res.clone());
+    cache.clone_from(shared);
+    res
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::{fluid::Fluid, substance::BinaryMixKind};
+
+    #[test]
+    fn trivial_output_shared_between_instances() {
+        // Given
+        let water = Substance::from(Pure::Water).into_with_default_backend();
+        let mut other = PooledState::checkout(&water).unwrap();
+        let expected =
+            trivial_output(&mut TrivialOutputs::new(), &mut other, FluidTrivialParam::MolarMass);
+        let mut sut = PooledState::checkout(&water).unwrap();
+        let mut cache = TrivialOutputs::new();
+
+        // When
+        let res = trivial_output(&mut cache, &mut sut, FluidTrivialParam::MolarMass);
+
+        // Then
+        assert_eq!(res, expected);
+        assert_eq!(cache.get(FluidTrivialParam::MolarMass), Some(expected));
+        assert!(SHARED.read().unwrap().get(sut.key()).is_some());
+    }
+
+    #[test]
+    fn pure_trivial_output_matches_fluid() {
+        // Given
+        let mut fluid = Fluid::from(Pure::R32);
+
+        // When
+        let res = pure_trivial_output(Pure::R32, FluidTrivialParam::TCritical, |x| x > 0.0);
+
+        // Then
+        assert_eq!(res, fluid.critical_temperature());
+        assert!(PURE[Pure::R32 as usize].get().is_some());
+        assert_eq!(Pure::R32.critical_temperature(), res);
+    }
+
+    #[test]
+    fn pure_trivial_output_unavailable() {
+        // When
+        let res = pure_trivial_output(Pure::Water, FluidTrivialParam::TFreeze, |x| x > 0.0);
+
+        // Then
+        assert!(res.is_err());
+    }
+
+    #[test]
+    fn trivial_outputs_fill_shared_table() {
+        // Given
+        let r134a = Substance::from(Pure::R134a).into_with_default_backend();
+        let mut sut = PooledState::checkout(&r134a).unwrap();
+
+        // When
+        let res =
+            trivial_outputs(&mut sut, [FluidTrivialParam::TCritical, FluidTrivialParam::TFreeze]);
+
+        // Then
+        let table = SHARED.read().unwrap();
+        let shared = table.get(sut.key()).unwrap();
+        assert_eq!(shared.get(FluidTrivialParam::TCritical), res.get(FluidTrivialParam::TCritical));
+        assert!(shared.contains(FluidTrivialParam::TFreeze));
+    }
+
+    #[test]
+    fn trivial_output_not_shared_for_mixtures() {
+        // Given
+        let pg = Substance::from(BinaryMixKind::MPG.with_fraction(0.4).unwrap());
+        let mut sut = PooledState::checkout(&pg.into_with_default_backend()).unwrap();
+        let mut cache = TrivialOutputs::new();
+
+        // When
+        let res = trivial_output(&mut cache, &mut sut, FluidTrivialParam::TFreeze);
+
+        // Then
+        assert_eq!(cache.get(FluidTrivialParam::TFreeze), Some(res));
+        assert!(SHARED.read().unwrap().get(sut.key()).is_none());
+    }
+}
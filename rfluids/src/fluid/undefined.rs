@@ -1,9 +1,14 @@
-use std::{collections::HashMap, marker::PhantomData};
-
-use super::{Fluid, FluidBuildError, FluidPhaseError, StateResult, backend::Backend};
+use std::{marker::PhantomData, sync::Arc};
+
+use super::{
+    Fluid, FluidBuildError, FluidCache, FluidPhaseError, StateResult,
+    backend::Backend,
+    common::{BuiltEnvelopes, DerivedOutputs, Outputs, TrivialOutputs},
+    pool::PooledState,
+    state_cache::CacheLink,
+};
 use crate::{
     io::{FluidInput, Phase},
-    native::AbstractState,
     state_variant::Undefined,
     substance::Substance,
 };
@@ -20,6 +25,8 @@ impl Fluid<Undefined> {
     /// - `substance` -- substance for which to calculate properties
     /// - `with_backend` -- `CoolProp` backend to be used ([`Backend`]). If provided, overrides the
     ///   default one defined for the substance
+    /// - `with_cache` -- cache of states shared between instances ([`FluidCache`]). If provided,
+    ///   updates to the cached states skip the native flash calculation
     ///
     /// # Errors
     ///
@@ -63,20 +70,27 @@ impl Fluid<Undefined> {
         /// If provided, overrides the default one defined for the substance.
         #[builder(into)]
         with_backend: Option<Backend>,
+        /// Cache of states shared between instances ([`FluidCache`]).
+        /// If provided, updates to the cached states skip the native flash calculation.
+        with_cache: Option<Arc<FluidCache>>,
     ) -> Result<Self, FluidBuildError> {
         let request = match with_backend {
             Some(custom) => substance.into_with_backend(custom),
             None => substance.into_with_default_backend(),
         };
-        let backend = AbstractState::try_from(&request)?;
+        let backend = PooledState::checkout(&request)?;
         Ok(Self {
             backend,
             backend_variant: request.backend,
             substance: request.substance,
             specified_phase: Phase::NotImposed,
             update_request: None,
-            outputs: HashMap::new(),
-            trivial_outputs: HashMap::new(),
+            outputs: Outputs::new(),
+            derived_outputs: DerivedOutputs::default(),
+            trivial_outputs: TrivialOutputs::new(),
+            stale_backend: false,
+            envelopes: BuiltEnvelopes::default(),
+            cache: with_cache.map(CacheLink::new),
             state: PhantomData,
         })
     }
@@ -186,7 +200,11 @@ impl Fluid<Undefined> {
             specified_phase: self.specified_phase,
             update_request: self.update_request,
             outputs: self.outputs,
+            derived_outputs: self.derived_outputs,
             trivial_outputs: self.trivial_outputs,
+            stale_backend: self.stale_backend,
+            envelopes: self.envelopes,
+            cache: self.cache,
             state: PhantomData,
         })
     }
@@ -194,16 +212,7 @@ impl Fluid<Undefined> {
 
 impl Clone for Fluid<Undefined> {
     fn clone(&self) -> Self {
-        let mut fluid = Fluid::builder()
-            .substance(self.substance.clone())
-            .with_backend(self.backend_variant)
-            .build()
-            .unwrap();
-        if self.specified_phase != Phase::NotImposed {
-            fluid = fluid.specify_phase(self.specified_phase).unwrap();
-        }
-        fluid.trivial_outputs.clone_from(&self.trivial_outputs);
-        fluid
+        self.duplicate()
     }
 }
 
@@ -0,0 +1,173 @@
+use super::request::FluidUpdateRequest;
+use crate::{
+    io::{FluidInputPair, FluidParam},
+    native::AbstractState,
+};
+
+/// Maximum number of Newton iterations of the warm-started flash.
+const MAX_ITERATIONS: usize = 8;
+
+/// Relative tolerance of the warm-started flash residuals.
+const TOLERANCE: f64 = 1e-10;
+
+/// Updates the state of the backend by Newton iterations over mass density and temperature,
+/// starting from the specified `guess` _(mass density **\[kg/m³\]** and temperature **\[K\]**)_.
+///
+/// Each iteration is an explicit `DmassT` update and a few analytical derivatives,
+/// so for a close guess it's much cheaper than a regular flash, which has to determine
+/// the phase and solve for the state from scratch.
+///
+/// Two-phase states are never warm-started, since the mass density and temperature
+/// are not independent there _(the Newton step is ill-conditioned near the saturation
+/// curve and the regular flash is required to split the phases anyway)_.
+///
+/// Returns [`None`] if the inputs are not supported, the guess or any iterate is two-phase
+/// or the iterations don't converge _(the backend state is undefined in this case,
+/// so a regular flash should be performed)_.
+pub(crate) fn update_near(
+    backend: &mut AbstractState,
+    request: FluidUpdateRequest,
+    guess: (f64, f64),
+) -> Option<()> {
+    let (key1, key2): (FluidParam, FluidParam) = request.input_pair.into();
+    if request.input_pair == FluidInputPair::DMassT
+        || key1 == FluidParam::Q
+        || key2 == FluidParam::Q
+    {
+        return None;
+    }
+    let (mut density, mut temperature) = guess;
+    for _ in 0..MAX_ITERATIONS {
+        if !(density > 0.0 && temperature > 0.0) {
+            return None;
+        }
+        backend.update(FluidInputPair::DMassT, density, temperature).ok()?;
+        if is_two_phase(backend) {
+            return None;
+        }
+        let residual1 = backend.keyed_output(key1).ok()? - request.value1;
+        let residual2 = backend.keyed_output(key2).ok()? - request.value2;
+        if converged(residual1, request.value1) && converged(residual2, request.value2) {
+            return Some(());
+        }
+        let [d1_drho, d1_dt, d2_drho, d2_dt] = [
+            (key1, FluidParam::DMass, FluidParam::T),
+            (key1, FluidParam::T, FluidParam::DMass),
+            (key2, FluidParam::DMass, FluidParam::T),
+            (key2, FluidParam::T, FluidParam::DMass),
+        ]
+        .map(|(of, wrt, constant)| backend.first_partial_deriv(of, wrt, constant));
+        let (d1_drho, d1_dt, d2_drho, d2_dt) =
+            (d1_drho.ok()?, d1_dt.ok()?, d2_drho.ok()?, d2_dt.ok()?);
+        let det = d1_drho * d2_dt - d1_dt * d2_drho;
+        if det == 0.0 || !det.is_finite() {
+            return None;
+        }
+        density -= (residual1 * d2_dt - residual2 * d1_dt) / det;
+        temperature -= (residual2 * d1_drho - residual1 * d2_drho) / det;
+    }
+    None
+}
+
+fn is_two_phase(backend: &AbstractState) -> bool {
+    backend.keyed_output(FluidParam::Q).is_ok_and(|quality| (0.0..=1.0).contains(&quality))
+}
+
+fn converged(residual: f64, target: f64) -> bool {
+    residual.abs() <= TOLERANCE * target.abs().max(1.0)
+}
+
+#[cfg(test)]
+mod tests {
+    use rstest::*;
+
+    use super::*;
+    use crate::test::assert_relative_eq;
+
+    fn water() -> AbstractState {
+        AbstractState::new("HEOS", "Water").unwrap()
+    }
+
+    #[rstest]
+    #[case(FluidInputPair::HMassP, FluidParam::HMass, FluidParam::P)]
+    #[case(FluidInputPair::PSMass, FluidParam::P, FluidParam::SMass)]
+    #[case(FluidInputPair::PT, FluidParam::P, FluidParam::T)]
+    fn update_near_matches_regular_flash(
+        #[case] input_pair: FluidInputPair,
+        #[case] key1: FluidParam,
+        #[case] key2: FluidParam,
+    ) {
+        // Given
+        let mut expected = water();
+        expected.update(FluidInputPair::PT, 101_325.0, 293.16).unwrap();
+        let request = FluidUpdateRequest {
+            input_pair,
+            value1: expected.keyed_output(key1).unwrap(),
+            value2: expected.keyed_output(key2).unwrap(),
+        };
+        let mut sut = water();
+
+        // When
+        let res = update_near(&mut sut, request, (998.207_150_467_928_4, 293.15));
+
+        // Then
+        assert!(res.is_some());
+        assert_relative_eq!(
+            sut.keyed_output(FluidParam::DMass).unwrap(),
+            expected.keyed_output(FluidParam::DMass).unwrap()
+        );
+        assert_relative_eq!(
+            sut.keyed_output(FluidParam::T).unwrap(),
+            expected.keyed_output(FluidParam::T).unwrap()
+        );
+    }
+
+    #[rstest]
+    #[case(FluidInputPair::PQ)]
+    #[case(FluidInputPair::DMassT)]
+    fn update_near_unsupported_inputs(#[case] input_pair: FluidInputPair) {
+        // Given
+        let request = FluidUpdateRequest { input_pair, value1: 101_325.0, value2: 0.5 };
+        let mut sut = water();
+
+        // When
+        let res = update_near(&mut sut, request, (998.207_150_467_928_4, 293.15));
+
+        // Then
+        assert!(res.is_none());
+    }
+
+    #[test]
+    fn update_near_two_phase_guess() {
+        // Given
+        let request = FluidUpdateRequest {
+            input_pair: FluidInputPair::PT,
+            value1: 101_325.0,
+            value2: 383.15,
+        };
+        let mut sut = water();
+
+        // When
+        let res = update_near(&mut sut, request, (100.0, 373.15));
+
+        // Then
+        assert!(res.is_none());
+    }
+
+    #[test]
+    fn update_near_invalid_guess() {
+        // Given
+        let request = FluidUpdateRequest {
+            input_pair: FluidInputPair::PT,
+            value1: 101_325.0,
+            value2: 293.15,
+        };
+        let mut sut = water();
+
+        // When
+        let res = update_near(&mut sut, request, (-1.0, 293.15));
+
+        // Then
+        assert!(res.is_none());
+    }
+}
@@ -1,32 +1,38 @@
-use std::collections::HashMap;
-
 use super::{HumidAirOutputError, OutputResult, request::HumidAirUpdateRequest};
-use crate::{io::HumidAirParam, native::CoolProp};
+use crate::{
+    cache::{CacheKey, OutputCache},
+    io::{HumidAirInput, HumidAirParam},
+    native::CoolProp,
+};
+
+/// Cache of outputs, indexed by [`HumidAirParam`] discriminants.
+pub(crate) type Outputs =
+    OutputCache<HumidAirParam, HumidAirOutputError, { HumidAirParam::Z as usize + 1 }>;
+
+impl CacheKey for HumidAirParam {
+    fn index(self) -> usize {
+        self as usize
+    }
+}
 
+/// Returns the cached output value or calculates it.
+///
+/// For any inputs other than dry-bulb temperature, pressure and absolute humidity,
+/// `HAPropsSI` has to iterate for these values on each call. So they are resolved
+/// once per state _(and cached)_, and then used as inputs for all outputs
+/// _(see [`canonical_request`])_.
 pub(crate) fn cached_output(
-    cache: &mut HashMap<HumidAirParam, OutputResult<f64>>,
+    cache: &mut Outputs,
     key: HumidAirParam,
     request: HumidAirUpdateRequest,
 ) -> OutputResult<f64> {
-    match cache
-        .entry(key)
-        .or_insert_with(|| {
-            CoolProp::ha_props_si(
-                key,
-                request.0.key,
-                request.0.value,
-                request.1.key,
-                request.1.value,
-                request.2.key,
-                request.2.value,
-            )
-            .map_err(|e| HumidAirOutputError::CalculationFailed(key, e))
-        })
-        .as_ref()
-    {
-        Ok(&x) => Ok(x),
-        Err(e) => Err(e.clone()),
+    if let Some(value) = cache.get(key) {
+        return value;
     }
+    let inputs = canonical_request(cache, request).unwrap_or(request);
+    let value = cache.get(key).unwrap_or_else(|| solve(key, inputs));
+    cache.insert(key, value.clone());
+    value
 }
 
 pub(crate) fn guard(key: HumidAirParam, value: f64, ok: fn(f64) -> bool) -> OutputResult<f64> {
@@ -36,11 +42,56 @@ pub(crate) fn guard(key: HumidAirParam, value: f64, ok: fn(f64) -> bool) -> Outp
     Err(HumidAirOutputError::UnavailableOutput(key))
 }
 
+/// Equivalent request with dry-bulb temperature, pressure and absolute humidity inputs.
+///
+/// Only the dry-bulb temperature _(and pressure, if it's not an input)_ are solved for
+/// from the original inputs. The absolute humidity is then calculated from the dry-bulb
+/// temperature, pressure and one of the remaining original inputs, which is explicit
+/// for relative humidity, dew-point temperature and partial pressure of water vapor.
+/// So only one full iterative solve is performed per state.
+fn canonical_request(
+    cache: &mut Outputs,
+    request: HumidAirUpdateRequest,
+) -> OutputResult<HumidAirUpdateRequest> {
+    let temperature = HumidAirInput::temperature(
+        cache.get_or_insert_with(HumidAirParam::T, || solve(HumidAirParam::T, request))?,
+    );
+    let pressure = HumidAirInput::pressure(
+        cache.get_or_insert_with(HumidAirParam::P, || solve(HumidAirParam::P, request))?,
+    );
+    let abs_humidity = cache.get_or_insert_with(HumidAirParam::W, || {
+        // There is at least one such input, since all inputs have different keys
+        let others = [request.0, request.1, request.2]
+            .into_iter()
+            .filter(|input| !matches!(input.key, HumidAirParam::T | HumidAirParam::P));
+        let explicit = |input: &HumidAirInput| {
+            matches!(input.key, HumidAirParam::R | HumidAirParam::TDew | HumidAirParam::Pw)
+        };
+        let other = others.clone().find(explicit).or_else(|| others.clone().next()).unwrap();
+        solve(HumidAirParam::W, HumidAirUpdateRequest(temperature, pressure, other))
+    })?;
+    Ok(HumidAirUpdateRequest(temperature, pressure, HumidAirInput::abs_humidity(abs_humidity)))
+}
+
+fn solve(key: HumidAirParam, request: HumidAirUpdateRequest) -> OutputResult<f64> {
+    CoolProp::ha_props_si(
+        key,
+        request.0.key,
+        request.0.value,
+        request.1.key,
+        request.1.value,
+        request.2.key,
+        request.2.value,
+    )
+    .map_err(|e| HumidAirOutputError::CalculationFailed(key, e))
+}
+
 #[cfg(test)]
 pub(crate) mod tests {
     use rstest::*;
 
     use super::*;
+    use crate::test::assert_relative_eq;
 
     #[rstest]
     #[case(
@@ -55,4 +106,51 @@ pub(crate) mod tests {
         // Then
         assert_eq!(res, expected);
     }
+
+    #[rstest]
+    #[case(HumidAirParam::Hha)]
+    #[case(HumidAirParam::TDew)]
+    #[case(HumidAirParam::TWetBulb)]
+    #[case(HumidAirParam::Vda)]
+    fn cached_output_resolves_state_once(#[case] key: HumidAirParam) {
+        // Given
+        let request = HumidAirUpdateRequest(
+            HumidAirInput::pressure(101_325.0),
+            HumidAirInput::enthalpy(50_000.0),
+            HumidAirInput::rel_humidity(0.5),
+        );
+        let mut cache = Outputs::new();
+        for input in [request.0, request.1, request.2] {
+            cache.insert(input.key, Ok(input.value));
+        }
+
+        // When
+        let res = cached_output(&mut cache, key, request).unwrap();
+
+        // Then
+        assert_relative_eq!(res, solve(key, request).unwrap(), max_relative = 1e-6);
+        assert_eq!(cache.get(HumidAirParam::T), Some(solve(HumidAirParam::T, request)));
+        assert_relative_eq!(
+            cache.get(HumidAirParam::W).unwrap().unwrap(),
+            solve(HumidAirParam::W, request).unwrap(),
+            max_relative = 1e-6
+        );
+    }
+
+    #[test]
+    fn cached_output_invalid_request() {
+        // Given
+        let request = HumidAirUpdateRequest(
+            HumidAirInput::pressure(-1.0),
+            HumidAirInput::temperature(-1.0),
+            HumidAirInput::rel_humidity(1.5),
+        );
+        let mut cache = Outputs::new();
+
+        // When
+        let res = cached_output(&mut cache, HumidAirParam::Hha, request);
+
+        // Then
+        assert!(matches!(res, Err(HumidAirOutputError::CalculationFailed(HumidAirParam::Hha, _))));
+    }
 }
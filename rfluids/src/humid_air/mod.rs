@@ -4,16 +4,22 @@
 //! _**real**_ humid air through the [`HumidAir`] struct.
 //!
 //! Properties are calculated in accordance with **ASHRAE RP-1485**.
+//!
+//! For tight loops _(e.g., building energy simulations)_, [`HumidAirTable`] tabulates
+//! the properties once at the fixed pressure set and interpolates them entirely in Rust.
 
 mod common;
 mod defined;
 mod invariant;
 mod request;
+mod table;
 mod undefined;
 
-use std::{collections::HashMap, marker::PhantomData};
+use std::marker::PhantomData;
 
+use common::Outputs;
 use request::HumidAirUpdateRequest;
+pub use table::{HumidAirTable, HumidAirTableAxis, HumidAirTableError};
 
 use crate::{
     io::HumidAirParam,
@@ -43,7 +49,7 @@ pub type OutputResult<T> = Result<T, HumidAirOutputError>;
 #[derive(Debug)]
 pub struct HumidAir<S: StateVariant = Defined> {
     update_request: Option<HumidAirUpdateRequest>,
-    outputs: HashMap<HumidAirParam, OutputResult<f64>>,
+    outputs: Outputs,
     state: PhantomData<S>,
 }
 
@@ -0,0 +1,682 @@
+use std::ops::RangeInclusive;
+
+use crate::{io::HumidAirParam, native::CoolProp};
+
+/// Default numbers of nodes along the first axis and the absolute humidity axis.
+const DEFAULT_NODES: (usize, usize) = (41, 31);
+
+/// Default pressure set **\[Pa\]**.
+const DEFAULT_PRESSURE: f64 = 101_325.0;
+
+/// Relative tolerance of the pressure match.
+const PRESSURE_TOLERANCE: f64 = 1e-9;
+
+/// Number of nodes of the interpolation stencil along each axis.
+const STENCIL: usize = 4;
+
+/// All humid air parameters in order of their discriminants.
+const PARAMS: [HumidAirParam; HumidAirParam::Z as usize + 1] = [
+    HumidAirParam::TWetBulb,
+    HumidAirParam::Cpda,
+    HumidAirParam::Cpha,
+    HumidAirParam::Cvda,
+    HumidAirParam::Cvha,
+    HumidAirParam::TDew,
+    HumidAirParam::Hda,
+    HumidAirParam::Hha,
+    HumidAirParam::Conductivity,
+    HumidAirParam::DynamicViscosity,
+    HumidAirParam::PsiW,
+    HumidAirParam::P,
+    HumidAirParam::Pw,
+    HumidAirParam::R,
+    HumidAirParam::Sda,
+    HumidAirParam::Sha,
+    HumidAirParam::T,
+    HumidAirParam::Vda,
+    HumidAirParam::Vha,
+    HumidAirParam::W,
+    HumidAirParam::Z,
+];
+
+/// First axis of the [`HumidAirTable`] _(the second one is always the absolute humidity)_.
+#[cfg_attr(feature = "serde", derive(serde::Serialize, serde::Deserialize))]
+#[derive(Clone, Copy, Debug, Default, Eq, Hash, PartialEq)]
+pub enum HumidAirTableAxis {
+    /// Dry-bulb temperature **\[K\]**.
+    #[default]
+    Temperature,
+
+    /// Specific enthalpy per unit of dry air **\[J/kg dry air\]**.
+    Enthalpy,
+}
+
+impl HumidAirTableAxis {
+    /// Humid air parameter of the axis.
+    #[must_use]
+    pub fn key(self) -> HumidAirParam {
+        match self {
+            Self::Temperature => HumidAirParam::T,
+            Self::Enthalpy => HumidAirParam::Hda,
+        }
+    }
+}
+
+/// Lookup table of _**real**_ humid air properties evaluated entirely in Rust.
+///
+/// Each output of [`HumidAir`](crate::humid_air::HumidAir) is a full `HAPropsSI` solve
+/// _(hundreds of microseconds for most inputs)_, which dominates building energy simulations
+/// and other tight loops. On creation, `HumidAirTable` calculates the outputs by `CoolProp`
+/// on the uniform grid of the first axis _(dry-bulb temperature or specific enthalpy,
+/// see [`HumidAirTableAxis`])_ and absolute humidity for each pressure of the fixed set,
+/// and then evaluates them by bicubic _(4×4 nodes Lagrange)_ interpolation.
+///
+/// The interpolation is validated against `CoolProp` at the centers of all grid cells,
+/// where its error is the largest _(see [`HumidAirTable::max_error`])_.
+/// Grid nodes at which `CoolProp` fails are not available, so the outputs close to them
+/// are reported as out of range.
+///
+/// The table is immutable plain data, so it can be shared between threads via
+/// [`Arc`](std::sync::Arc) and, with the **`serde`** feature,
+/// serialized to disk and deserialized instead of being calculated again.
+///
+/// # Examples
+///
+/// ```
+/// use std::sync::Arc;
+///
+/// use approx::assert_relative_eq;
+/// use rfluids::{humid_air::HumidAirTable, io::HumidAirParam, prelude::*};
+///
+/// let table = Arc::new(
+///     HumidAirTable::builder()
+///         .range(283.15..=313.15)
+///         .humidity(0.0..=0.007)
+///         .outputs([HumidAirParam::Hha, HumidAirParam::R])
+///         .nodes((16, 8))
+///         .build()?,
+/// );
+///
+/// let mut humid_air = HumidAir::new().in_state(
+///     HumidAirInput::pressure(101_325.0),
+///     HumidAirInput::temperature(293.15),
+///     HumidAirInput::abs_humidity(0.005),
+/// )?;
+/// assert_relative_eq!(
+///     table.output(HumidAirParam::Hha, 101_325.0, 293.15, 0.005)?,
+///     humid_air.enthalpy()?,
+///     max_relative = 1e-5
+/// );
+///
+/// let temperatures = [288.15, 293.15, 298.15];
+/// let humidity = [0.005; 3];
+/// let mut rel_humidity = [0.0; 3];
+/// table.output_batch(HumidAirParam::R, 101_325.0, &temperatures, &humidity, &mut rel_humidity)?;
+/// assert!(rel_humidity.windows(2).all(|x| x[0] > x[1]));
+/// # Ok::<(), rfluids::Error>(())
+/// ```
+#[cfg_attr(feature = "serde", derive(serde::Serialize, serde::Deserialize))]
+#[derive(Clone, Debug, PartialEq)]
+pub struct HumidAirTable {
+    pressures: Vec<f64>,
+    axis: HumidAirTableAxis,
+    x: Grid,
+    w: Grid,
+    /// Tabulated outputs, indexed by [`HumidAirParam`] discriminants.
+    columns: Vec<Option<Column>>,
+}
+
+#[bon::bon]
+impl HumidAirTable {
+    /// Calculates a new [`HumidAirTable`].
+    ///
+    /// # Arguments
+    ///
+    /// - `pressures` -- fixed pressure set **\[Pa\]** _(101 325 Pa by default)_
+    /// - `axis` -- first axis _(dry-bulb temperature by default)_
+    /// - `range` -- range of the first axis **\[K\]** or **\[J/kg dry air\]**
+    /// - `humidity` -- range of the absolute humidity **\[kg water/kg dry air\]**
+    /// - `outputs` -- output parameters _(all of [`HumidAirParam`] by default)_
+    /// - `nodes` -- numbers of nodes along the first axis and the absolute humidity axis
+    ///   _(at least 4 each, default 41 and 31)_
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`HumidAirTableError`] for invalid pressures, ranges or numbers of nodes,
+    /// or if `CoolProp` fails to calculate some of the outputs at all nodes.
+    #[builder]
+    pub fn new(
+        /// Fixed pressure set **\[Pa\]**.
+        #[builder(into, default = vec![DEFAULT_PRESSURE])]
+        pressures: Vec<f64>,
+        /// First axis.
+        #[builder(default)]
+        axis: HumidAirTableAxis,
+        /// Range of the first axis.
+        range: RangeInclusive<f64>,
+        /// Range of the absolute humidity **\[kg water/kg dry air\]**.
+        humidity: RangeInclusive<f64>,
+        /// Output parameters.
+        #[builder(into, default = PARAMS.to_vec())]
+        outputs: Vec<HumidAirParam>,
+        /// Numbers of nodes along the first axis and the absolute humidity axis.
+        #[builder(default = DEFAULT_NODES)]
+        nodes: (usize, usize),
+    ) -> Result<Self, HumidAirTableError> {
+        if pressures.is_empty() || !pressures.iter().all(|p| p.is_finite() && *p > 0.0) {
+            return Err(HumidAirTableError::InvalidSpec(format!(
+                "invalid pressure set {pressures:?}"
+            )));
+        }
+        if axis == HumidAirTableAxis::Temperature && *range.start() <= 0.0 {
+            return Err(invalid_range("temperature", &range));
+        }
+        if *humidity.start() < 0.0 {
+            return Err(invalid_range("absolute humidity", &humidity));
+        }
+        let x = Grid::new(&range, nodes.0).ok_or_else(|| invalid_range("first axis", &range))?;
+        let w = Grid::new(&humidity, nodes.1)
+            .ok_or_else(|| invalid_range("absolute humidity", &humidity))?;
+        let mut table = Self { pressures, axis, x, w, columns: vec![None; PARAMS.len()] };
+        for key in outputs {
+            let column = table.tabulate(key).ok_or(HumidAirTableError::NotAvailable(key))?;
+            table.columns[key as usize] = Some(column);
+        }
+        Ok(table)
+    }
+}
+
+impl HumidAirTable {
+    /// Fixed pressure set **\[Pa\]**.
+    #[must_use]
+    pub fn pressures(&self) -> &[f64] {
+        &self.pressures
+    }
+
+    /// First axis.
+    #[must_use]
+    pub fn axis(&self) -> HumidAirTableAxis {
+        self.axis
+    }
+
+    /// Range of the first axis **\[K\]** or **\[J/kg dry air\]**.
+    #[must_use]
+    pub fn range(&self) -> RangeInclusive<f64> {
+        self.x.range()
+    }
+
+    /// Range of the absolute humidity **\[kg water/kg dry air\]**.
+    #[must_use]
+    pub fn humidity(&self) -> RangeInclusive<f64> {
+        self.w.range()
+    }
+
+    /// Tabulated output parameters.
+    pub fn outputs(&self) -> impl Iterator<Item = HumidAirParam> + '_ {
+        PARAMS.into_iter().filter(|key| self.columns[*key as usize].is_some())
+    }
+
+    /// Maximum absolute deviation of the interpolated output parameter from the `CoolProp`
+    /// values at the centers of the grid cells over all pressures **\[SI units\]**
+    /// _(`None` if it's not tabulated)_.
+    ///
+    /// The absolute deviation is used, since some outputs cross zero within the usual ranges
+    /// _(e.g., specific enthalpy near 0 °C)_.
+    ///
+    /// # Arguments
+    ///
+    /// - `key` -- output parameter
+    #[must_use]
+    pub fn max_error(&self, key: HumidAirParam) -> Option<f64> {
+        self.columns[key as usize].as_ref().map(|column| column.max_error)
+    }
+
+    /// Interpolates the output parameter value at the specified state.
+    ///
+    /// # Arguments
+    ///
+    /// - `key` -- output parameter
+    /// - `pressure` -- pressure **\[Pa\]** _(one of the fixed pressure set)_
+    /// - `input` -- value of the first axis **\[K\]** or **\[J/kg dry air\]**
+    /// - `humidity` -- absolute humidity **\[kg water/kg dry air\]**
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`HumidAirTableError`] if the output parameter is not tabulated,
+    /// the pressure is not in the fixed set or the state is out of range.
+    pub fn output(
+        &self,
+        key: HumidAirParam,
+        pressure: f64,
+        input: f64,
+        humidity: f64,
+    ) -> Result<f64, HumidAirTableError> {
+        let value = self.eval(self.plane(key, pressure)?, input, humidity);
+        if value.is_finite() {
+            Ok(value)
+        } else {
+            Err(HumidAirTableError::OutOfRange(input, humidity))
+        }
+    }
+
+    /// Interpolates the output parameter values at the specified states.
+    ///
+    /// Values at the states out of range are [`f64::NAN`].
+    ///
+    /// # Arguments
+    ///
+    /// - `key` -- output parameter
+    /// - `pressure` -- pressure **\[Pa\]** _(one of the fixed pressure set)_
+    /// - `input` -- values of the first axis **\[K\]** or **\[J/kg dry air\]**
+    /// - `humidity` -- absolute humidity values **\[kg water/kg dry air\]**
+    /// - `out` -- buffer for the output values
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`HumidAirTableError`] if the output parameter is not tabulated
+    /// or the pressure is not in the fixed set.
+    ///
+    /// # Panics
+    ///
+    /// Panics if the lengths of `input`, `humidity` and `out` are not equal.
+    pub fn output_batch(
+        &self,
+        key: HumidAirParam,
+        pressure: f64,
+        input: &[f64],
+        humidity: &[f64],
+        out: &mut [f64],
+    ) -> Result<(), HumidAirTableError> {
+        assert!(
+            input.len() == out.len() && humidity.len() == out.len(),
+            "lengths of inputs and output buffer must be equal"
+        );
+        let plane = self.plane(key, pressure)?;
+        for ((&input, &humidity), out) in input.iter().zip(humidity).zip(out) {
+            *out = self.eval(plane, input, humidity);
+        }
+        Ok(())
+    }
+
+    /// Calculates the output parameter values at the grid nodes for all pressures
+    /// and validates the interpolation at the centers of the grid cells
+    /// _(`None` if `CoolProp` fails at all nodes)_.
+    fn tabulate(&self, key: HumidAirParam) -> Option<Column> {
+        let plane = self.x.len * self.w.len;
+        let mut values = Vec::with_capacity(self.pressures.len() * plane);
+        for &pressure in &self.pressures {
+            for i in 0..self.x.len {
+                for j in 0..self.w.len {
+                    values.push(self.sample(
+                        key,
+                        pressure,
+                        self.x.at(i as f64),
+                        self.w.at(j as f64),
+                    ));
+                }
+            }
+        }
+        if !values.iter().any(|x| x.is_finite()) {
+            return None;
+        }
+        let mut max_error = 0.0_f64;
+        for (&pressure, values) in self.pressures.iter().zip(values.chunks_exact(plane)) {
+            for i in 0..self.x.len - 1 {
+                for j in 0..self.w.len - 1 {
+                    let (input, humidity) = (self.x.at(i as f64 + 0.5), self.w.at(j as f64 + 0.5));
+                    let expected = self.sample(key, pressure, input, humidity);
+                    let value = self.eval(values, input, humidity);
+                    if expected.is_finite() && value.is_finite() {
+                        max_error = max_error.max((value - expected).abs());
+                    }
+                }
+            }
+        }
+        Some(Column { values, max_error })
+    }
+
+    fn sample(&self, key: HumidAirParam, pressure: f64, input: f64, humidity: f64) -> f64 {
+        CoolProp::ha_props_si(
+            key,
+            HumidAirParam::P,
+            pressure,
+            self.axis.key(),
+            input,
+            HumidAirParam::W,
+            humidity,
+        )
+        .unwrap_or(f64::NAN)
+    }
+
+    /// Tabulated values of the output parameter at the pressure of the fixed set.
+    fn plane(&self, key: HumidAirParam, pressure: f64) -> Result<&[f64], HumidAirTableError> {
+        let column =
+            self.columns[key as usize].as_ref().ok_or(HumidAirTableError::NotTabulated(key))?;
+        let index = self
+            .pressures
+            .iter()
+            .position(|p| (p - pressure).abs() <= PRESSURE_TOLERANCE * p)
+            .ok_or(HumidAirTableError::UnsupportedPressure(pressure))?;
+        let plane = self.x.len * self.w.len;
+        Ok(&column.values[index * plane..][..plane])
+    }
+
+    /// Bicubic interpolation of the plane values _(NaN out of range)_.
+    fn eval(&self, plane: &[f64], input: f64, humidity: f64) -> f64 {
+        let (Some((i, u)), Some((j, v))) = (self.x.locate(input), self.w.locate(humidity)) else {
+            return f64::NAN;
+        };
+        let (weights_x, weights_w) = (weights(u), weights(v));
+        let mut value = 0.0;
+        for (k, weight) in weights_x.iter().enumerate() {
+            let row = &plane[(i + k) * self.w.len + j..][..STENCIL];
+            value += weight * row.iter().zip(&weights_w).map(|(f, w)| f * w).sum::<f64>();
+        }
+        value
+    }
+}
+
+/// Error during calculation or evaluation of the [`HumidAirTable`].
+#[derive(Clone, Debug, PartialEq, thiserror::Error)]
+pub enum HumidAirTableError {
+    /// Invalid pressure set, range or number of nodes.
+    #[error("invalid humid air table specification: {0}")]
+    InvalidSpec(String),
+
+    /// `CoolProp` failed to calculate the output parameter at all nodes.
+    #[error("specified output parameter `{0:?}` is not available")]
+    NotAvailable(HumidAirParam),
+
+    /// Output parameter is not tabulated in the [`HumidAirTable`].
+    #[error("specified output parameter `{0:?}` is not tabulated")]
+    NotTabulated(HumidAirParam),
+
+    /// Pressure is not in the fixed set of the [`HumidAirTable`].
+    #[error("pressure {0} Pa is not in the humid air table pressure set")]
+    UnsupportedPressure(f64),
+
+    /// State is out of range of the [`HumidAirTable`].
+    #[error("state ({0}, {1}) is out of the humid air table range")]
+    OutOfRange(f64, f64),
+}
+
+fn invalid_range(name: &str, range: &RangeInclusive<f64>) -> HumidAirTableError {
+    HumidAirTableError::InvalidSpec(format!("invalid {name} range {range:?}"))
+}
+
+/// Uniform grid of the axis.
+#[cfg_attr(feature = "serde", derive(serde::Serialize, serde::Deserialize))]
+#[derive(Clone, Copy, Debug, PartialEq)]
+struct Grid {
+    min: f64,
+    step: f64,
+    len: usize,
+}
+
+impl Grid {
+    /// `None` for invalid range or number of nodes.
+    fn new(range: &RangeInclusive<f64>, len: usize) -> Option<Self> {
+        let (min, max) = (*range.start(), *range.end());
+        (min.is_finite() && max.is_finite() && min < max && len >= STENCIL).then(|| Self {
+            min,
+            step: (max - min) / (len - 1) as f64,
+            len,
+        })
+    }
+
+    fn range(&self) -> RangeInclusive<f64> {
+        self.min..=self.at((self.len - 1) as f64)
+    }
+
+    /// Value at the fractional node index.
+    fn at(&self, index: f64) -> f64 {
+        self.min + self.step * index
+    }
+
+    /// First node of the interpolation stencil and the local coordinate of the value
+    /// relative to it _(`None` if the value is out of range)_.
+    fn locate(&self, value: f64) -> Option<(usize, f64)> {
+        let index = (value - self.min) / self.step;
+        if !(0.0..=(self.len - 1) as f64).contains(&index) {
+            return None;
+        }
+        let first = (index as usize).saturating_sub(1).min(self.len - STENCIL);
+        Some((first, index - first as f64))
+    }
+}
+
+/// Cubic Lagrange weights of the stencil nodes at the local coordinate.
+fn weights(u: f64) -> [f64; STENCIL] {
+    let (a, b, c, d) = (u, u - 1.0, u - 2.0, u - 3.0);
+    [-b * c * d / 6.0, a * c * d / 2.0, -a * b * d / 2.0, a * b * c / 6.0]
+}
+
+/// Tabulated values of the output parameter _(pressure-major, then the first axis)_.
+#[cfg_attr(feature = "serde", derive(serde::Serialize, serde::Deserialize))]
+#[derive(Clone, Debug, PartialEq)]
+struct Column {
+    values: Vec<f64>,
+    max_error: f64,
+}
+
+#[cfg(test)]
+mod tests {
+    use std::{sync::Arc, thread};
+
+    use rstest::*;
+
+    use super::*;
+
+    const PRESSURE: f64 = 101_325.0;
+
+    const OUTPUTS: [HumidAirParam; 4] =
+        [HumidAirParam::Hha, HumidAirParam::R, HumidAirParam::Vda, HumidAirParam::TWetBulb];
+
+    fn table() -> HumidAirTable {
+        HumidAirTable::builder()
+            .pressures([PRESSURE, 90e3])
+            .range(278.15..=318.15)
+            .humidity(0.0..=0.005)
+            .outputs(OUTPUTS)
+            .nodes((21, 11))
+            .build()
+            .unwrap()
+    }
+
+    fn expected(
+        key: HumidAirParam,
+        pressure: f64,
+        input: HumidAirParam,
+        value: f64,
+        w: f64,
+    ) -> f64 {
+        CoolProp::ha_props_si(key, "P", pressure, input, value, "W", w).unwrap()
+    }
+
+    #[rstest]
+    #[case(PRESSURE)]
+    #[case(90e3)]
+    fn output_matches_humid_air(#[case] pressure: f64) {
+        // Given
+        let sut = table();
+
+        for (temperature, humidity) in [(280.0, 0.001), (293.15, 0.003), (310.0, 0.0045)] {
+            for key in OUTPUTS {
+                // When
+                let res = sut.output(key, pressure, temperature, humidity).unwrap();
+
+                // Then
+                approx::assert_relative_eq!(
+                    res,
+                    expected(key, pressure, HumidAirParam::T, temperature, humidity),
+                    max_relative = 1e-5
+                );
+            }
+        }
+    }
+
+    #[test]
+    fn output_enthalpy_axis() {
+        // Given
+        let sut = HumidAirTable::builder()
+            .axis(HumidAirTableAxis::Enthalpy)
+            .range(10e3..=50e3)
+            .humidity(0.001..=0.005)
+            .outputs([HumidAirParam::T])
+            .nodes((9, 5))
+            .build()
+            .unwrap();
+
+        // When
+        let res = sut.output(HumidAirParam::T, PRESSURE, 30e3, 0.003).unwrap();
+
+        // Then
+        approx::assert_relative_eq!(
+            res,
+            expected(HumidAirParam::T, PRESSURE, HumidAirParam::Hda, 30e3, 0.003),
+            max_relative = 1e-5
+        );
+        assert_eq!(sut.axis().key(), HumidAirParam::Hda);
+    }
+
+    #[test]
+    fn max_error() {
+        // Given
+        let sut = table();
+
+        // When
+        let res = sut.max_error(HumidAirParam::Hha);
+
+        // Then
+        assert!(res.unwrap() < 1.0);
+        assert!(sut.max_error(HumidAirParam::R).unwrap() < 1e-5);
+        assert_eq!(sut.max_error(HumidAirParam::Cpha), None);
+        assert_eq!(
+            sut.outputs().collect::<Vec<_>>(),
+            vec![HumidAirParam::TWetBulb, HumidAirParam::Hha, HumidAirParam::R, HumidAirParam::Vda]
+        );
+    }
+
+    #[rstest]
+    #[case(
+        HumidAirParam::Cpha,
+        PRESSURE,
+        293.15,
+        0.003,
+        HumidAirTableError::NotTabulated(HumidAirParam::Cpha)
+    )]
+    #[case(HumidAirParam::Hha, 95e3, 293.15, 0.003, HumidAirTableError::UnsupportedPressure(95e3))]
+    #[case(
+        HumidAirParam::Hha,
+        PRESSURE,
+        273.15,
+        0.003,
+        HumidAirTableError::OutOfRange(273.15, 0.003)
+    )]
+    #[case(
+        HumidAirParam::Hha,
+        PRESSURE,
+        293.15,
+        0.01,
+        HumidAirTableError::OutOfRange(293.15, 0.01)
+    )]
+    fn output_invalid(
+        #[case] key: HumidAirParam,
+        #[case] pressure: f64,
+        #[case] input: f64,
+        #[case] humidity: f64,
+        #[case] expected: HumidAirTableError,
+    ) {
+        // Given
+        let sut = table();
+
+        // When
+        let res = sut.output(key, pressure, input, humidity);
+
+        // Then
+        assert_eq!(res, Err(expected));
+    }
+
+    #[test]
+    fn output_batch_matches_output() {
+        // Given
+        let sut = table();
+        let temperature: Vec<f64> = (0..9_u32).map(|k| 278.15 + 5.0 * f64::from(k)).collect();
+        let mut humidity = vec![0.0025; temperature.len()];
+        humidity[3] = f64::NAN;
+        let mut res = vec![0.0; temperature.len()];
+
+        // When
+        sut.output_batch(HumidAirParam::Hha, PRESSURE, &temperature, &humidity, &mut res).unwrap();
+
+        // Then
+        for ((&t, &w), &res) in temperature.iter().zip(&humidity).zip(&res) {
+            match sut.output(HumidAirParam::Hha, PRESSURE, t, w) {
+                Ok(expected) => assert_eq!(res, expected),
+                Err(_) => assert!(res.is_nan()),
+            }
+        }
+        assert!(res[3].is_nan());
+    }
+
+    #[test]
+    fn shared_between_threads() {
+        // Given
+        let sut = Arc::new(table());
+        let expected = sut.output(HumidAirParam::Hha, PRESSURE, 293.15, 0.003).unwrap();
+
+        // When
+        let res = thread::scope(|s| {
+            let handles: Vec<_> = (0..4)
+                .map(|_| {
+                    let sut = Arc::clone(&sut);
+                    s.spawn(move || sut.output(HumidAirParam::Hha, PRESSURE, 293.15, 0.003))
+                })
+                .collect();
+            handles.into_iter().map(|h| h.join().unwrap().unwrap()).collect::<Vec<_>>()
+        });
+
+        // Then
+        assert!(res.iter().all(|&x| x == expected));
+    }
+
+    #[rstest]
+    #[case(vec![], 278.15..=318.15, 0.0..=0.005, (21, 11))]
+    #[case(vec![-1.0], 278.15..=318.15, 0.0..=0.005, (21, 11))]
+    #[case(vec![PRESSURE], 0.0..=318.15, 0.0..=0.005, (21, 11))]
+    #[case(vec![PRESSURE], 318.15..=278.15, 0.0..=0.005, (21, 11))]
+    #[case(vec![PRESSURE], 278.15..=318.15, -0.001..=0.005, (21, 11))]
+    #[case(vec![PRESSURE], 278.15..=318.15, 0.0..=0.005, (3, 11))]
+    fn new_invalid_spec(
+        #[case] pressures: Vec<f64>,
+        #[case] range: RangeInclusive<f64>,
+        #[case] humidity: RangeInclusive<f64>,
+        #[case] nodes: (usize, usize),
+    ) {
+        // When
+        let res = HumidAirTable::builder()
+            .pressures(pressures)
+            .range(range)
+            .humidity(humidity)
+            .outputs(OUTPUTS)
+            .nodes(nodes)
+            .build();
+
+        // Then
+        assert!(matches!(res, Err(HumidAirTableError::InvalidSpec(_))));
+    }
+
+    #[test]
+    fn weights_interpolate_cubic_exactly() {
+        // Given
+        let cubic = |x: f64| 1.0 - 2.0 * x + 0.5 * x.powi(2) - 0.25 * x.powi(3);
+
+        for u in [0.0, 0.3, 1.0, 1.7, 2.5, 3.0] {
+            // When
+            let res: f64 = weights(u).iter().enumerate().map(|(k, w)| w * cubic(k as f64)).sum();
+
+            // Then
+            approx::assert_relative_eq!(res, cubic(u), epsilon = 1e-12);
+        }
+    }
+}
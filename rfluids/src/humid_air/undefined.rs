@@ -1,13 +1,13 @@
-use std::{collections::HashMap, marker::PhantomData};
+use std::marker::PhantomData;
 
-use super::{HumidAir, StateResult};
+use super::{HumidAir, StateResult, common::Outputs};
 use crate::{io::HumidAirInput, state_variant::Undefined};
 
 impl HumidAir<Undefined> {
     /// Creates and returns a new [`HumidAir`] instance with [`Undefined`] state variant.
     #[must_use]
     pub fn new() -> Self {
-        HumidAir { update_request: None, outputs: HashMap::new(), state: PhantomData }
+        HumidAir { update_request: None, outputs: Outputs::new(), state: PhantomData }
     }
 
     /// Updates the thermodynamic state and returns itself with
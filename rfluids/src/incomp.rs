@@ -0,0 +1,533 @@
+//! Native evaluation of the incompressible substances correlations.
+//!
+//! `CoolProp` describes properties of incompressible substances
+//! _(e.g., [`IncompPure`](crate::substance::IncompPure)
+//! or [`BinaryMix`](crate::substance::BinaryMix))_ by simple polynomial or exponential
+//! correlations in temperature, but each call still goes through the FFI and the native handle.
+//! [`IncompCorrelation`] recovers these correlations once and evaluates them entirely in Rust,
+//! which is suitable for tight loops _(e.g., glycol loop simulations)_.
+//!
+//! # Examples
+//!
+//! ```
+//! use approx::assert_relative_eq;
+//! use rfluids::{incomp::IncompCorrelation, prelude::*};
+//!
+//! let propylene_glycol = BinaryMixKind::MPG.with_fraction(0.4)?;
+//! let correlation = IncompCorrelation::builder().substance(propylene_glycol).build()?;
+//!
+//! let mut fluid = Fluid::from(propylene_glycol)
+//!     .in_state(FluidInput::pressure(101_325.0), FluidInput::temperature(283.15))?;
+//! assert_relative_eq!(
+//!     correlation.output(FluidParam::DMass, 283.15)?,
+//!     fluid.density()?,
+//!     max_relative = 1e-9
+//! );
+//!
+//! let temperatures = [273.15, 283.15, 293.15];
+//! let mut viscosities = [0.0; 3];
+//! correlation.output_batch(FluidParam::DynamicViscosity, &temperatures, &mut viscosities)?;
+//! assert!(viscosities.windows(2).all(|x| x[0] > x[1]));
+//! # Ok::<(), rfluids::Error>(())
+//! ```
+
+use std::ops::RangeInclusive;
+
+use crate::{
+    chebyshev,
+    fluid::backend::{Backend, BaseBackend},
+    io::{FluidInputPair, FluidParam, FluidTrivialParam},
+    native::{AbstractState, CoolPropError, composition},
+    substance::Substance,
+};
+
+/// Default number of collocation nodes.
+const DEFAULT_NODES: usize = 24;
+
+/// Default output parameters.
+const DEFAULT_OUTPUTS: [FluidParam; 4] =
+    [FluidParam::DMass, FluidParam::CpMass, FluidParam::Conductivity, FluidParam::DynamicViscosity];
+
+/// Pressure at which the correlations are recovered **\[Pa\]**.
+const REFERENCE_PRESSURE: f64 = 101_325.0;
+
+/// Number of points evaluated together by [`IncompCorrelation::output_batch`].
+const LANES: usize = 8;
+
+/// Correlations of the incompressible substance properties in temperature
+/// evaluated entirely in Rust.
+///
+/// On creation, the properties are calculated by `CoolProp` at the Chebyshev nodes over the
+/// temperature range, and the Chebyshev series is fitted to the values _(or to their logarithms
+/// for exponential correlations, e.g., of the viscosity)_. Polynomial correlations of lower degree
+/// than the number of nodes are reproduced exactly, and the fit is validated against `CoolProp`
+/// between the nodes _(see [`IncompCorrelation::max_relative_error`])_.
+///
+/// The correlations are recovered at the reference pressure _(101 325 Pa)_ and for the fraction
+/// of the [`BinaryMix`](crate::substance::BinaryMix) specified on creation,
+/// so outputs which depend on pressure _(e.g., specific enthalpy)_ are valid at this pressure only.
+///
+/// # Examples
+///
+/// See the [module-level documentation](crate::incomp).
+#[derive(Clone, Debug, PartialEq)]
+pub struct IncompCorrelation {
+    temperature: RangeInclusive<f64>,
+    columns: Vec<(FluidParam, Series)>,
+}
+
+#[bon::bon]
+impl IncompCorrelation {
+    /// Recovers a new [`IncompCorrelation`].
+    ///
+    /// # Arguments
+    ///
+    /// - `substance` -- incompressible substance _([`IncompPure`](crate::substance::IncompPure)
+    ///   or [`BinaryMix`](crate::substance::BinaryMix))_
+    /// - `outputs` -- output parameters _(density, specific heat, thermal conductivity
+    ///   and dynamic viscosity by default)_
+    /// - `temperature` -- temperature range **\[K\]** _(from the freezing or minimum temperature
+    ///   to the maximum temperature of the substance by default)_
+    /// - `nodes` -- number of collocation nodes _(at least 2, default 24)_
+    ///
+    /// # Errors
+    ///
+    /// Returns an [`IncompError`] if the substance is not incompressible, for invalid range
+    /// or if `CoolProp` fails to calculate the properties.
+    #[builder]
+    pub fn new(
+        /// Incompressible substance.
+        #[builder(into)]
+        substance: Substance,
+        /// Output parameters.
+        #[builder(into, default = DEFAULT_OUTPUTS.to_vec())]
+        outputs: Vec<FluidParam>,
+        /// Temperature range **\[K\]**.
+        temperature: Option<RangeInclusive<f64>>,
+        /// Number of collocation nodes _(at least 2)_.
+        #[builder(default = DEFAULT_NODES)]
+        nodes: usize,
+    ) -> Result<Self, IncompError> {
+        if !matches!(substance, Substance::IncompPure(_) | Substance::BinaryMix(_)) {
+            return Err(IncompError::NotIncompressible(substance.name().into_owned()));
+        }
+        let failed =
+            |e| IncompError::Failed { substance: substance.name().into_owned(), source: e };
+        let mut state = native_state(&substance).map_err(failed)?;
+        let temperature = match temperature {
+            Some(range) => range,
+            None => default_range(&state).map_err(failed)?,
+        };
+        let (min, max) = (*temperature.start(), *temperature.end());
+        if !(min.is_finite() && max.is_finite() && 0.0 < min && min < max) {
+            return Err(IncompError::InvalidRange(format!(
+                "invalid temperature range {min}..={max}"
+            )));
+        }
+        if nodes < 2 {
+            return Err(IncompError::InvalidRange(format!("{nodes} nodes (at least 2 expected)")));
+        }
+        let scale = Scale::new(&temperature);
+        // Zeros of the Chebyshev polynomial of degree `nodes` are the collocation nodes,
+        // and its extrema between them are the check points
+        let node = |k: f64| scale.temperature(chebyshev::node(k, nodes));
+        let values =
+            sample(&mut state, &outputs, (0..nodes).map(|k| node(k as f64))).map_err(failed)?;
+        let checks: Vec<f64> = (0..nodes - 1).map(|k| node(k as f64 + 0.5)).collect();
+        let expected = sample(&mut state, &outputs, checks.iter().copied()).map_err(failed)?;
+        let columns = outputs
+            .into_iter()
+            .zip(values.iter().zip(&expected))
+            .map(|(param, (values, expected))| {
+                Series::fit(values, &scale, &checks, expected)
+                    .map(|series| (param, series))
+                    .ok_or(IncompError::NotAvailable(param))
+            })
+            .collect::<Result<_, _>>()?;
+        Ok(Self { temperature, columns })
+    }
+}
+
+impl IncompCorrelation {
+    /// Valid temperature range **\[K\]**.
+    #[must_use]
+    pub fn temperature(&self) -> RangeInclusive<f64> {
+        self.temperature.clone()
+    }
+
+    /// Recovered output parameters.
+    pub fn outputs(&self) -> impl Iterator<Item = FluidParam> + '_ {
+        self.columns.iter().map(|(param, _)| *param)
+    }
+
+    /// Maximum relative deviation of the output parameter from the `CoolProp` values
+    /// between the collocation nodes _(`None` if it's not recovered)_.
+    ///
+    /// # Arguments
+    ///
+    /// - `param` -- output parameter
+    #[must_use]
+    pub fn max_relative_error(&self, param: FluidParam) -> Option<f64> {
+        self.series(param).ok().map(|series| series.max_relative_error)
+    }
+
+    /// Evaluates the output parameter value at the specified temperature.
+    ///
+    /// # Arguments
+    ///
+    /// - `param` -- output parameter
+    /// - `temperature` -- temperature **\[K\]**
+    ///
+    /// # Errors
+    ///
+    /// Returns an [`IncompError`] if the output parameter is not recovered
+    /// or the temperature is out of range.
+    pub fn output(&self, param: FluidParam, temperature: f64) -> Result<f64, IncompError> {
+        let [value] = self.eval(self.series(param)?, &[temperature]);
+        if value.is_finite() { Ok(value) } else { Err(IncompError::OutOfRange(temperature)) }
+    }
+
+    /// Evaluates the output parameter values at the specified temperatures.
+    ///
+    /// Temperatures are processed in fixed-size chunks with branch-free evaluation of the series
+    /// over lane arrays, which the compiler maps to SIMD instructions of the target.
+    /// Values at the temperatures out of range are [`f64::NAN`].
+    ///
+    /// # Arguments
+    ///
+    /// - `param` -- output parameter
+    /// - `temperature` -- temperatures **\[K\]**
+    /// - `out` -- buffer for the output values
+    ///
+    /// # Errors
+    ///
+    /// Returns an [`IncompError`] if the output parameter is not recovered.
+    ///
+    /// # Panics
+    ///
+    /// Panics if the lengths of `temperature` and `out` are not equal.
+    pub fn output_batch(
+        &self,
+        param: FluidParam,
+        temperature: &[f64],
+        out: &mut [f64],
+    ) -> Result<(), IncompError> {
+        assert!(
+            temperature.len() == out.len(),
+            "lengths of inputs and output buffer must be equal"
+        );
+        let series = self.series(param)?;
+        let mut t_chunks = temperature.chunks_exact(LANES);
+        let mut out_chunks = out.chunks_exact_mut(LANES);
+        for (t, out) in t_chunks.by_ref().zip(out_chunks.by_ref()) {
+            out.copy_from_slice(&self.eval(series, t.try_into().unwrap()));
+        }
+        for (&t, out) in t_chunks.remainder().iter().zip(out_chunks.into_remainder()) {
+            *out = self.eval(series, &[t])[0];
+        }
+        Ok(())
+    }
+
+    fn series(&self, param: FluidParam) -> Result<&Series, IncompError> {
+        self.columns
+            .iter()
+            .find(|(p, _)| *p == param)
+            .map(|(_, series)| series)
+            .ok_or(IncompError::NotRecovered(param))
+    }
+
+    fn eval<const L: usize>(&self, series: &Series, t: &[f64; L]) -> [f64; L] {
+        let scale = Scale::new(&self.temperature);
+        let x = t.map(|t| scale.x(t));
+        let mut value = series.eval(&x);
+        for lane in 0..L {
+            if !self.temperature.contains(&t[lane]) {
+                value[lane] = f64::NAN;
+            }
+        }
+        value
+    }
+}
+
+/// Error during recovery or evaluation of the [`IncompCorrelation`].
+#[derive(Clone, Debug, PartialEq, thiserror::Error)]
+pub enum IncompError {
+    /// Specified substance is not incompressible.
+    #[error("`{0}` is not an incompressible substance")]
+    NotIncompressible(String),
+
+    /// Invalid temperature range or number of nodes.
+    #[error("invalid correlation range: {0}")]
+    InvalidRange(String),
+
+    /// `CoolProp` failed to calculate the properties of the substance.
+    #[error("failed to calculate properties of `{substance}`: {source}")]
+    Failed {
+        /// Substance name.
+        substance: String,
+        /// `CoolProp` error.
+        source: CoolPropError,
+    },
+
+    /// Output parameter is not available for the substance.
+    #[error("specified output parameter `{0:?}` is not available")]
+    NotAvailable(FluidParam),
+
+    /// Output parameter is not recovered in the [`IncompCorrelation`].
+    #[error("specified output parameter `{0:?}` is not recovered")]
+    NotRecovered(FluidParam),
+
+    /// Temperature is out of range of the [`IncompCorrelation`].
+    #[error("temperature {0} K is out of the correlation range")]
+    OutOfRange(f64),
+}
+
+/// Linear mapping of the temperature range onto `[-1, 1]`.
+#[derive(Clone, Copy, Debug)]
+struct Scale {
+    mid: f64,
+    half: f64,
+}
+
+impl Scale {
+    fn new(range: &RangeInclusive<f64>) -> Self {
+        Self { mid: 0.5 * (range.start() + range.end()), half: 0.5 * (range.end() - range.start()) }
+    }
+
+    fn x(self, temperature: f64) -> f64 {
+        (temperature - self.mid) / self.half
+    }
+
+    fn temperature(self, x: f64) -> f64 {
+        self.mid + self.half * x
+    }
+}
+
+/// Chebyshev series of the output parameter _(or its logarithm)_.
+#[derive(Clone, Debug, PartialEq)]
+struct Series {
+    coefficients: Vec<f64>,
+    log: bool,
+    max_relative_error: f64,
+}
+
+impl Series {
+    /// Fits the series to the values at the Chebyshev nodes
+    /// and keeps the more accurate of the direct and logarithmic ones
+    /// _(`None` if the values are not finite)_.
+    fn fit(values: &[f64], scale: &Scale, checks: &[f64], expected: &[f64]) -> Option<Self> {
+        if !values.iter().chain(expected).all(|x| x.is_finite()) {
+            return None;
+        }
+        let direct = Self::new(values, false, scale, checks, expected);
+        if !values.iter().all(|&x| x > 0.0) {
+            return Some(direct);
+        }
+        let logs: Vec<f64> = values.iter().map(|x| x.ln()).collect();
+        let log = Self::new(&logs, true, scale, checks, expected);
+        Some(if log.max_relative_error < direct.max_relative_error { log } else { direct })
+    }
+
+    fn new(values: &[f64], log: bool, scale: &Scale, checks: &[f64], expected: &[f64]) -> Self {
+        let coefficients = chebyshev::coefficients(values);
+        let mut series = Self { coefficients, log, max_relative_error: 0.0 };
+        series.max_relative_error = checks
+            .iter()
+            .zip(expected)
+            .map(|(&t, &expected)| {
+                let [value] = series.eval(&[scale.x(t)]);
+                ((value - expected) / expected).abs()
+            })
+            .fold(0.0, f64::max);
+        series
+    }
+
+    fn eval<const L: usize>(&self, x: &[f64; L]) -> [f64; L] {
+        let value = chebyshev::eval(self.coefficients.len(), x, |_, j| self.coefficients[j]);
+        if self.log { value.map(f64::exp) } else { value }
+    }
+}
+
+fn native_state(substance: &Substance) -> Result<AbstractState, CoolPropError> {
+    let (composition_id, fractions) = composition(substance);
+    let mut state = AbstractState::new(Backend::Base(BaseBackend::Incomp).name(), composition_id)?;
+    if let Some(fractions) = fractions {
+        state.set_fractions(&fractions)?;
+    }
+    Ok(state)
+}
+
+/// Default temperature range _(from the freezing or minimum temperature
+/// to the maximum temperature)_.
+fn default_range(state: &AbstractState) -> Result<RangeInclusive<f64>, CoolPropError> {
+    let min = state.keyed_output(FluidTrivialParam::TMin)?;
+    let max = state.keyed_output(FluidTrivialParam::TMax)?;
+    let freeze =
+        state.keyed_output(FluidTrivialParam::TFreeze).ok().filter(|x| x.is_finite() && *x > 0.0);
+    Ok(freeze.map_or(min, |freeze| freeze.max(min))..=max)
+}
+
+/// Calculates the output parameter values at the specified temperatures
+/// _(one column per output parameter)_.
+fn sample(
+    state: &mut AbstractState,
+    outputs: &[FluidParam],
+    temperatures: impl Iterator<Item = f64>,
+) -> Result<Vec<Vec<f64>>, CoolPropError> {
+    let mut values = vec![Vec::new(); outputs.len()];
+    for temperature in temperatures {
+        state.update(FluidInputPair::PT, REFERENCE_PRESSURE, temperature)?;
+        for (column, &param) in values.iter_mut().zip(outputs) {
+            column.push(state.keyed_output(param).unwrap_or(f64::NAN));
+        }
+    }
+    Ok(values)
+}
+
+#[cfg(test)]
+mod tests {
+    use rstest::*;
+
+    use super::*;
+    use crate::substance::{BinaryMixKind, IncompPure, Pure};
+
+    fn propylene_glycol() -> IncompCorrelation {
+        IncompCorrelation::builder()
+            .substance(BinaryMixKind::MPG.with_fraction(0.4).unwrap())
+            .build()
+            .unwrap()
+    }
+
+    #[rstest]
+    #[case(BinaryMixKind::MPG.with_fraction(0.4).unwrap().into())]
+    #[case(BinaryMixKind::MEG.with_fraction(0.3).unwrap().into())]
+    #[case(IncompPure::DowQ.into())]
+    fn output_matches_backend(#[case] substance: Substance) {
+        // Given
+        let sut = IncompCorrelation::builder().substance(substance.clone()).build().unwrap();
+        let mut expected = native_state(&substance).unwrap();
+        let (min, max) = (*sut.temperature().start(), *sut.temperature().end());
+
+        for k in 0..10_u32 {
+            let temperature = min + (max - min) * (f64::from(k) + 0.5) / 10.0;
+            expected.update(FluidInputPair::PT, REFERENCE_PRESSURE, temperature).unwrap();
+            for param in DEFAULT_OUTPUTS {
+                // When
+                let res = sut.output(param, temperature).unwrap();
+
+                // Then
+                approx::assert_relative_eq!(
+                    res,
+                    expected.keyed_output(param).unwrap(),
+                    max_relative = 1e-6
+                );
+                assert!(sut.max_relative_error(param).unwrap() < 1e-6);
+            }
+        }
+    }
+
+    #[test]
+    fn polynomial_correlation_is_exact() {
+        // Given
+        let sut = propylene_glycol();
+
+        // When
+        let res = sut.max_relative_error(FluidParam::DMass).unwrap();
+
+        // Then
+        assert!(res < 1e-12);
+    }
+
+    #[rstest]
+    #[case(f64::NAN)]
+    #[case(100.0)]
+    #[case(1000.0)]
+    fn output_out_of_range(#[case] temperature: f64) {
+        // Given
+        let sut = propylene_glycol();
+
+        // When
+        let res = sut.output(FluidParam::DMass, temperature);
+
+        // Then
+        assert!(matches!(res, Err(IncompError::OutOfRange(_))));
+    }
+
+    #[test]
+    fn output_not_recovered() {
+        // Given
+        let sut = propylene_glycol();
+
+        // When
+        let res = sut.output(FluidParam::Prandtl, 293.15);
+
+        // Then
+        assert_eq!(res, Err(IncompError::NotRecovered(FluidParam::Prandtl)));
+        assert_eq!(sut.max_relative_error(FluidParam::Prandtl), None);
+    }
+
+    #[test]
+    fn output_batch_matches_output() {
+        // Given
+        let sut = propylene_glycol();
+        let mut temperature: Vec<f64> = (0..11_u32).map(|k| 263.15 + 5.0 * f64::from(k)).collect();
+        temperature[3] = 1000.0;
+        let mut res = vec![0.0; temperature.len()];
+
+        // When
+        sut.output_batch(FluidParam::DynamicViscosity, &temperature, &mut res).unwrap();
+
+        // Then
+        for (&t, &res) in temperature.iter().zip(&res) {
+            match sut.output(FluidParam::DynamicViscosity, t) {
+                Ok(expected) => assert_eq!(res, expected),
+                Err(_) => assert!(res.is_nan()),
+            }
+        }
+        assert!(res[3].is_nan());
+    }
+
+    #[test]
+    fn outputs() {
+        // Given
+        let sut = IncompCorrelation::builder()
+            .substance(IncompPure::DowQ)
+            .outputs([FluidParam::CpMass])
+            .temperature(300.0..=350.0)
+            .build()
+            .unwrap();
+
+        // When
+        let res: Vec<FluidParam> = sut.outputs().collect();
+
+        // Then
+        assert_eq!(res, vec![FluidParam::CpMass]);
+        assert_eq!(sut.temperature(), 300.0..=350.0);
+    }
+
+    #[test]
+    fn new_not_incompressible() {
+        // When
+        let res = IncompCorrelation::builder().substance(Pure::Water).build();
+
+        // Then
+        assert_eq!(res, Err(IncompError::NotIncompressible("Water".into())));
+    }
+
+    #[rstest]
+    #[case(350.0..=300.0, 10)]
+    #[case(0.0..=300.0, 10)]
+    #[case(300.0..=f64::INFINITY, 10)]
+    #[case(300.0..=350.0, 1)]
+    fn new_invalid_range(#[case] temperature: RangeInclusive<f64>, #[case] nodes: usize) {
+        // When
+        let res = IncompCorrelation::builder()
+            .substance(IncompPure::DowQ)
+            .temperature(temperature)
+            .nodes(nodes)
+            .build();
+
+        // Then
+        assert!(matches!(res, Err(IncompError::InvalidRange(_))));
+    }
+}
@@ -23,7 +23,8 @@ use super::FluidParam;
 /// );
 /// assert_eq!(FluidInputPair::try_from((FluidParam::T, FluidParam::P)), Ok(FluidInputPair::PT));
 /// ```
-#[derive(Clone, Copy, Debug, Eq, PartialEq)]
+#[derive(Clone, Copy, Debug, Eq, PartialEq, strum_macros::FromRepr)]
+#[repr(u8)]
 pub enum FluidInputPair {
     /// Vapor quality **\[dimensionless, from 0 to 1\]**, temperature **\[K\]**.
     QT = 1,
@@ -34,17 +34,37 @@
 //! - [`fluid`](crate::fluid) -- thermophysical properties of substances (pure fluids and mixtures)
 //! - [`humid_air`](crate::humid_air) -- thermophysical properties of _**real**_ humid air
 //! - [`substance`](crate::substance) -- types representing `CoolProp` substances
+//! - [`incomp`](crate::incomp) -- native evaluation of the incompressible substances
+//!   correlations
+//! - [`saturation`](crate::saturation) -- native evaluation of the saturation curves of pure
+//!   substances
 //! - [`io`](crate::io) -- input/output parameter types for fluid and humid air calculations
+//! - [`sweep`](crate::sweep) -- parallel property maps and parameter sweeps
 //! - [`native`](crate::native) -- low-level and high-level `CoolProp` API bindings
 //! - [`config`](crate::config) -- global configuration management for `CoolProp`
+//! - [`tabular`](crate::tabular) -- ahead-of-time generation and loading of `CoolProp` tabular data
+//! - [`warmup`](crate::warmup()) -- startup preloading of the `CoolProp` library, fluid data
+//!   and tabular backends
+//! - `metrics` -- opt-in instrumentation of the `CoolProp` FFI traffic _(requires the **`metrics`**
+//!   feature)_
 //! - [`prelude`](crate::prelude) -- convenient re-exports of commonly used types and traits
 //!
 //! ### Feature Flags
 //!
+//! - **`async`** -- enables `AsyncFluidPool` for evaluating [`Fluid`](crate::fluid::Fluid)
+//!   properties from async code on dedicated worker threads _(runtime-agnostic)_
 //! - **`regen-bindings`** -- regenerates FFI bindings to `CoolProp` (requires `libclang`)
+//! - **`static`** -- builds `CoolProp` from source and links it statically instead of loading
+//!   the bundled dynamic library at runtime _(see the `coolprop-sys` documentation)_
 //! - **`serde`** -- enables serialization and deserialization support for
 //!   [`Config`](crate::config::Config), allowing integration with configuration management crates
-//!   and file-based configuration
+//!   and file-based configuration, and for [`HumidAirTable`](crate::humid_air::HumidAirTable),
+//!   allowing to store the tabulated humid air properties on disk
+//! - **`metrics`** -- enables process-wide counters and latency histograms of the `CoolProp` FFI
+//!   calls, the `CoolProp` locks wait time, the [`Fluid`](crate::fluid::Fluid) outputs cache
+//!   and failed flash calculations, available via `rfluids::metrics::snapshot()`
+//! - **`tracing`** -- wraps each `CoolProp` FFI call into a [`tracing`](https://docs.rs/tracing)
+//!   span at the `TRACE` level
 //!
 //! ## Supported platforms
 //!
@@ -232,18 +252,30 @@
     clippy::large_stack_arrays
 )]
 
+mod cache;
+mod chebyshev;
 pub mod config;
 mod error;
 pub mod fluid;
 pub mod humid_air;
+pub mod incomp;
 pub mod io;
+#[cfg(feature = "metrics")]
+pub mod metrics;
+#[cfg(not(feature = "metrics"))]
+mod metrics;
 pub mod native;
 mod ops;
 pub mod prelude;
+pub mod saturation;
 mod state_variant;
 pub mod substance;
+pub mod sweep;
+pub mod tabular;
 #[cfg(test)]
 mod test;
+mod warmup;
 
 pub use error::*;
 pub use state_variant::*;
+pub use warmup::{WarmupError, WarmupReport, WarmupReportEntry, warmup};
@@ -0,0 +1,490 @@
+//! Opt-in instrumentation of the `CoolProp` FFI traffic _(requires the **`metrics`** feature)_.
+//!
+//! When enabled, the library records:
+//!
+//! - number of calls and latency histogram per FFI entry point
+//!   _(e.g., `AbstractState_update` or `AbstractState_keyed_output`)_
+//! - time spent waiting for the lock of the `CoolProp` high-level API and
+//!   for the shared _(per-handle calls)_ and exclusive _(creation and release of native handles)_
+//!   locks of the `CoolProp` low-level API handles _(see [`Lock`])_
+//! - hits and misses of the [`Fluid`](crate::fluid::Fluid) outputs cache
+//! - failed flash calculations of the [`Fluid`](crate::fluid::Fluid) per input pair
+//!
+//! All counters are process-wide and lock-free on the hot paths.
+//! Use [`snapshot`] to read them and [`reset`] to start over.
+//! If the feature is disabled, recording compiles to nothing.
+//!
+//! With the **`tracing`** feature, each FFI call is also wrapped into
+//! a `tracing` span at the `TRACE` level named `coolprop` with the `entry` field.
+//!
+//! # Examples
+//!
+//! ```
+//! # #[cfg(feature = "metrics")] {
+//! use rfluids::{metrics, prelude::*};
+//!
+//! let mut water = AbstractState::new("HEOS", "Water")?;
+//! water.update(FluidInputPair::PT, 101_325.0, 293.15)?;
+//! let snapshot = metrics::snapshot();
+//! let update = snapshot.ffi_call("AbstractState_update").unwrap();
+//! assert!(update.calls >= 1);
+//! # }
+//! # Ok::<(), rfluids::Error>(())
+//! ```
+
+// Recording hooks are always compiled, but they are no-ops without the `metrics` feature
+#![cfg_attr(not(feature = "metrics"), allow(dead_code, unused_imports, unused_macros))]
+
+#[cfg(feature = "metrics")]
+use std::{
+    sync::{
+        Mutex,
+        atomic::{AtomicBool, AtomicU64, Ordering},
+    },
+    time::Duration,
+};
+
+use crate::io::FluidInputPair;
+
+/// Number of buckets of the latency histograms.
+///
+/// Bucket `i` counts calls that took from `2^(i - 1)` _(exclusive)_ to `2^i` _(inclusive)_
+/// nanoseconds, and the last bucket also counts all longer calls.
+pub const HISTOGRAM_BUCKETS: usize = 40;
+
+/// Runs the FFI call, recording its count and latency for the specified entry point
+/// _(with the `metrics` feature)_ and wrapping it into a `tracing` span
+/// _(with the `tracing` feature)_.
+macro_rules! ffi {
+    ($entry:literal, $call:expr) => {{
+        #[cfg(feature = "tracing")]
+        let _span = tracing::trace_span!("coolprop", entry = $entry).entered();
+        #[cfg(feature = "metrics")]
+        let (entry, start) = {
+            static ENTRY: $crate::metrics::Entry = $crate::metrics::Entry::new($entry);
+            (&ENTRY, std::time::Instant::now())
+        };
+        let res = $call;
+        #[cfg(feature = "metrics")]
+        entry.record(start.elapsed());
+        res
+    }};
+}
+
+pub(crate) use ffi;
+
+/// Lock of the `CoolProp` API, whose wait time is recorded.
+#[cfg(feature = "metrics")]
+#[derive(Clone, Copy, Debug, Eq, Hash, PartialEq)]
+pub enum Lock {
+    /// Lock of the `CoolProp` high-level API.
+    HighLevelApi,
+
+    /// Shared lock of the `CoolProp` low-level API handles,
+    /// acquired by each call on the existing native handle.
+    HandlesRead,
+
+    /// Exclusive lock of the `CoolProp` low-level API handles,
+    /// acquired on creation and release of native handles and on configuration changes.
+    HandlesWrite,
+}
+
+/// Records the time spent waiting for the lock of the `CoolProp` API.
+#[cfg(feature = "metrics")]
+#[inline]
+pub(crate) fn record_lock_wait(lock: Lock, elapsed: Duration) {
+    let counters = &LOCK_WAITS[lock as usize];
+    counters.wait_nanos.fetch_add(nanos(elapsed), Ordering::Relaxed);
+    counters.acquisitions.fetch_add(1, Ordering::Relaxed);
+}
+
+/// Records the hit _(`true`)_ or miss _(`false`)_ of the [`Fluid`](crate::fluid::Fluid)
+/// outputs cache.
+#[inline]
+pub(crate) fn record_fluid_output(#[allow(unused_variables)] cached: bool) {
+    #[cfg(feature = "metrics")]
+    {
+        let counter = if cached { &FLUID_OUTPUT_HITS } else { &FLUID_OUTPUT_MISSES };
+        counter.fetch_add(1, Ordering::Relaxed);
+    }
+}
+
+/// Records the failed flash calculation of the [`Fluid`](crate::fluid::Fluid).
+#[inline]
+pub(crate) fn record_failed_flash(#[allow(unused_variables)] input_pair: FluidInputPair) {
+    #[cfg(feature = "metrics")]
+    {
+        FAILED_FLASHES[input_pair as usize].fetch_add(1, Ordering::Relaxed);
+    }
+}
+
+#[cfg(feature = "metrics")]
+static ENTRIES: Mutex<Vec<&'static Entry>> = Mutex::new(Vec::new());
+
+#[cfg(feature = "metrics")]
+static LOCK_WAITS: [LockCounters; 3] = [const { LockCounters::new() }; 3];
+
+#[cfg(feature = "metrics")]
+static FLUID_OUTPUT_HITS: AtomicU64 = AtomicU64::new(0);
+
+#[cfg(feature = "metrics")]
+static FLUID_OUTPUT_MISSES: AtomicU64 = AtomicU64::new(0);
+
+#[cfg(feature = "metrics")]
+static FAILED_FLASHES: [AtomicU64; FluidInputPair::DMolarUMolar as usize + 1] =
+    [const { AtomicU64::new(0) }; FluidInputPair::DMolarUMolar as usize + 1];
+
+/// Counters of the lock wait time.
+#[cfg(feature = "metrics")]
+struct LockCounters {
+    acquisitions: AtomicU64,
+    wait_nanos: AtomicU64,
+}
+
+#[cfg(feature = "metrics")]
+impl LockCounters {
+    const fn new() -> Self {
+        Self { acquisitions: AtomicU64::new(0), wait_nanos: AtomicU64::new(0) }
+    }
+
+    fn stats(&self) -> LockWaitStats {
+        LockWaitStats {
+            acquisitions: self.acquisitions.load(Ordering::Relaxed),
+            wait: Duration::from_nanos(self.wait_nanos.load(Ordering::Relaxed)),
+        }
+    }
+
+    fn reset(&self) {
+        self.acquisitions.store(0, Ordering::Relaxed);
+        self.wait_nanos.store(0, Ordering::Relaxed);
+    }
+}
+
+/// Counters of the FFI entry point _(one static instance per call site)_.
+#[cfg(feature = "metrics")]
+#[doc(hidden)]
+#[derive(Debug)]
+pub struct Entry {
+    name: &'static str,
+    registered: AtomicBool,
+    calls: AtomicU64,
+    total_nanos: AtomicU64,
+    histogram: [AtomicU64; HISTOGRAM_BUCKETS],
+}
+
+#[cfg(feature = "metrics")]
+impl Entry {
+    #[must_use]
+    pub const fn new(name: &'static str) -> Self {
+        Self {
+            name,
+            registered: AtomicBool::new(false),
+            calls: AtomicU64::new(0),
+            total_nanos: AtomicU64::new(0),
+            histogram: [const { AtomicU64::new(0) }; HISTOGRAM_BUCKETS],
+        }
+    }
+
+    pub fn record(&'static self, elapsed: Duration) {
+        if !self.registered.load(Ordering::Relaxed) && !self.registered.swap(true, Ordering::AcqRel)
+        {
+            ENTRIES.lock().unwrap().push(self);
+        }
+        let nanos = nanos(elapsed);
+        self.calls.fetch_add(1, Ordering::Relaxed);
+        self.total_nanos.fetch_add(nanos, Ordering::Relaxed);
+        self.histogram[bucket(nanos)].fetch_add(1, Ordering::Relaxed);
+    }
+
+    fn reset(&self) {
+        self.calls.store(0, Ordering::Relaxed);
+        self.total_nanos.store(0, Ordering::Relaxed);
+        self.histogram.iter().for_each(|bucket| bucket.store(0, Ordering::Relaxed));
+    }
+}
+
+/// Statistics of the FFI entry point.
+#[cfg(feature = "metrics")]
+#[derive(Clone, Debug, PartialEq)]
+pub struct FfiCallStats {
+    /// Name of the `CoolProp` entry point _(e.g., `"AbstractState_update"`)_.
+    pub name: &'static str,
+
+    /// Number of calls.
+    pub calls: u64,
+
+    /// Total time spent inside `CoolProp`.
+    pub total: Duration,
+
+    /// Latency histogram _(see [`HISTOGRAM_BUCKETS`] for the bucket bounds)_.
+    pub histogram: [u64; HISTOGRAM_BUCKETS],
+}
+
+#[cfg(feature = "metrics")]
+impl FfiCallStats {
+    /// Mean latency _(zero if there were no calls)_.
+    #[must_use]
+    pub fn mean(&self) -> Duration {
+        self.total
+            .as_nanos()
+            .checked_div(u128::from(self.calls))
+            .map_or(Duration::ZERO, |mean| Duration::from_nanos(mean as u64))
+    }
+
+    /// Upper bound of the latency quantile, estimated from the histogram
+    /// _(zero if there were no calls)_.
+    ///
+    /// # Arguments
+    ///
+    /// - `q` -- quantile **\[dimensionless, from 0 to 1\]** _(e.g., `0.99`)_
+    #[must_use]
+    pub fn quantile(&self, q: f64) -> Duration {
+        let rank = (q.clamp(0.0, 1.0) * self.calls as f64).ceil().max(1.0) as u64;
+        let mut count = 0;
+        for (i, calls) in self.histogram.iter().enumerate() {
+            count += calls;
+            if count >= rank {
+                return Duration::from_nanos(1 << i);
+            }
+        }
+        Duration::ZERO
+    }
+}
+
+/// Wait time statistics of the [`Lock`].
+#[cfg(feature = "metrics")]
+#[derive(Clone, Copy, Debug, Default, PartialEq)]
+pub struct LockWaitStats {
+    /// Number of acquisitions.
+    pub acquisitions: u64,
+
+    /// Total time spent waiting for the lock.
+    pub wait: Duration,
+}
+
+/// Point-in-time copy of all recorded metrics.
+#[cfg(feature = "metrics")]
+#[derive(Clone, Debug, PartialEq)]
+pub struct Snapshot {
+    /// Statistics per FFI entry point _(only entry points that were called at least once,
+    /// sorted by name; different call sites of the same entry point are merged)_.
+    pub ffi_calls: Vec<FfiCallStats>,
+
+    /// Wait time statistics of the `CoolProp` high-level API lock.
+    pub high_level_api_lock: LockWaitStats,
+
+    /// Wait time statistics of the shared lock of the `CoolProp` low-level API handles.
+    pub handles_read_lock: LockWaitStats,
+
+    /// Wait time statistics of the exclusive lock of the `CoolProp` low-level API handles.
+    pub handles_write_lock: LockWaitStats,
+
+    /// Number of [`Fluid`](crate::fluid::Fluid) outputs served from the cache.
+    pub fluid_output_hits: u64,
+
+    /// Number of [`Fluid`](crate::fluid::Fluid) outputs calculated natively.
+    pub fluid_output_misses: u64,
+
+    /// Number of failed flash calculations of the [`Fluid`](crate::fluid::Fluid)
+    /// per input pair.
+    pub failed_flashes: Vec<(FluidInputPair, u64)>,
+}
+
+#[cfg(feature = "metrics")]
+impl Snapshot {
+    /// Statistics of the specified FFI entry point _(if it was called at least once)_.
+    #[must_use]
+    pub fn ffi_call(&self, name: &str) -> Option<&FfiCallStats> {
+        self.ffi_calls.iter().find(|stats| stats.name == name)
+    }
+
+    /// Wait time statistics of the specified lock.
+    #[must_use]
+    pub fn lock_wait(&self, lock: Lock) -> LockWaitStats {
+        match lock {
+            Lock::HighLevelApi => self.high_level_api_lock,
+            Lock::HandlesRead => self.handles_read_lock,
+            Lock::HandlesWrite => self.handles_write_lock,
+        }
+    }
+
+    /// Total time spent inside `CoolProp` over all FFI entry points.
+    #[must_use]
+    pub fn ffi_total(&self) -> Duration {
+        self.ffi_calls.iter().map(|stats| stats.total).sum()
+    }
+
+    /// Hit rate of the [`Fluid`](crate::fluid::Fluid) outputs cache
+    /// **\[dimensionless, from 0 to 1\]** _(`None` if there were no outputs)_.
+    #[must_use]
+    pub fn fluid_output_hit_rate(&self) -> Option<f64> {
+        let total = self.fluid_output_hits + self.fluid_output_misses;
+        (total > 0).then(|| self.fluid_output_hits as f64 / total as f64)
+    }
+}
+
+/// Returns a point-in-time copy of all recorded metrics.
+///
+/// Counters are read without stopping other threads,
+/// so the snapshot may be slightly inconsistent under concurrent load.
+#[cfg(feature = "metrics")]
+#[must_use]
+pub fn snapshot() -> Snapshot {
+    let mut ffi_calls: Vec<FfiCallStats> = Vec::new();
+    for entry in ENTRIES.lock().unwrap().iter() {
+        let stats = match ffi_calls.iter_mut().find(|stats| stats.name == entry.name) {
+            Some(stats) => stats,
+            None => {
+                ffi_calls.push(FfiCallStats {
+                    name: entry.name,
+                    calls: 0,
+                    total: Duration::ZERO,
+                    histogram: [0; HISTOGRAM_BUCKETS],
+                });
+                ffi_calls.last_mut().unwrap()
+            }
+        };
+        stats.calls += entry.calls.load(Ordering::Relaxed);
+        stats.total += Duration::from_nanos(entry.total_nanos.load(Ordering::Relaxed));
+        for (bucket, count) in stats.histogram.iter_mut().zip(&entry.histogram) {
+            *bucket += count.load(Ordering::Relaxed);
+        }
+    }
+    ffi_calls.retain(|stats| stats.calls > 0);
+    ffi_calls.sort_unstable_by_key(|stats| stats.name);
+    Snapshot {
+        ffi_calls,
+        high_level_api_lock: LOCK_WAITS[Lock::HighLevelApi as usize].stats(),
+        handles_read_lock: LOCK_WAITS[Lock::HandlesRead as usize].stats(),
+        handles_write_lock: LOCK_WAITS[Lock::HandlesWrite as usize].stats(),
+        fluid_output_hits: FLUID_OUTPUT_HITS.load(Ordering::Relaxed),
+        fluid_output_misses: FLUID_OUTPUT_MISSES.load(Ordering::Relaxed),
+        failed_flashes: FAILED_FLASHES
+            .iter()
+            .enumerate()
+            .filter_map(|(i, count)| {
+                let count = count.load(Ordering::Relaxed);
+                let pair = u8::try_from(i).ok().and_then(FluidInputPair::from_repr)?;
+                (count > 0).then_some((pair, count))
+            })
+            .collect(),
+    }
+}
+
+/// Resets all recorded metrics.
+#[cfg(feature = "metrics")]
+pub fn reset() {
+    ENTRIES.lock().unwrap().iter().for_each(|entry| entry.reset());
+    LOCK_WAITS.iter().for_each(LockCounters::reset);
+    for counter in [&FLUID_OUTPUT_HITS, &FLUID_OUTPUT_MISSES] {
+        counter.store(0, Ordering::Relaxed);
+    }
+    FAILED_FLASHES.iter().for_each(|count| count.store(0, Ordering::Relaxed));
+}
+
+#[cfg(feature = "metrics")]
+fn nanos(elapsed: Duration) -> u64 {
+    u64::try_from(elapsed.as_nanos()).unwrap_or(u64::MAX)
+}
+
+#[cfg(feature = "metrics")]
+fn bucket(nanos: u64) -> usize {
+    let bucket = (u64::BITS - nanos.saturating_sub(1).leading_zeros()) as usize;
+    bucket.min(HISTOGRAM_BUCKETS - 1)
+}
+
+#[cfg(all(test, feature = "metrics"))]
+mod tests {
+    use rstest::*;
+
+    use super::*;
+
+    #[rstest]
+    #[case(0, 0)]
+    #[case(1, 0)]
+    #[case(2, 1)]
+    #[case(3, 2)]
+    #[case(4, 2)]
+    #[case(1_000, 10)]
+    #[case(u64::MAX, HISTOGRAM_BUCKETS - 1)]
+    fn bucket(#[case] nanos: u64, #[case] expected: usize) {
+        // When
+        let res = super::bucket(nanos);
+
+        // Then
+        assert_eq!(res, expected);
+    }
+
+    #[test]
+    fn quantile() {
+        // Given
+        let mut histogram = [0; HISTOGRAM_BUCKETS];
+        histogram[4] = 90;
+        histogram[10] = 10;
+        let sut = FfiCallStats {
+            name: "AbstractState_update",
+            calls: 100,
+            total: Duration::from_micros(20),
+            histogram,
+        };
+
+        // When
+        let (median, tail) = (sut.quantile(0.5), sut.quantile(0.99));
+
+        // Then
+        assert_eq!(median, Duration::from_nanos(16));
+        assert_eq!(tail, Duration::from_nanos(1_024));
+        assert_eq!(sut.mean(), Duration::from_nanos(200));
+    }
+
+    #[test]
+    fn lock_waits_recorded_separately() {
+        // Given
+        let before = snapshot();
+
+        // When
+        record_lock_wait(Lock::HandlesRead, Duration::from_nanos(100));
+        record_lock_wait(Lock::HandlesWrite, Duration::from_nanos(300));
+
+        // Then
+        let res = snapshot();
+        let (read, write) = (res.lock_wait(Lock::HandlesRead), res.lock_wait(Lock::HandlesWrite));
+        assert!(read.acquisitions > before.handles_read_lock.acquisitions);
+        assert!(read.wait >= before.handles_read_lock.wait + Duration::from_nanos(100));
+        assert!(write.acquisitions > before.handles_write_lock.acquisitions);
+        assert!(write.wait >= before.handles_write_lock.wait + Duration::from_nanos(300));
+    }
+
+    #[test]
+    fn failed_flashes_recorded_per_input_pair() {
+        // When
+        record_failed_flash(FluidInputPair::DMolarUMolar);
+        record_failed_flash(FluidInputPair::DMolarUMolar);
+
+        // Then
+        let res = snapshot();
+        let count = res
+            .failed_flashes
+            .iter()
+            .find_map(|&(pair, count)| (pair == FluidInputPair::DMolarUMolar).then_some(count));
+        assert!(count >= Some(2));
+    }
+
+    #[test]
+    fn ffi_call_recorded() {
+        // Given
+        static SUT: Entry = Entry::new("Test_entry");
+
+        // When
+        SUT.record(Duration::from_nanos(100));
+        SUT.record(Duration::from_nanos(300));
+
+        // Then
+        let res = snapshot();
+        let stats = res.ffi_call("Test_entry").unwrap();
+        assert!(stats.calls >= 2);
+        assert!(stats.total >= Duration::from_nanos(400));
+        assert!(stats.histogram[7] >= 1);
+        assert!(stats.histogram[9] >= 1);
+    }
+}
@@ -1,22 +1,71 @@
 use core::ffi::{c_char, c_int, c_long};
-use std::{cell::Cell, ffi::CString, marker::PhantomData, sync::MutexGuard};
+use std::{
+    cell::Cell,
+    ffi::{CStr, CString},
+    marker::PhantomData,
+    sync::{MutexGuard, RwLockReadGuard, RwLockWriteGuard},
+};
+
+use coolprop_sys::{COOLPROP, COOLPROP_HANDLES, bindings::CoolProp};
 
 use super::{CoolPropError, Result};
 use crate::io::GlobalParam;
 
-/// Marker to make structs `!Send + !Sync` for thread safety.
-type PhantomUnsync = PhantomData<Cell<()>>;
+/// Marker to make structs `!Sync` for thread safety.
+pub(crate) type PhantomUnsync = PhantomData<Cell<()>>;
+
+/// Locks the `CoolProp` high-level API, recording the lock wait time
+/// _(with the `metrics` feature)_.
+pub(crate) fn lock_coolprop() -> MutexGuard<'static, &'static CoolProp> {
+    #[cfg(feature = "metrics")]
+    let start = std::time::Instant::now();
+    let lock = COOLPROP.lock().unwrap();
+    #[cfg(feature = "metrics")]
+    crate::metrics::record_lock_wait(crate::metrics::Lock::HighLevelApi, start.elapsed());
+    lock
+}
 
+/// Acquires the shared lock of the `CoolProp` low-level API handles
+/// _(for calls on the existing native handle)_, recording the lock wait time
+/// _(with the `metrics` feature)_.
+pub(crate) fn read_handles() -> RwLockReadGuard<'static, ()> {
+    #[cfg(feature = "metrics")]
+    let start = std::time::Instant::now();
+    let lock = COOLPROP_HANDLES.read().unwrap();
+    #[cfg(feature = "metrics")]
+    crate::metrics::record_lock_wait(crate::metrics::Lock::HandlesRead, start.elapsed());
+    lock
+}
+
+/// Acquires the exclusive lock of the `CoolProp` low-level API handles
+/// _(for creation and release of native handles)_, recording the lock wait time
+/// _(with the `metrics` feature)_.
+pub(crate) fn write_handles() -> RwLockWriteGuard<'static, ()> {
+    #[cfg(feature = "metrics")]
+    let start = std::time::Instant::now();
+    let lock = COOLPROP_HANDLES.write().unwrap();
+    #[cfg(feature = "metrics")]
+    crate::metrics::record_lock_wait(crate::metrics::Lock::HandlesWrite, start.elapsed());
+    lock
+}
+
+/// Capacity of the [`ErrorBuffer`] message **\[bytes\]**.
+const ERROR_MESSAGE_CAPACITY: usize = 500;
+
+/// Stack-allocated buffer for error code and message of the `CoolProp` low-level API calls.
+///
+/// It doesn't allocate any heap memory, and the error message is decoded
+/// only if `CoolProp` reported a non-zero error code.
 #[derive(Debug)]
 pub(crate) struct ErrorBuffer {
     code: c_long,
-    pub message: StringBuffer,
-    marker: PhantomUnsync,
+    message: [c_char; ERROR_MESSAGE_CAPACITY],
+    capacity: usize,
 }
 
 impl ErrorBuffer {
     pub fn blank() -> Self {
-        Self { code: 0, message: StringBuffer::blank(), marker: PhantomData }
+        Self { code: 0, message: [0; ERROR_MESSAGE_CAPACITY], capacity: 0 }
     }
 
     #[must_use]
@@ -25,7 +74,16 @@ impl ErrorBuffer {
     }
 
     #[must_use]
-    #[allow(dead_code)]
+    pub fn message_as_mut_ptr(&mut self) -> *mut c_char {
+        self.message.as_mut_ptr()
+    }
+
+    #[must_use]
+    pub fn message_capacity(&self) -> c_long {
+        self.capacity as c_long
+    }
+
+    #[must_use]
     pub fn code(&self) -> c_long {
         self.code
     }
@@ -33,13 +91,24 @@ impl ErrorBuffer {
 
 impl Default for ErrorBuffer {
     fn default() -> Self {
-        Self { code: 0, message: StringBuffer::default(), marker: PhantomData }
+        Self { code: 0, message: [0; ERROR_MESSAGE_CAPACITY], capacity: ERROR_MESSAGE_CAPACITY }
     }
 }
 
 impl From<ErrorBuffer> for Option<CoolPropError> {
-    fn from(value: ErrorBuffer) -> Self {
-        value.message.into()
+    fn from(mut value: ErrorBuffer) -> Self {
+        let code = value.code();
+        if code == 0 {
+            return None;
+        }
+        value.message[ERROR_MESSAGE_CAPACITY - 1] = 0;
+        let message = unsafe { CStr::from_ptr(value.message.as_ptr()) }.to_string_lossy();
+        if message.trim().is_empty() {
+            return Some(CoolPropError::Native(format!(
+                "Error: CoolProp returned error code [{code}] without a message"
+            )));
+        }
+        Some(CoolPropError::Native(message.into_owned()))
     }
 }
 
@@ -120,8 +189,15 @@ pub(crate) fn c_string_trimmed(arg: &'static str, value: impl AsRef<str>) -> Res
     c_string(arg, value.as_ref().trim())
 }
 
+pub(crate) fn check_len(arg: &'static str, expected: usize, actual: usize) -> Result<()> {
+    if actual == expected {
+        return Ok(());
+    }
+    Err(CoolPropError::InvalidLength { arg, expected, actual })
+}
+
 pub(crate) fn get_error(
-    lock: &MutexGuard<coolprop_sys::bindings::CoolProp>,
+    lock: &MutexGuard<&coolprop_sys::bindings::CoolProp>,
 ) -> Option<CoolPropError> {
     let mut message = StringBuffer::default();
     let param = CString::new(GlobalParam::PendingError.as_ref()).unwrap();
@@ -147,7 +223,7 @@ mod tests {
 
             // Then
             assert_eq!(sut.code(), 0);
-            assert_eq!(sut.message.capacity(), 0);
+            assert_eq!(sut.message_capacity(), 0);
         }
 
         #[test]
@@ -157,7 +233,7 @@ mod tests {
 
             // Then
             assert_eq!(sut.code(), 0);
-            assert_eq!(sut.message.capacity(), 500);
+            assert_eq!(sut.message_capacity(), 500);
         }
 
         #[test]
@@ -175,10 +251,21 @@ mod tests {
         }
 
         #[rstest]
-        #[case("", None)]
-        #[case(" ", None)]
-        #[case("error message", Some(CoolPropError::Native("error message".into())))]
-        fn into_coolprop_error(#[case] msg: &str, #[case] expected: Option<CoolPropError>) {
+        #[case(0, "", None)]
+        #[case(0, "error message", None)]
+        #[case(1, "error message", Some(CoolPropError::Native("error message".into())))]
+        #[case(
+            2,
+            " ",
+            Some(CoolPropError::Native(
+                "Error: CoolProp returned error code [2] without a message".into()
+            ))
+        )]
+        fn into_coolprop_error(
+            #[case] code: c_long,
+            #[case] msg: &str,
+            #[case] expected: Option<CoolPropError>,
+        ) {
             // Given
             let mut sut = ErrorBuffer::default();
             let c_string = CString::new(msg).unwrap();
@@ -186,9 +273,10 @@ mod tests {
 
             // When
             unsafe {
+                *sut.code_as_mut_ptr() = code;
                 std::ptr::copy_nonoverlapping(
                     c_bytes.as_ptr().cast::<c_char>(),
-                    sut.message.as_mut_ptr(),
+                    sut.message_as_mut_ptr(),
                     c_bytes.len(),
                 );
             }
@@ -197,6 +285,22 @@ mod tests {
             // Then
             assert_eq!(res, expected);
         }
+
+        #[test]
+        fn into_coolprop_error_without_nul() {
+            // Given
+            let mut sut = ErrorBuffer::default();
+
+            // When
+            unsafe {
+                *sut.code_as_mut_ptr() = 1;
+                std::ptr::write_bytes(sut.message_as_mut_ptr(), b'E', 500);
+            }
+            let res: Option<CoolPropError> = sut.into();
+
+            // Then
+            assert_eq!(res, Some(CoolPropError::Native("E".repeat(499))));
+        }
     }
 
     mod string_buffer {
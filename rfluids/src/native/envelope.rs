@@ -0,0 +1,683 @@
+use core::ffi::c_long;
+
+use coolprop_sys::COOLPROP_API;
+
+use super::{
+    AbstractState, CoolPropError, Result,
+    common::{ErrorBuffer, read_handles},
+    low_level_api::res,
+};
+use crate::metrics::ffi;
+
+/// Initial number of points of the [`PhaseEnvelope`], [`Spinodal`]
+/// and [`CriticalPoints`] buffers.
+const MIN_POINTS: usize = 1_024;
+
+/// Maximum number of points of the [`Spinodal`] and [`CriticalPoints`] buffers.
+const MAX_POINTS: usize = 1 << 16;
+
+/// Maximum number of mixture components of the [`PhaseEnvelope`].
+const MAX_COMPONENTS: usize = 20;
+
+/// Part of the `CoolProp` error message for too small buffers.
+const BUFFER_TOO_SMALL: &str = "greater than allocated buffer length";
+
+/// Phase envelope of the mixture _(struct of arrays)_.
+///
+/// It's a reusable buffer: the capacity of its arrays is retained between
+/// [`AbstractState::phase_envelope`] calls, so they don't allocate
+/// once the buffer is large enough.
+///
+/// # See Also
+///
+/// - [`AbstractState::build_phase_envelope`]
+/// - [`AbstractState::phase_envelope`]
+#[derive(Clone, Debug, Default)]
+pub struct PhaseEnvelope {
+    temperature: Vec<f64>,
+    pressure: Vec<f64>,
+    liquid_molar_density: Vec<f64>,
+    vapor_molar_density: Vec<f64>,
+    liquid_fractions: Vec<f64>,
+    vapor_fractions: Vec<f64>,
+    /// Point-major fractions written by `CoolProp`, kept for reuse of its capacity.
+    scratch: Vec<f64>,
+    components: usize,
+}
+
+impl PhaseEnvelope {
+    /// Creates and returns a new empty [`PhaseEnvelope`] buffer.
+    #[must_use]
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// Number of points.
+    #[must_use]
+    pub fn len(&self) -> usize {
+        self.temperature.len()
+    }
+
+    /// Returns `true` if there are no points.
+    #[must_use]
+    pub fn is_empty(&self) -> bool {
+        self.temperature.is_empty()
+    }
+
+    /// Number of mixture components.
+    #[must_use]
+    pub fn components(&self) -> usize {
+        self.components
+    }
+
+    /// Temperatures **\[K\]**.
+    #[must_use]
+    pub fn temperature(&self) -> &[f64] {
+        &self.temperature
+    }
+
+    /// Pressures **\[Pa\]**.
+    #[must_use]
+    pub fn pressure(&self) -> &[f64] {
+        &self.pressure
+    }
+
+    /// Molar densities of the liquid phase **\[mol/m³\]**.
+    #[must_use]
+    pub fn liquid_molar_density(&self) -> &[f64] {
+        &self.liquid_molar_density
+    }
+
+    /// Molar densities of the vapor phase **\[mol/m³\]**.
+    #[must_use]
+    pub fn vapor_molar_density(&self) -> &[f64] {
+        &self.vapor_molar_density
+    }
+
+    /// Mole fractions of the specified component in the liquid phase **\[dimensionless\]**
+    /// _(in the order of the mixture components)_.
+    ///
+    /// # Panics
+    ///
+    /// Panics if `component` is out of range.
+    #[must_use]
+    pub fn liquid_fractions(&self, component: usize) -> &[f64] {
+        assert!(component < self.components, "component index is out of range");
+        &self.liquid_fractions[component * self.len()..][..self.len()]
+    }
+
+    /// Mole fractions of the specified component in the vapor phase **\[dimensionless\]**
+    /// _(in the order of the mixture components)_.
+    ///
+    /// # Panics
+    ///
+    /// Panics if `component` is out of range.
+    #[must_use]
+    pub fn vapor_fractions(&self, component: usize) -> &[f64] {
+        assert!(component < self.components, "component index is out of range");
+        &self.vapor_fractions[component * self.len()..][..self.len()]
+    }
+
+    fn resize(&mut self, points: usize, components: usize) {
+        for column in [
+            &mut self.temperature,
+            &mut self.pressure,
+            &mut self.liquid_molar_density,
+            &mut self.vapor_molar_density,
+        ] {
+            column.resize(points, f64::NAN);
+        }
+        self.liquid_fractions.resize(points * components, f64::NAN);
+        self.vapor_fractions.resize(points * components, f64::NAN);
+    }
+
+    fn truncate(&mut self, points: usize, components: usize) {
+        self.resize(points, components);
+        self.components = components;
+    }
+
+    /// Converts the point-major fractions written by `CoolProp`
+    /// _(`x[point * components + component]`)_ into component-major ones.
+    fn transpose_fractions(&mut self, points: usize, components: usize) {
+        let scratch = &mut self.scratch;
+        for fractions in [&mut self.liquid_fractions, &mut self.vapor_fractions] {
+            scratch.clear();
+            for component in 0..components {
+                scratch.extend((0..points).map(|point| fractions[point * components + component]));
+            }
+            std::mem::swap(fractions, scratch);
+        }
+    }
+}
+
+impl PartialEq for PhaseEnvelope {
+    fn eq(&self, other: &Self) -> bool {
+        // The scratch buffer isn't a part of the phase envelope
+        self.components == other.components
+            && self.temperature == other.temperature
+            && self.pressure == other.pressure
+            && self.liquid_molar_density == other.liquid_molar_density
+            && self.vapor_molar_density == other.vapor_molar_density
+            && self.liquid_fractions == other.liquid_fractions
+            && self.vapor_fractions == other.vapor_fractions
+    }
+}
+
+/// Spinodal curve of the substance in reduced coordinates _(struct of arrays)_.
+///
+/// It's a reusable buffer: the capacity of its arrays is retained between
+/// [`AbstractState::spinodal`] calls.
+///
+/// # See Also
+///
+/// - [`AbstractState::build_spinodal`]
+/// - [`AbstractState::spinodal`]
+#[derive(Clone, Debug, Default, PartialEq)]
+pub struct Spinodal {
+    tau: Vec<f64>,
+    delta: Vec<f64>,
+    m1: Vec<f64>,
+}
+
+impl Spinodal {
+    /// Creates and returns a new empty [`Spinodal`] buffer.
+    #[must_use]
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// Number of points.
+    #[must_use]
+    pub fn len(&self) -> usize {
+        self.tau.len()
+    }
+
+    /// Returns `true` if there are no points.
+    #[must_use]
+    pub fn is_empty(&self) -> bool {
+        self.tau.is_empty()
+    }
+
+    /// Reciprocal reduced temperatures _(`T_reducing / T`)_ **\[dimensionless\]**.
+    #[must_use]
+    pub fn tau(&self) -> &[f64] {
+        &self.tau
+    }
+
+    /// Reduced densities _(`rhomolar / rhomolar_reducing`)_ **\[dimensionless\]**.
+    #[must_use]
+    pub fn delta(&self) -> &[f64] {
+        &self.delta
+    }
+
+    /// Values of the stability criterion _(`M1` determinant, zero on the spinodal)_
+    /// **\[dimensionless\]**.
+    #[must_use]
+    pub fn m1(&self) -> &[f64] {
+        &self.m1
+    }
+}
+
+/// Critical points of the mixture _(struct of arrays)_.
+///
+/// It's a reusable buffer: the capacity of its arrays is retained between
+/// [`AbstractState::critical_points`] calls.
+///
+/// # See Also
+///
+/// - [`AbstractState::critical_points`]
+#[derive(Clone, Debug, Default, PartialEq)]
+pub struct CriticalPoints {
+    temperature: Vec<f64>,
+    pressure: Vec<f64>,
+    molar_density: Vec<f64>,
+    stable: Vec<c_long>,
+}
+
+impl CriticalPoints {
+    /// Creates and returns a new empty [`CriticalPoints`] buffer.
+    #[must_use]
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    /// Number of critical points.
+    #[must_use]
+    pub fn len(&self) -> usize {
+        self.temperature.len()
+    }
+
+    /// Returns `true` if there are no critical points.
+    #[must_use]
+    pub fn is_empty(&self) -> bool {
+        self.temperature.is_empty()
+    }
+
+    /// Temperatures **\[K\]**.
+    #[must_use]
+    pub fn temperature(&self) -> &[f64] {
+        &self.temperature
+    }
+
+    /// Pressures **\[Pa\]**.
+    #[must_use]
+    pub fn pressure(&self) -> &[f64] {
+        &self.pressure
+    }
+
+    /// Molar densities **\[mol/m³\]**.
+    #[must_use]
+    pub fn molar_density(&self) -> &[f64] {
+        &self.molar_density
+    }
+
+    /// Returns `true` if the critical point with the specified index is stable.
+    ///
+    /// # Panics
+    ///
+    /// Panics if `index` is out of range.
+    #[must_use]
+    pub fn is_stable(&self, index: usize) -> bool {
+        self.stable[index] != 0
+    }
+}
+
+impl AbstractState {
+    /// Builds the phase envelope of the mixture, which is then kept by the instance
+    /// until its composition is changed.
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`CoolPropError`](crate::native::CoolPropError)
+    /// if the backend doesn't support phase envelopes or the envelope can't be traced.
+    ///
+    /// # Examples
+    ///
+    /// ```
+    /// use rfluids::{native::PhaseEnvelope, prelude::*};
+    ///
+    /// let mut mixture = AbstractState::new("HEOS", "Methane&Ethane")?;
+    /// mixture.set_fractions(&[0.5, 0.5])?;
+    /// mixture.build_phase_envelope()?;
+    /// let mut envelope = PhaseEnvelope::new();
+    /// mixture.phase_envelope(&mut envelope)?;
+    /// assert!(!envelope.is_empty());
+    /// assert_eq!(envelope.components(), 2);
+    /// # Ok::<(), rfluids::native::CoolPropError>(())
+    /// ```
+    ///
+    /// # See Also
+    ///
+    /// - [`AbstractState::phase_envelope`]
+    pub fn build_phase_envelope(&mut self) -> Result<()> {
+        let mut err = ErrorBuffer::default();
+        let _handles = read_handles();
+        ffi!("AbstractState_build_phase_envelope", unsafe {
+            COOLPROP_API.AbstractState_build_phase_envelope(
+                self.ptr,
+                c"".as_ptr(),
+                err.code_as_mut_ptr(),
+                err.message_as_mut_ptr(),
+                err.message_capacity(),
+            );
+        });
+        res((), err)
+    }
+
+    /// Writes the previously built phase envelope into the reusable `out` buffer.
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`CoolPropError`](crate::native::CoolPropError)
+    /// if the phase envelope isn't built yet.
+    ///
+    /// # See Also
+    ///
+    /// - [`AbstractState::build_phase_envelope`]
+    pub fn phase_envelope(&self, out: &mut PhaseEnvelope) -> Result<()> {
+        let mut points = out.temperature.capacity().max(MIN_POINTS);
+        loop {
+            out.resize(points, MAX_COMPONENTS);
+            let (mut actual_points, mut actual_components): (c_long, c_long) = (0, 0);
+            let mut err = ErrorBuffer::default();
+            let _handles = read_handles();
+            ffi!("AbstractState_get_phase_envelope_data_checkedMemory", unsafe {
+                COOLPROP_API.AbstractState_get_phase_envelope_data_checkedMemory(
+                    self.ptr,
+                    points as c_long,
+                    MAX_COMPONENTS as c_long,
+                    out.temperature.as_mut_ptr(),
+                    out.pressure.as_mut_ptr(),
+                    out.vapor_molar_density.as_mut_ptr(),
+                    out.liquid_molar_density.as_mut_ptr(),
+                    out.liquid_fractions.as_mut_ptr(),
+                    out.vapor_fractions.as_mut_ptr(),
+                    &raw mut actual_points,
+                    &raw mut actual_components,
+                    err.code_as_mut_ptr(),
+                    err.message_as_mut_ptr(),
+                    err.message_capacity(),
+                );
+            });
+            let actual_points = actual_points.max(0) as usize;
+            match res((), err) {
+                Ok(()) => {
+                    let components = actual_components.max(0) as usize;
+                    out.transpose_fractions(actual_points, components);
+                    out.truncate(actual_points, components);
+                    return Ok(());
+                }
+                // The buffer is too small, but the actual length is already known
+                Err(_) if actual_points > points => points = actual_points,
+                Err(e) => {
+                    out.truncate(0, 0);
+                    return Err(e);
+                }
+            }
+        }
+    }
+
+    /// Builds the spinodal curve of the substance, which is then kept by the instance
+    /// until its composition is changed.
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`CoolPropError`](crate::native::CoolPropError)
+    /// if the backend doesn't support spinodals or the spinodal can't be traced.
+    ///
+    /// # Examples
+    ///
+    /// ```
+    /// use rfluids::{native::Spinodal, prelude::*};
+    ///
+    /// let mut mixture = AbstractState::new("HEOS", "Methane&Ethane")?;
+    /// mixture.set_fractions(&[0.5, 0.5])?;
+    /// mixture.build_spinodal()?;
+    /// let mut spinodal = Spinodal::new();
+    /// mixture.spinodal(&mut spinodal)?;
+    /// assert!(!spinodal.is_empty());
+    /// # Ok::<(), rfluids::native::CoolPropError>(())
+    /// ```
+    ///
+    /// # See Also
+    ///
+    /// - [`AbstractState::spinodal`]
+    pub fn build_spinodal(&mut self) -> Result<()> {
+        let mut err = ErrorBuffer::default();
+        let _handles = read_handles();
+        ffi!("AbstractState_build_spinodal", unsafe {
+            COOLPROP_API.AbstractState_build_spinodal(
+                self.ptr,
+                err.code_as_mut_ptr(),
+                err.message_as_mut_ptr(),
+                err.message_capacity(),
+            );
+        });
+        res((), err)
+    }
+
+    /// Writes the previously built spinodal curve into the reusable `out` buffer.
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`CoolPropError`](crate::native::CoolPropError) if the spinodal isn't built yet.
+    ///
+    /// # See Also
+    ///
+    /// - [`AbstractState::build_spinodal`]
+    pub fn spinodal(&self, out: &mut Spinodal) -> Result<()> {
+        let points = with_growing_buffer(out.tau.capacity(), |points| {
+            for column in [&mut out.tau, &mut out.delta, &mut out.m1] {
+                column.clear();
+                column.resize(points, f64::NAN);
+            }
+            let mut err = ErrorBuffer::default();
+            let _handles = read_handles();
+            ffi!("AbstractState_get_spinodal_data", unsafe {
+                COOLPROP_API.AbstractState_get_spinodal_data(
+                    self.ptr,
+                    points as c_long,
+                    out.tau.as_mut_ptr(),
+                    out.delta.as_mut_ptr(),
+                    out.m1.as_mut_ptr(),
+                    err.code_as_mut_ptr(),
+                    err.message_as_mut_ptr(),
+                    err.message_capacity(),
+                );
+            });
+            res((), err)?;
+            Ok(filled_len(&out.tau))
+        });
+        let len = *points.as_ref().unwrap_or(&0);
+        for column in [&mut out.tau, &mut out.delta, &mut out.m1] {
+            column.truncate(len);
+        }
+        points.map(drop)
+    }
+
+    /// Calculates all critical points of the mixture
+    /// and writes them into the reusable `out` buffer.
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`CoolPropError`](crate::native::CoolPropError)
+    /// if the backend doesn't support critical points search.
+    ///
+    /// # Examples
+    ///
+    /// ```
+    /// use rfluids::{native::CriticalPoints, prelude::*};
+    ///
+    /// let mut mixture = AbstractState::new("HEOS", "Methane&Ethane")?;
+    /// mixture.set_fractions(&[0.5, 0.5])?;
+    /// let mut critical_points = CriticalPoints::new();
+    /// mixture.critical_points(&mut critical_points)?;
+    /// assert!(!critical_points.is_empty());
+    /// # Ok::<(), rfluids::native::CoolPropError>(())
+    /// ```
+    pub fn critical_points(&mut self, out: &mut CriticalPoints) -> Result<()> {
+        let points = with_growing_buffer(out.temperature.capacity(), |points| {
+            for column in [&mut out.temperature, &mut out.pressure, &mut out.molar_density] {
+                column.clear();
+                column.resize(points, f64::NAN);
+            }
+            out.stable.clear();
+            out.stable.resize(points, 0);
+            let mut err = ErrorBuffer::default();
+            let _handles = read_handles();
+            ffi!("AbstractState_all_critical_points", unsafe {
+                COOLPROP_API.AbstractState_all_critical_points(
+                    self.ptr,
+                    points as c_long,
+                    out.temperature.as_mut_ptr(),
+                    out.pressure.as_mut_ptr(),
+                    out.molar_density.as_mut_ptr(),
+                    out.stable.as_mut_ptr(),
+                    err.code_as_mut_ptr(),
+                    err.message_as_mut_ptr(),
+                    err.message_capacity(),
+                );
+            });
+            res((), err)?;
+            Ok(filled_len(&out.temperature))
+        });
+        let len = *points.as_ref().unwrap_or(&0);
+        for column in [&mut out.temperature, &mut out.pressure, &mut out.molar_density] {
+            column.truncate(len);
+        }
+        out.stable.truncate(len);
+        points.map(drop)
+    }
+}
+
+/// Calls `f` with the growing buffer length while it fails because of too small buffer
+/// _(until the length reaches [`MAX_POINTS`])_, since `CoolProp` doesn't report
+/// the required length. Any other error is returned right away.
+fn with_growing_buffer(
+    capacity: usize,
+    mut f: impl FnMut(usize) -> Result<usize>,
+) -> Result<usize> {
+    let mut points = capacity.clamp(MIN_POINTS, MAX_POINTS);
+    loop {
+        match f(points) {
+            Err(CoolPropError::Native(message))
+                if points < MAX_POINTS && message.contains(BUFFER_TOO_SMALL) =>
+            {
+                points = (points * 4).min(MAX_POINTS);
+            }
+            res => return res,
+        }
+    }
+}
+
+/// Number of points written by `CoolProp` into the buffer prefilled with [`f64::NAN`].
+fn filled_len(column: &[f64]) -> usize {
+    column.iter().position(|value| value.is_nan()).unwrap_or(column.len())
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn mixture() -> AbstractState {
+        let mut mixture = AbstractState::new("HEOS", "Methane&Ethane").unwrap();
+        mixture.set_fractions(&[0.5, 0.5]).unwrap();
+        mixture
+    }
+
+    #[test]
+    fn phase_envelope() {
+        // Given
+        let mut sut = mixture();
+        let mut out = PhaseEnvelope::new();
+        sut.build_phase_envelope().unwrap();
+
+        // When
+        let res = sut.phase_envelope(&mut out);
+
+        // Then
+        assert!(res.is_ok());
+        assert!(!out.is_empty());
+        assert_eq!(out.components(), 2);
+        assert_eq!(out.pressure().len(), out.len());
+        assert_eq!(out.vapor_fractions(1).len(), out.len());
+        assert!(out.temperature().iter().all(|value| value.is_finite()));
+    }
+
+    #[test]
+    fn phase_envelope_eq_ignores_scratch() {
+        // Given
+        let mut sut = mixture();
+        let mut out = PhaseEnvelope::new();
+        sut.build_phase_envelope().unwrap();
+        sut.phase_envelope(&mut out).unwrap();
+        let mut other = out.clone();
+        other.scratch = Vec::new();
+
+        // When
+        let res = out == other;
+
+        // Then
+        assert!(res);
+    }
+
+    #[test]
+    fn phase_envelope_fractions_sum_to_one() {
+        // Given
+        let mut sut = mixture();
+        let mut out = PhaseEnvelope::new();
+        sut.build_phase_envelope().unwrap();
+
+        // When
+        sut.phase_envelope(&mut out).unwrap();
+
+        // Then
+        for point in 0..out.len() {
+            let liquid: f64 = (0..out.components()).map(|c| out.liquid_fractions(c)[point]).sum();
+            let vapor: f64 = (0..out.components()).map(|c| out.vapor_fractions(c)[point]).sum();
+            approx::assert_relative_eq!(liquid, 1.0, max_relative = 1e-9);
+            approx::assert_relative_eq!(vapor, 1.0, max_relative = 1e-9);
+        }
+    }
+
+    #[test]
+    fn phase_envelope_reuses_buffer() {
+        // Given
+        let mut sut = mixture();
+        let mut out = PhaseEnvelope::new();
+        sut.build_phase_envelope().unwrap();
+        sut.phase_envelope(&mut out).unwrap();
+        let expected = out.clone();
+
+        // When
+        let res = sut.phase_envelope(&mut out);
+
+        // Then
+        assert!(res.is_ok());
+        assert_eq!(out, expected);
+    }
+
+    #[test]
+    fn spinodal() {
+        // Given
+        let mut sut = mixture();
+        let mut out = Spinodal::new();
+        sut.build_spinodal().unwrap();
+
+        // When
+        let res = sut.spinodal(&mut out);
+
+        // Then
+        assert!(res.is_ok());
+        assert!(!out.is_empty());
+        assert_eq!(out.delta().len(), out.len());
+        assert_eq!(out.m1().len(), out.len());
+    }
+
+    #[test]
+    fn critical_points() {
+        // Given
+        let mut sut = mixture();
+        let mut out = CriticalPoints::new();
+
+        // When
+        let res = sut.critical_points(&mut out);
+
+        // Then
+        assert!(res.is_ok());
+        assert!(!out.is_empty());
+        assert!(out.temperature().iter().all(|value| value.is_finite()));
+    }
+
+    #[test]
+    fn with_growing_buffer_grows_only_for_too_small_buffer() {
+        // Given
+        let mut calls = Vec::new();
+
+        // When
+        let res = with_growing_buffer(0, |points| {
+            calls.push(points);
+            match calls.len() {
+                1 => Err(CoolPropError::Native(format!(
+                    "Length of vectors [{}] is {BUFFER_TOO_SMALL} [{points}]",
+                    points + 1
+                ))),
+                2 => Err(CoolPropError::Native("spinodal is not built".into())),
+                _ => Ok(points),
+            }
+        });
+
+        // Then
+        assert_eq!(res, Err(CoolPropError::Native("spinodal is not built".into())));
+        assert_eq!(calls, [MIN_POINTS, 4 * MIN_POINTS]);
+    }
+
+    #[test]
+    fn filled_len() {
+        // When
+        let res = super::filled_len(&[1.0, 2.0, f64::NAN, f64::NAN]);
+
+        // Then
+        assert_eq!(res, 2);
+    }
+}
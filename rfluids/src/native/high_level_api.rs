@@ -1,14 +1,14 @@
 // cSpell:disable
 
-use std::sync::MutexGuard;
-
-use coolprop_sys::COOLPROP;
+use core::ffi::{c_int, c_long};
+use std::{ffi::CString, sync::MutexGuard};
 
 use super::{
     CoolPropError, Result,
-    common::{c_string_trimmed, get_error},
+    common::{c_string, c_string_trimmed, check_len, get_error, lock_coolprop},
+    props_si_pool,
 };
-use crate::io::Phase;
+use crate::{io::Phase, metrics::ffi};
 
 /// `CoolProp` thread safe high-level API.
 pub struct CoolProp;
@@ -16,6 +16,12 @@ pub struct CoolProp;
 impl CoolProp {
     /// Returns a value that depends on the thermodynamic state of the fluid.
     ///
+    /// The call is evaluated on a long-lived native handle from the per-thread pool
+    /// _(bounded, with the least recently used handles evicted first)_, so the substance
+    /// name is parsed and the handle is built only once per thread, and the global lock
+    /// of the high-level API is not acquired. Calls that can't be evaluated this way
+    /// _(e.g., with inputs that are not a valid input pair)_ are passed to `CoolProp` as is.
+    ///
     /// # Arguments
     ///
     /// - `output_key` -- key of the output _(raw [`&str`](str) or
@@ -95,12 +101,22 @@ impl CoolProp {
         input2_value: f64,
         substance_name: impl AsRef<str>,
     ) -> Result<f64> {
+        if let Some(res) = props_si_pool::props_si(
+            output_key.as_ref(),
+            input1_key.as_ref(),
+            input1_value,
+            input2_key.as_ref(),
+            input2_value,
+            substance_name.as_ref(),
+        ) {
+            return res;
+        }
         let output_key = c_string_trimmed("output_key", output_key)?;
         let input1_key = c_string_trimmed("input1_key", input1_key)?;
         let input2_key = c_string_trimmed("input2_key", input2_key)?;
         let substance_name = c_string_trimmed("substance_name", substance_name)?;
-        let lock = COOLPROP.lock().unwrap();
-        let value = unsafe {
+        let lock = lock_coolprop();
+        let value = ffi!("PropsSI", unsafe {
             lock.PropsSI(
                 output_key.as_ptr(),
                 input1_key.as_ptr(),
@@ -109,10 +125,115 @@ impl CoolProp {
                 input2_value,
                 substance_name.as_ptr(),
             )
-        };
+        });
         res(value, &lock)
     }
 
+    /// Returns values that depend on the thermodynamic state of the fluid
+    /// for several outputs and states at once.
+    ///
+    /// All states are calculated within a single FFI call, using one native handle
+    /// for the specified backend and substances.
+    ///
+    /// # Arguments
+    ///
+    /// - `output_keys` -- keys of the outputs _(raw [`&str`](str) or
+    ///   [`FluidParam`](crate::io::FluidParam))_
+    /// - `input1_key` -- key of the first input property _(raw [`&str`](str) or
+    ///   [`FluidParam`](crate::io::FluidParam))_
+    /// - `input1` -- values of the first input property **\[SI units\]**
+    /// - `input2_key` -- key of the second input property _(raw [`&str`](str) or
+    ///   [`FluidParam`](crate::io::FluidParam))_
+    /// - `input2` -- values of the second input property **\[SI units\]**
+    ///   _(same length as `input1`)_
+    /// - `backend_name` -- name of the backend _(raw [`&str`](str) or
+    ///   [`Backend::name`](crate::fluid::backend::Backend::name))_
+    /// - `substance_names` -- names of the substances _(raw [`&str`](str))_
+    /// - `fractions` -- fractions of the substances _(`&[1.0]` for pure substances)_
+    ///
+    /// Returns output values in row-major order _(one row of `output_keys.len()` values
+    /// per state)_. Values for the states that can't be calculated are [`f64::NAN`].
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`CoolPropError`](crate::native::CoolPropError) for invalid inputs.
+    ///
+    /// # Examples
+    ///
+    /// To calculate the density **\[kg/m³\]** and specific heat **\[J/kg/K\]** of water
+    /// at _1 atm_ and _20 °C_, _40 °C_:
+    ///
+    /// ```
+    /// use approx::assert_relative_eq;
+    /// use rfluids::prelude::*;
+    ///
+    /// let res = CoolProp::props_si_multi(
+    ///     &["D", "C"],
+    ///     "P",
+    ///     &[101_325.0, 101_325.0],
+    ///     "T",
+    ///     &[293.15, 313.15],
+    ///     "HEOS",
+    ///     &["Water"],
+    ///     &[1.0],
+    /// )?;
+    /// assert_eq!(res.len(), 4);
+    /// assert_relative_eq!(res[0], 998.207_150_467_928_4, max_relative = 1e-6);
+    /// assert_relative_eq!(res[1], 4_184.050_924_523_541, max_relative = 1e-6);
+    /// # Ok::<(), rfluids::native::CoolPropError>(())
+    /// ```
+    ///
+    /// # See Also
+    ///
+    /// - [`CoolProp::props_si`]
+    /// - [`AbstractState::update_batch`](crate::native::AbstractState::update_batch)
+    #[allow(clippy::too_many_arguments)]
+    pub fn props_si_multi(
+        output_keys: &[impl AsRef<str>],
+        input1_key: impl AsRef<str>,
+        input1: &[f64],
+        input2_key: impl AsRef<str>,
+        input2: &[f64],
+        backend_name: impl AsRef<str>,
+        substance_names: &[impl AsRef<str>],
+        fractions: &[f64],
+    ) -> Result<Vec<f64>> {
+        let len = input1.len();
+        check_len("input2", len, input2.len())?;
+        if len == 0 || output_keys.is_empty() {
+            return Ok(Vec::new());
+        }
+        let width = output_keys.len();
+        let output_keys = c_string_joined("output_keys", output_keys)?;
+        let input1_key = c_string_trimmed("input1_key", input1_key)?;
+        let input2_key = c_string_trimmed("input2_key", input2_key)?;
+        let backend_name = c_string_trimmed("backend_name", backend_name)?;
+        let substance_names = c_string_joined("substance_names", substance_names)?;
+        let mut out = vec![0.0; len * width];
+        let (mut rows, mut columns) = (len as c_long, width as c_long);
+        let lock = lock_coolprop();
+        // Inputs are not modified by `CoolProp` despite the mutable pointers in the signature
+        ffi!("PropsSImulti", unsafe {
+            lock.PropsSImulti(
+                output_keys.as_ptr(),
+                input1_key.as_ptr(),
+                input1.as_ptr().cast_mut(),
+                len as c_long,
+                input2_key.as_ptr(),
+                input2.as_ptr().cast_mut(),
+                len as c_long,
+                backend_name.as_ptr().cast_mut(),
+                substance_names.as_ptr(),
+                fractions.as_ptr(),
+                fractions.len() as c_long,
+                out.as_mut_ptr(),
+                &raw mut rows,
+                &raw mut columns,
+            );
+        });
+        multi_res(out, &[(rows, len), (columns, width)], &lock)
+    }
+
     /// Returns a value that depends on the thermodynamic state of humid air.
     ///
     /// # Arguments
@@ -165,8 +286,8 @@ impl CoolProp {
         let input1_key = c_string_trimmed("input1_key", input1_key)?;
         let input2_key = c_string_trimmed("input2_key", input2_key)?;
         let input3_key = c_string_trimmed("input3_key", input3_key)?;
-        let lock = COOLPROP.lock().unwrap();
-        let value = unsafe {
+        let lock = lock_coolprop();
+        let value = ffi!("HAPropsSI", unsafe {
             lock.HAPropsSI(
                 output_key.as_ptr(),
                 input1_key.as_ptr(),
@@ -176,7 +297,7 @@ impl CoolProp {
                 input3_key.as_ptr(),
                 input3_value,
             )
-        };
+        });
         res(value, &lock)
     }
 
@@ -228,11 +349,79 @@ impl CoolProp {
     pub fn props1_si(output_key: impl AsRef<str>, substance_name: impl AsRef<str>) -> Result<f64> {
         let output_key = c_string_trimmed("output_key", output_key)?;
         let substance_name = c_string_trimmed("substance_name", substance_name)?;
-        let lock = COOLPROP.lock().unwrap();
-        let value = unsafe { lock.Props1SI(output_key.as_ptr(), substance_name.as_ptr()) };
+        let lock = lock_coolprop();
+        let value = ffi!("Props1SI", unsafe {
+            lock.Props1SI(output_key.as_ptr(), substance_name.as_ptr())
+        });
         res(value, &lock)
     }
 
+    /// Returns values that don't depend on the thermodynamic state of the fluid
+    /// _(trivial outputs)_ for several outputs at once.
+    ///
+    /// # Arguments
+    ///
+    /// - `output_keys` -- keys of the _trivial_ outputs _(raw [`&str`](str) or
+    ///   [`FluidTrivialParam`](crate::io::FluidTrivialParam))_
+    /// - `backend_name` -- name of the backend _(raw [`&str`](str) or
+    ///   [`Backend::name`](crate::fluid::backend::Backend::name))_
+    /// - `substance_names` -- names of the substances _(raw [`&str`](str))_
+    /// - `fractions` -- fractions of the substances _(`&[1.0]` for pure substances)_
+    ///
+    /// Returns output values in the same order as `output_keys`.
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`CoolPropError`](crate::native::CoolPropError) for invalid inputs.
+    ///
+    /// # Examples
+    ///
+    /// Water critical point temperature **\[K\]** and pressure **\[Pa\]**:
+    ///
+    /// ```
+    /// use approx::assert_relative_eq;
+    /// use rfluids::prelude::*;
+    ///
+    /// let res = CoolProp::props1_si_multi(&["Tcrit", "Pcrit"], "HEOS", &["Water"], &[1.0])?;
+    /// assert_relative_eq!(res[0], 647.096, max_relative = 1e-6);
+    /// assert_relative_eq!(res[1], 22_064_000.0, max_relative = 1e-6);
+    /// # Ok::<(), rfluids::native::CoolPropError>(())
+    /// ```
+    ///
+    /// # See Also
+    ///
+    /// - [`CoolProp::props1_si`]
+    pub fn props1_si_multi(
+        output_keys: &[impl AsRef<str>],
+        backend_name: impl AsRef<str>,
+        substance_names: &[impl AsRef<str>],
+        fractions: &[f64],
+    ) -> Result<Vec<f64>> {
+        if output_keys.is_empty() {
+            return Ok(Vec::new());
+        }
+        let len = output_keys.len();
+        let output_keys = c_string_joined("output_keys", output_keys)?;
+        let backend_name = c_string_trimmed("backend_name", backend_name)?;
+        let substance_names = c_string_joined("substance_names", substance_names)?;
+        let mut out = vec![0.0; len];
+        let mut rows = len as c_long;
+        let lock = lock_coolprop();
+        // Backend name is not modified by `CoolProp` despite the mutable pointer in the signature
+        ffi!("Props1SImulti", unsafe {
+            lock.Props1SImulti(
+                output_keys.as_ptr(),
+                backend_name.as_ptr().cast_mut(),
+                substance_names.as_ptr(),
+                fractions.as_ptr(),
+                fractions.len() as c_long,
+                out.as_mut_ptr(),
+                &raw mut rows,
+            );
+        });
+        multi_res(out, &[(rows, len)], &lock)
+    }
+
     /// Returns a phase state as a raw [`String`] depending on the thermodynamic state of the fluid.
     ///
     /// # Arguments
@@ -301,15 +490,95 @@ impl CoolProp {
             .replace("two_phase", "twophase");
         Ok(res)
     }
+
+    /// Returns a value on the saturation curve of the pure substance
+    /// calculated by its ancillary equation _(fast, but approximate)_.
+    ///
+    /// # Arguments
+    ///
+    /// - `output_key` -- key of the output _(raw [`&str`](str) or
+    ///   [`FluidParam`](crate::io::FluidParam), e.g., `"P"`, `"T"` or `"Dmolar"`)_
+    /// - `quality` -- vapor quality _(`0` for saturated liquid or `1` for saturated vapor)_
+    /// - `input_key` -- key of the input property _(raw [`&str`](str) or
+    ///   [`FluidParam`](crate::io::FluidParam), e.g., `"T"` or `"P"`)_
+    /// - `input_value` -- value of the input property **\[SI units\]**
+    /// - `substance_name` -- name of the pure substance _(raw [`&str`](str)
+    ///   without the backend name)_
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`CoolPropError`](crate::native::CoolPropError) for invalid inputs.
+    ///
+    /// # Examples
+    ///
+    /// Water saturation pressure at 373.15 K **\[Pa\]**:
+    ///
+    /// ```
+    /// use approx::assert_relative_eq;
+    /// use rfluids::prelude::*;
+    ///
+    /// let res = CoolProp::saturation_ancillary("P", 0, "T", 373.15, "Water")?;
+    /// assert_relative_eq!(res, 101_418.0, max_relative = 1e-3);
+    /// # Ok::<(), rfluids::native::CoolPropError>(())
+    /// ```
+    ///
+    /// # See Also
+    ///
+    /// - [`SaturationCurve`](crate::saturation::SaturationCurve)
+    pub fn saturation_ancillary(
+        output_key: impl AsRef<str>,
+        quality: u8,
+        input_key: impl AsRef<str>,
+        input_value: f64,
+        substance_name: impl AsRef<str>,
+    ) -> Result<f64> {
+        let output_key = c_string_trimmed("output_key", output_key)?;
+        let input_key = c_string_trimmed("input_key", input_key)?;
+        let substance_name = c_string_trimmed("substance_name", substance_name)?;
+        let lock = lock_coolprop();
+        let value = ffi!("saturation_ancillary", unsafe {
+            lock.saturation_ancillary(
+                substance_name.as_ptr(),
+                output_key.as_ptr(),
+                c_int::from(quality),
+                input_key.as_ptr(),
+                input_value,
+            )
+        });
+        res(value, &lock)
+    }
 }
 
-fn res(value: f64, lock: &MutexGuard<coolprop_sys::bindings::CoolProp>) -> Result<f64> {
+fn res(value: f64, lock: &MutexGuard<&coolprop_sys::bindings::CoolProp>) -> Result<f64> {
     if !value.is_finite() {
         return Err(get_error(lock).unwrap_or(CoolPropError::NonFiniteOutput));
     }
     Ok(value)
 }
 
+/// Joins the values with `&` _(list separator of `CoolProp` multi-value calls)_.
+fn c_string_joined(arg: &'static str, values: &[impl AsRef<str>]) -> Result<CString> {
+    let values: Vec<&str> = values.iter().map(|value| value.as_ref().trim()).collect();
+    c_string(arg, values.join("&"))
+}
+
+/// Checks the result dimensions reported by `CoolProp` _(they are zero on failure)_.
+fn multi_res(
+    mut out: Vec<f64>,
+    dims: &[(c_long, usize)],
+    lock: &MutexGuard<&coolprop_sys::bindings::CoolProp>,
+) -> Result<Vec<f64>> {
+    if dims.iter().any(|&(actual, expected)| actual as usize != expected) {
+        return Err(get_error(lock).unwrap_or_else(|| {
+            CoolPropError::Native(
+                "Error: CoolProp returned an empty result without a message".into(),
+            )
+        }));
+    }
+    out.iter_mut().filter(|value| !value.is_finite()).for_each(|value| *value = f64::NAN);
+    Ok(out)
+}
+
 #[cfg(test)]
 mod tests {
     use rayon::prelude::*;
@@ -406,6 +675,118 @@ mod tests {
         assert_eq!(res, CoolPropError::InteriorNul { arg: "substance_name", pos: 5 });
     }
 
+    #[test]
+    fn props_si_multi_water() {
+        // Given
+        let pressure = [101_325.0, 202_650.0, 101_325.0];
+        let temperature = [293.15, 313.15, 373.15];
+
+        // When
+        let res = CoolProp::props_si_multi(
+            &["D", "C"],
+            "P",
+            &pressure,
+            "T",
+            &temperature,
+            "HEOS",
+            &["Water"],
+            &[1.0],
+        )
+        .unwrap();
+
+        // Then
+        assert_eq!(res.len(), 6);
+        for (row, (p, t)) in res.chunks(2).zip(pressure.into_iter().zip(temperature)) {
+            assert_relative_eq!(row[0], CoolProp::props_si("D", "P", p, "T", t, "Water").unwrap());
+            assert_relative_eq!(row[1], CoolProp::props_si("C", "P", p, "T", t, "Water").unwrap());
+        }
+    }
+
+    #[test]
+    fn props_si_multi_invalid_state() {
+        // When
+        let res = CoolProp::props_si_multi(
+            &["D"],
+            "P",
+            &[101_325.0, -1.0],
+            "T",
+            &[293.15, 293.15],
+            "HEOS",
+            &["Water"],
+            &[1.0],
+        )
+        .unwrap();
+
+        // Then
+        assert_relative_eq!(res[0], 998.207_150_467_928_4);
+        assert!(res[1].is_nan());
+    }
+
+    #[test]
+    fn props_si_multi_invalid_substance() {
+        // When
+        let res = CoolProp::props_si_multi(
+            &["D"],
+            "P",
+            &[101_325.0],
+            "T",
+            &[293.15],
+            "HEOS",
+            &["Hello, World!"],
+            &[1.0],
+        );
+
+        // Then
+        assert!(res.is_err());
+    }
+
+    #[test]
+    fn props_si_multi_invalid_length() {
+        // When
+        let res = CoolProp::props_si_multi(
+            &["D"],
+            "P",
+            &[101_325.0],
+            "T",
+            &[293.15, 313.15],
+            "HEOS",
+            &["Water"],
+            &[1.0],
+        )
+        .unwrap_err();
+
+        // Then
+        assert_eq!(res, CoolPropError::InvalidLength { arg: "input2", expected: 1, actual: 2 });
+    }
+
+    #[test]
+    fn props_si_multi_empty_inputs() {
+        // When
+        let res = CoolProp::props_si_multi(&["D"], "P", &[], "T", &[], "HEOS", &["Water"], &[1.0]);
+
+        // Then
+        assert_eq!(res, Ok(Vec::new()));
+    }
+
+    #[test]
+    fn props_si_multi_interior_nul_output_keys() {
+        // When
+        let res = CoolProp::props_si_multi(
+            &["D", "C\0"],
+            "P",
+            &[101_325.0],
+            "T",
+            &[293.15],
+            "HEOS",
+            &["Water"],
+            &[1.0],
+        )
+        .unwrap_err();
+
+        // Then
+        assert_eq!(res, CoolPropError::InteriorNul { arg: "output_keys", pos: 3 });
+    }
+
     #[test]
     fn ha_props_si_thread_safety() {
         // Given
@@ -499,6 +880,26 @@ mod tests {
         assert_eq!(res, CoolPropError::InteriorNul { arg: "input3_key", pos: 1 });
     }
 
+    #[test]
+    fn saturation_ancillary_valid_input() {
+        // When
+        let pressure = CoolProp::saturation_ancillary("P", 0, "T", 373.124_3, "Water").unwrap();
+        let temperature = CoolProp::saturation_ancillary("T", 1, "P", 101_325.0, "Water").unwrap();
+
+        // Then
+        approx::assert_relative_eq!(pressure, 101_325.0, max_relative = 1e-3);
+        approx::assert_relative_eq!(temperature, 373.124_3, max_relative = 1e-3);
+    }
+
+    #[test]
+    fn saturation_ancillary_invalid_input() {
+        // When
+        let res = CoolProp::saturation_ancillary("P", 0, "T", 373.15, "Not a real fluid");
+
+        // Then
+        assert!(res.is_err());
+    }
+
     #[test]
     fn props1_si_valid_input() {
         // Given
@@ -551,6 +952,27 @@ mod tests {
         assert_eq!(res, CoolPropError::InteriorNul { arg: "substance_name", pos: 5 });
     }
 
+    #[test]
+    fn props1_si_multi_valid_input() {
+        // When
+        let res =
+            CoolProp::props1_si_multi(&["Tcrit", "Pcrit"], "HEOS", &["Water"], &[1.0]).unwrap();
+
+        // Then
+        assert_eq!(res.len(), 2);
+        assert_relative_eq!(res[0], CoolProp::props1_si("Tcrit", "Water").unwrap());
+        assert_relative_eq!(res[1], CoolProp::props1_si("Pcrit", "Water").unwrap());
+    }
+
+    #[test]
+    fn props1_si_multi_invalid_input() {
+        // When
+        let res = CoolProp::props1_si_multi(&["Tcrit"], "HEOS", &["Hello, World!"], &[1.0]);
+
+        // Then
+        assert!(res.is_err());
+    }
+
     #[test]
     fn phase_si_thread_safety() {
         // Given
@@ -609,7 +1031,7 @@ mod tests {
         let valid = 42.0;
 
         // When
-        let res = res(valid, &COOLPROP.lock().unwrap());
+        let res = res(valid, &lock_coolprop());
 
         // Then
         assert!(res.is_ok());
@@ -621,7 +1043,7 @@ mod tests {
         let invalid = f64::NAN;
 
         // When
-        let res = res(invalid, &COOLPROP.lock().unwrap()).unwrap_err();
+        let res = res(invalid, &lock_coolprop()).unwrap_err();
 
         // Then
         assert_eq!(res, CoolPropError::NonFiniteOutput);
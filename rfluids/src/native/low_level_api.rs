@@ -1,18 +1,51 @@
 use core::ffi::c_long;
-use std::borrow::Cow;
+use std::{borrow::Cow, marker::PhantomData, sync::Mutex};
 
-use coolprop_sys::COOLPROP;
+use coolprop_sys::COOLPROP_API;
 
 use super::{
     CoolPropError, Result,
-    common::{ErrorBuffer, c_string_trimmed},
+    common::{
+        ErrorBuffer, PhantomUnsync, c_string_trimmed, check_len, lock_coolprop, read_handles,
+        write_handles,
+    },
 };
-use crate::substance::{Substance, SubstanceWithBackend};
+use crate::{
+    metrics::ffi,
+    substance::{Substance, SubstanceWithBackend},
+};
+
+/// Maximum number of outputs calculated per batch FFI call.
+const BATCH_OUTPUTS: usize = 5;
+
+/// Maximum number of dropped native handles waiting to be freed.
+const MAX_PENDING_FREES: usize = 64;
+
+/// Native handles of the dropped [`AbstractState`] instances.
+///
+/// Freeing the native handle requires the exclusive lock of all handles,
+/// which would stall all parallel calls on every drop. Instead, handles are queued
+/// and freed in bulk under a single exclusive lock on the next handle creation
+/// or when the queue is full.
+///
+/// So up to `MAX_PENDING_FREES - 1` dropped handles _(and their native memory)_ are retained
+/// until the next handle creation, the exit of a thread with pooled handles
+/// or the explicit [`AbstractState::free_pending`] call.
+static PENDING_FREES: Mutex<Vec<c_long>> = Mutex::new(Vec::new());
 
 /// `CoolProp` thread safe low-level API.
+///
+/// Each instance owns its own native handle, so calls on different instances
+/// run in parallel without any global lock. It can be moved between threads,
+/// but it can't be shared between them _(it's [`Send`], but not [`Sync`])_,
+/// since even read-only calls (e.g., [`AbstractState::keyed_output`])
+/// mutate the native caches. Native handles of dropped instances are freed in bulk later
+/// _(on the next instance creation or when enough of them are dropped)_,
+/// so dropping doesn't stall parallel calls on other instances.
 #[derive(Debug)]
 pub struct AbstractState {
-    ptr: c_long,
+    pub(super) ptr: c_long,
+    marker: PhantomUnsync,
 }
 
 impl AbstractState {
@@ -74,16 +107,44 @@ impl AbstractState {
         let backend_name = c_string_trimmed("backend_name", backend_name)?;
         let composition_id = c_string_trimmed("composition_id", composition_id)?;
         let mut err = ErrorBuffer::default();
-        let ptr = unsafe {
-            COOLPROP.lock().unwrap().AbstractState_factory(
+        let lock = lock_coolprop();
+        let _handles = write_handles();
+        free_pending(&mut PENDING_FREES.lock().unwrap());
+        let ptr = ffi!("AbstractState_factory", unsafe {
+            lock.AbstractState_factory(
                 backend_name.as_ptr(),
                 composition_id.as_ptr(),
                 err.code_as_mut_ptr(),
-                err.message.as_mut_ptr(),
-                c_long::from(err.message.capacity()),
+                err.message_as_mut_ptr(),
+                err.message_capacity(),
             )
-        };
-        res(Self { ptr }, err)
+        });
+        res(Self { ptr, marker: PhantomData }, err)
+    }
+
+    /// Frees the native handles of all dropped instances right away.
+    ///
+    /// Dropped instances are freed lazily in bulk, so a few of them can be retained
+    /// until the next [`AbstractState::new`] call. It's useful to release their memory
+    /// when no more instances are going to be created _(e.g., at the end of a long job)_.
+    ///
+    /// # Examples
+    ///
+    /// ```
+    /// use rfluids::prelude::*;
+    ///
+    /// let water = AbstractState::new("HEOS", "Water")?;
+    /// drop(water);
+    /// AbstractState::free_pending();
+    /// # Ok::<(), rfluids::native::CoolPropError>(())
+    /// ```
+    pub fn free_pending() {
+        let mut ptrs = std::mem::take(&mut *PENDING_FREES.lock().unwrap());
+        if ptrs.is_empty() {
+            return;
+        }
+        let _handles = write_handles();
+        free_pending(&mut ptrs);
     }
 
     /// Set the fractions _(mole, mass or volume)_[^note].
@@ -125,16 +186,17 @@ impl AbstractState {
     /// ```
     pub fn set_fractions(&mut self, fractions: &[f64]) -> Result<()> {
         let mut err = ErrorBuffer::default();
-        unsafe {
-            COOLPROP.lock().unwrap().AbstractState_set_fractions(
+        let _handles = read_handles();
+        ffi!("AbstractState_set_fractions", unsafe {
+            COOLPROP_API.AbstractState_set_fractions(
                 self.ptr,
                 fractions.as_ptr(),
                 fractions.len() as c_long,
                 err.code_as_mut_ptr(),
-                err.message.as_mut_ptr(),
-                c_long::from(err.message.capacity()),
+                err.message_as_mut_ptr(),
+                err.message_capacity(),
             );
-        }
+        });
         res((), err)
     }
 
@@ -172,17 +234,18 @@ impl AbstractState {
         input2: f64,
     ) -> Result<()> {
         let mut err = ErrorBuffer::default();
-        unsafe {
-            COOLPROP.lock().unwrap().AbstractState_update(
+        let _handles = read_handles();
+        ffi!("AbstractState_update", unsafe {
+            COOLPROP_API.AbstractState_update(
                 self.ptr,
                 c_long::from(input_pair_key.into()),
                 input1,
                 input2,
                 err.code_as_mut_ptr(),
-                err.message.as_mut_ptr(),
-                c_long::from(err.message.capacity()),
+                err.message_as_mut_ptr(),
+                err.message_capacity(),
             );
-        }
+        });
         res((), err)
     }
 
@@ -255,18 +318,533 @@ impl AbstractState {
     pub fn keyed_output(&self, key: impl Into<u8>) -> Result<f64> {
         let mut err = ErrorBuffer::default();
         let key = key.into();
-        let value = unsafe {
-            COOLPROP.lock().unwrap().AbstractState_keyed_output(
+        let _handles = read_handles();
+        let value = ffi!("AbstractState_keyed_output", unsafe {
+            COOLPROP_API.AbstractState_keyed_output(
                 self.ptr,
                 c_long::from(key),
                 err.code_as_mut_ptr(),
-                err.message.as_mut_ptr(),
-                c_long::from(err.message.capacity()),
+                err.message_as_mut_ptr(),
+                err.message_capacity(),
             )
-        };
+        });
         keyed_output(key, value, err)
     }
 
+    /// Returns the first partial derivative of the output parameter
+    /// with respect to another parameter at a constant third parameter **\[SI units\]**,
+    /// i.e., `(∂Of/∂Wrt)_Constant`.
+    ///
+    /// It's evaluated analytically in the current state, so no additional state updates
+    /// are required _(unlike finite differences)_.
+    ///
+    /// # Arguments
+    ///
+    /// - `of` -- key of the parameter to differentiate _(raw [`u8`] or
+    ///   [`FluidParam`](crate::io::FluidParam))_
+    /// - `wrt` -- key of the parameter to differentiate with respect to _(raw [`u8`] or
+    ///   [`FluidParam`](crate::io::FluidParam))_
+    /// - `constant` -- key of the parameter held constant _(raw [`u8`] or
+    ///   [`FluidParam`](crate::io::FluidParam))_
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`CoolPropError`] for undefined state or invalid inputs.
+    ///
+    /// # Examples
+    ///
+    /// To calculate the specific heat **\[J/kg/K\]** of water at _1 atm_ and _20 °C_
+    /// as `(∂h/∂T)_p`:
+    ///
+    /// ```
+    /// use approx::assert_relative_eq;
+    /// use rfluids::prelude::*;
+    ///
+    /// let mut water = AbstractState::new("HEOS", "Water")?;
+    /// water.update(FluidInputPair::PT, 101_325.0, 293.15)?;
+    /// let res = water.first_partial_deriv(FluidParam::HMass, FluidParam::T, FluidParam::P)?;
+    /// assert_relative_eq!(res, 4_184.050_924_523_541, max_relative = 1e-6);
+    /// # Ok::<(), rfluids::native::CoolPropError>(())
+    /// ```
+    ///
+    /// # See Also
+    ///
+    /// - [Partial Derivatives](https://coolprop.org/coolprop/LowLevelAPI.html#partial-derivatives)
+    /// - [`FluidParam`](crate::io::FluidParam)
+    pub fn first_partial_deriv(
+        &self,
+        of: impl Into<u8>,
+        wrt: impl Into<u8>,
+        constant: impl Into<u8>,
+    ) -> Result<f64> {
+        let mut err = ErrorBuffer::default();
+        let of = of.into();
+        let _handles = read_handles();
+        let value = ffi!("AbstractState_first_partial_deriv", unsafe {
+            COOLPROP_API.AbstractState_first_partial_deriv(
+                self.ptr,
+                c_long::from(of),
+                c_long::from(wrt.into()),
+                c_long::from(constant.into()),
+                err.code_as_mut_ptr(),
+                err.message_as_mut_ptr(),
+                err.message_capacity(),
+            )
+        });
+        keyed_output(of, value, err)
+    }
+
+    /// Returns the second partial derivative of the output parameter **\[SI units\]**,
+    /// i.e., `(∂/∂Wrt2 (∂Of/∂Wrt1)_Constant1)_Constant2`.
+    ///
+    /// # Arguments
+    ///
+    /// - `of` -- key of the parameter to differentiate _(raw [`u8`] or
+    ///   [`FluidParam`](crate::io::FluidParam))_
+    /// - `wrt1` -- key of the parameter of the first differentiation
+    /// - `constant1` -- key of the parameter held constant during the first differentiation
+    /// - `wrt2` -- key of the parameter of the second differentiation
+    /// - `constant2` -- key of the parameter held constant during the second differentiation
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`CoolPropError`] for undefined state or invalid inputs.
+    ///
+    /// # Examples
+    ///
+    /// ```
+    /// use rfluids::prelude::*;
+    ///
+    /// let mut water = AbstractState::new("HEOS", "Water")?;
+    /// water.update(FluidInputPair::PT, 101_325.0, 293.15)?;
+    /// let res = water.second_partial_deriv(
+    ///     FluidParam::HMass,
+    ///     FluidParam::T,
+    ///     FluidParam::P,
+    ///     FluidParam::T,
+    ///     FluidParam::P,
+    /// );
+    /// assert!(res.is_ok());
+    /// # Ok::<(), rfluids::native::CoolPropError>(())
+    /// ```
+    ///
+    /// # See Also
+    ///
+    /// - [Partial Derivatives](https://coolprop.org/coolprop/LowLevelAPI.html#partial-derivatives)
+    /// - [`FluidParam`](crate::io::FluidParam)
+    pub fn second_partial_deriv(
+        &self,
+        of: impl Into<u8>,
+        wrt1: impl Into<u8>,
+        constant1: impl Into<u8>,
+        wrt2: impl Into<u8>,
+        constant2: impl Into<u8>,
+    ) -> Result<f64> {
+        let mut err = ErrorBuffer::default();
+        let of = of.into();
+        let _handles = read_handles();
+        let value = ffi!("AbstractState_second_partial_deriv", unsafe {
+            COOLPROP_API.AbstractState_second_partial_deriv(
+                self.ptr,
+                c_long::from(of),
+                c_long::from(wrt1.into()),
+                c_long::from(constant1.into()),
+                c_long::from(wrt2.into()),
+                c_long::from(constant2.into()),
+                err.code_as_mut_ptr(),
+                err.message_as_mut_ptr(),
+                err.message_capacity(),
+            )
+        });
+        keyed_output(of, value, err)
+    }
+
+    /// Returns the first derivative of the output parameter along the saturation curve
+    /// **\[SI units\]**, i.e., `(dOf/dWrt)_σ`.
+    ///
+    /// # Arguments
+    ///
+    /// - `of` -- key of the parameter to differentiate _(raw [`u8`] or
+    ///   [`FluidParam`](crate::io::FluidParam))_
+    /// - `wrt` -- key of the parameter to differentiate with respect to _(raw [`u8`] or
+    ///   [`FluidParam`](crate::io::FluidParam))_
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`CoolPropError`] for undefined or non-saturated state or invalid inputs.
+    ///
+    /// # Examples
+    ///
+    /// To calculate the slope of the water saturation curve **\[K/Pa\]** at _1 atm_:
+    ///
+    /// ```
+    /// use rfluids::prelude::*;
+    ///
+    /// let mut water = AbstractState::new("HEOS", "Water")?;
+    /// water.update(FluidInputPair::PQ, 101_325.0, 1.0)?;
+    /// let res = water.first_saturation_deriv(FluidParam::T, FluidParam::P)?;
+    /// assert!(res > 0.0);
+    /// # Ok::<(), rfluids::native::CoolPropError>(())
+    /// ```
+    ///
+    /// # See Also
+    ///
+    /// - [Partial Derivatives](https://coolprop.org/coolprop/LowLevelAPI.html#partial-derivatives)
+    /// - [`FluidParam`](crate::io::FluidParam)
+    pub fn first_saturation_deriv(&self, of: impl Into<u8>, wrt: impl Into<u8>) -> Result<f64> {
+        let mut err = ErrorBuffer::default();
+        let of = of.into();
+        let _handles = read_handles();
+        let value = ffi!("AbstractState_first_saturation_deriv", unsafe {
+            COOLPROP_API.AbstractState_first_saturation_deriv(
+                self.ptr,
+                c_long::from(of),
+                c_long::from(wrt.into()),
+                err.code_as_mut_ptr(),
+                err.message_as_mut_ptr(),
+                err.message_capacity(),
+            )
+        });
+        keyed_output(of, value, err)
+    }
+
+    /// Returns the first partial derivative of the output parameter in the two-phase region
+    /// **\[SI units\]**, i.e., `(∂Of/∂Wrt)_Constant`.
+    ///
+    /// # Arguments
+    ///
+    /// - `of` -- key of the parameter to differentiate _(raw [`u8`] or
+    ///   [`FluidParam`](crate::io::FluidParam))_
+    /// - `wrt` -- key of the parameter to differentiate with respect to _(raw [`u8`] or
+    ///   [`FluidParam`](crate::io::FluidParam))_
+    /// - `constant` -- key of the parameter held constant _(raw [`u8`] or
+    ///   [`FluidParam`](crate::io::FluidParam))_
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`CoolPropError`] for undefined or non-two-phase state or invalid inputs.
+    ///
+    /// # Examples
+    ///
+    /// ```
+    /// use rfluids::prelude::*;
+    ///
+    /// let mut water = AbstractState::new("HEOS", "Water")?;
+    /// water.update(FluidInputPair::PQ, 101_325.0, 0.5)?;
+    /// let res = water.first_two_phase_deriv(FluidParam::DMass, FluidParam::HMass, FluidParam::P);
+    /// assert!(res.is_ok());
+    /// # Ok::<(), rfluids::native::CoolPropError>(())
+    /// ```
+    ///
+    /// # See Also
+    ///
+    /// - [Two-Phase Derivatives](https://coolprop.org/coolprop/LowLevelAPI.html#two-phase-and-saturation-derivatives)
+    /// - [`AbstractState::first_two_phase_deriv_splined`]
+    /// - [`FluidParam`](crate::io::FluidParam)
+    pub fn first_two_phase_deriv(
+        &self,
+        of: impl Into<u8>,
+        wrt: impl Into<u8>,
+        constant: impl Into<u8>,
+    ) -> Result<f64> {
+        let mut err = ErrorBuffer::default();
+        let of = of.into();
+        let _handles = read_handles();
+        let value = ffi!("AbstractState_first_two_phase_deriv", unsafe {
+            COOLPROP_API.AbstractState_first_two_phase_deriv(
+                self.ptr,
+                c_long::from(of),
+                c_long::from(wrt.into()),
+                c_long::from(constant.into()),
+                err.code_as_mut_ptr(),
+                err.message_as_mut_ptr(),
+                err.message_capacity(),
+            )
+        });
+        keyed_output(of, value, err)
+    }
+
+    /// Returns the first partial derivative of the output parameter in the two-phase region
+    /// **\[SI units\]** smoothed by a spline near the saturated liquid state,
+    /// i.e., `(∂Of/∂Wrt)_Constant`.
+    ///
+    /// Unlike [`AbstractState::first_two_phase_deriv`], it remains continuous
+    /// for vapor qualities below `x_end`.
+    ///
+    /// # Arguments
+    ///
+    /// - `of` -- key of the parameter to differentiate _(raw [`u8`] or
+    ///   [`FluidParam`](crate::io::FluidParam))_
+    /// - `wrt` -- key of the parameter to differentiate with respect to _(raw [`u8`] or
+    ///   [`FluidParam`](crate::io::FluidParam))_
+    /// - `constant` -- key of the parameter held constant _(raw [`u8`] or
+    ///   [`FluidParam`](crate::io::FluidParam))_
+    /// - `x_end` -- vapor quality at the end of the spline **\[dimensionless, from 0 to 1\]**
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`CoolPropError`] for undefined or non-two-phase state or invalid inputs.
+    ///
+    /// # Examples
+    ///
+    /// ```
+    /// use rfluids::prelude::*;
+    ///
+    /// let mut water = AbstractState::new("HEOS", "Water")?;
+    /// water.update(FluidInputPair::PQ, 101_325.0, 0.05)?;
+    /// let res = water.first_two_phase_deriv_splined(
+    ///     FluidParam::DMass,
+    ///     FluidParam::HMass,
+    ///     FluidParam::P,
+    ///     0.1,
+    /// );
+    /// assert!(res.is_ok());
+    /// # Ok::<(), rfluids::native::CoolPropError>(())
+    /// ```
+    ///
+    /// # See Also
+    ///
+    /// - [Two-Phase Derivatives](https://coolprop.org/coolprop/LowLevelAPI.html#two-phase-and-saturation-derivatives)
+    /// - [`AbstractState::first_two_phase_deriv`]
+    /// - [`FluidParam`](crate::io::FluidParam)
+    pub fn first_two_phase_deriv_splined(
+        &self,
+        of: impl Into<u8>,
+        wrt: impl Into<u8>,
+        constant: impl Into<u8>,
+        x_end: f64,
+    ) -> Result<f64> {
+        let mut err = ErrorBuffer::default();
+        let of = of.into();
+        let _handles = read_handles();
+        let value = ffi!("AbstractState_first_two_phase_deriv_splined", unsafe {
+            COOLPROP_API.AbstractState_first_two_phase_deriv_splined(
+                self.ptr,
+                c_long::from(of),
+                c_long::from(wrt.into()),
+                c_long::from(constant.into()),
+                x_end,
+                err.code_as_mut_ptr(),
+                err.message_as_mut_ptr(),
+                err.message_capacity(),
+            )
+        });
+        keyed_output(of, value, err)
+    }
+
+    /// Returns an output parameter value of the saturated liquid **\[SI units\]**
+    /// for the current two-phase state, without any additional state updates.
+    ///
+    /// # Arguments
+    ///
+    /// - `key` -- output parameter key _(raw [`u8`] or [`FluidParam`](crate::io::FluidParam))_
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`CoolPropError`] for undefined or non-two-phase state or invalid inputs.
+    ///
+    /// # Examples
+    ///
+    /// ```
+    /// use approx::assert_relative_eq;
+    /// use rfluids::prelude::*;
+    ///
+    /// let mut water = AbstractState::new("HEOS", "Water")?;
+    /// water.update(FluidInputPair::PQ, 101_325.0, 0.5)?;
+    /// let res = water.saturated_liquid_keyed_output(FluidParam::DMass)?;
+    /// water.update(FluidInputPair::PQ, 101_325.0, 0.0)?;
+    /// assert_relative_eq!(res, water.keyed_output(FluidParam::DMass)?, max_relative = 1e-6);
+    /// # Ok::<(), rfluids::native::CoolPropError>(())
+    /// ```
+    ///
+    /// # See Also
+    ///
+    /// - [`AbstractState::saturated_vapor_keyed_output`]
+    /// - [`FluidParam`](crate::io::FluidParam)
+    pub fn saturated_liquid_keyed_output(&self, key: impl Into<u8>) -> Result<f64> {
+        let mut err = ErrorBuffer::default();
+        let key = key.into();
+        let _handles = read_handles();
+        let value = ffi!("AbstractState_saturated_liquid_keyed_output", unsafe {
+            COOLPROP_API.AbstractState_saturated_liquid_keyed_output(
+                self.ptr,
+                c_long::from(key),
+                err.code_as_mut_ptr(),
+                err.message_as_mut_ptr(),
+                err.message_capacity(),
+            )
+        });
+        keyed_output(key, value, err)
+    }
+
+    /// Returns an output parameter value of the saturated vapor **\[SI units\]**
+    /// for the current two-phase state, without any additional state updates.
+    ///
+    /// # Arguments
+    ///
+    /// - `key` -- output parameter key _(raw [`u8`] or [`FluidParam`](crate::io::FluidParam))_
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`CoolPropError`] for undefined or non-two-phase state or invalid inputs.
+    ///
+    /// # Examples
+    ///
+    /// ```
+    /// use approx::assert_relative_eq;
+    /// use rfluids::prelude::*;
+    ///
+    /// let mut water = AbstractState::new("HEOS", "Water")?;
+    /// water.update(FluidInputPair::PQ, 101_325.0, 0.5)?;
+    /// let res = water.saturated_vapor_keyed_output(FluidParam::CpMass)?;
+    /// assert_relative_eq!(res, 2_079.937_085_633_241, max_relative = 1e-6);
+    /// # Ok::<(), rfluids::native::CoolPropError>(())
+    /// ```
+    ///
+    /// # See Also
+    ///
+    /// - [`AbstractState::saturated_liquid_keyed_output`]
+    /// - [`FluidParam`](crate::io::FluidParam)
+    pub fn saturated_vapor_keyed_output(&self, key: impl Into<u8>) -> Result<f64> {
+        let mut err = ErrorBuffer::default();
+        let key = key.into();
+        let _handles = read_handles();
+        let value = ffi!("AbstractState_saturated_vapor_keyed_output", unsafe {
+            COOLPROP_API.AbstractState_saturated_vapor_keyed_output(
+                self.ptr,
+                c_long::from(key),
+                err.code_as_mut_ptr(),
+                err.message_as_mut_ptr(),
+                err.message_capacity(),
+            )
+        });
+        keyed_output(key, value, err)
+    }
+
+    /// Update the state of the fluid for each pair of input values and calculate
+    /// the specified output parameters for each of them, crossing the FFI boundary
+    /// only once for every 5 output parameters.
+    ///
+    /// Results are written into `out` in column-major order, i.e., the value of the `j`-th
+    /// output parameter for the `i`-th state is written into `out[j * input1.len() + i]`.
+    /// If the update or output calculation fails for some state, the corresponding output values
+    /// are set to [`f64::NAN`]. After the call, the instance remains in the last state.
+    ///
+    /// # Arguments
+    ///
+    /// - `input_pair_key` -- input pair key _(raw [`u8`] or
+    ///   [`FluidInputPair`](crate::io::FluidInputPair))_
+    /// - `input1` -- values of the first input property **\[SI units\]**
+    /// - `input2` -- values of the second input property **\[SI units\]**
+    ///   _(should have the same length as `input1`)_
+    /// - `output_keys` -- output parameter keys _(raw [`u8`] or
+    ///   [`FluidParam`](crate::io::FluidParam))_
+    /// - `out` -- output buffer **\[SI units\]**
+    ///   _(should have length `input1.len() * output_keys.len()`)_
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`CoolPropError`] for inputs or output buffer of invalid length
+    /// or if `CoolProp` is unable to process the batch at all.
+    ///
+    /// # Examples
+    ///
+    /// ```
+    /// use approx::assert_relative_eq;
+    /// use rfluids::prelude::*;
+    ///
+    /// let mut water = AbstractState::new("HEOS", "Water")?;
+    /// let mut out = [0.0; 4];
+    /// water.update_batch(
+    ///     FluidInputPair::PT,
+    ///     &[101_325.0, 101_325.0],
+    ///     &[293.15, 313.15],
+    ///     &[FluidParam::DMass, FluidParam::CpMass],
+    ///     &mut out,
+    /// )?;
+    /// assert_relative_eq!(out[0], 998.207_150_467_928_4, max_relative = 1e-6);
+    /// assert_relative_eq!(out[2], 4_184.050_924_523_541, max_relative = 1e-6);
+    /// # Ok::<(), rfluids::native::CoolPropError>(())
+    /// ```
+    ///
+    /// # See Also
+    ///
+    /// - [`AbstractState::update`]
+    /// - [`AbstractState::keyed_output`]
+    /// - [`FluidInputPair`](crate::io::FluidInputPair)
+    /// - [`FluidParam`](crate::io::FluidParam)
+    pub fn update_batch<K: Copy + Into<u8>>(
+        &mut self,
+        input_pair_key: impl Into<u8>,
+        input1: &[f64],
+        input2: &[f64],
+        output_keys: &[K],
+        out: &mut [f64],
+    ) -> Result<()> {
+        let len = input1.len();
+        check_len("input2", len, input2.len())?;
+        check_len("out", len * output_keys.len(), out.len())?;
+        if len == 0 || output_keys.is_empty() {
+            return Ok(());
+        }
+        let input_pair_key = c_long::from(input_pair_key.into());
+        let base = out.as_mut_ptr();
+        for (chunk_idx, keys) in output_keys.chunks(BATCH_OUTPUTS).enumerate() {
+            let mut columns = [base; BATCH_OUTPUTS];
+            for (slot, column) in columns.iter_mut().enumerate().take(keys.len()) {
+                // SAFETY: `out` length is checked above
+                *column = unsafe { base.add((chunk_idx * BATCH_OUTPUTS + slot) * len) };
+            }
+            self.update_batch_chunk(input_pair_key, input1, input2, keys, &columns)?;
+        }
+        out.iter_mut().filter(|value| !value.is_finite()).for_each(|value| *value = f64::NAN);
+        Ok(())
+    }
+
+    /// Same as [`AbstractState::update_batch`], but writes the values of each output
+    /// parameter into its own separate column, so the callers that store outputs
+    /// in non-contiguous buffers _(e.g., chunks of wider columns)_ don't need
+    /// any intermediate buffer.
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`CoolPropError`] for inputs or output columns of invalid length
+    /// or if `CoolProp` is unable to process the batch at all.
+    pub(crate) fn update_batch_columns<K: Copy + Into<u8>>(
+        &mut self,
+        input_pair_key: impl Into<u8>,
+        input1: &[f64],
+        input2: &[f64],
+        output_keys: &[K],
+        columns: &mut [&mut [f64]],
+    ) -> Result<()> {
+        let len = input1.len();
+        check_len("input2", len, input2.len())?;
+        check_len("columns", output_keys.len(), columns.len())?;
+        for column in columns.iter() {
+            check_len("column", len, column.len())?;
+        }
+        if len == 0 || output_keys.is_empty() {
+            return Ok(());
+        }
+        let input_pair_key = c_long::from(input_pair_key.into());
+        for (keys, chunk) in
+            output_keys.chunks(BATCH_OUTPUTS).zip(columns.chunks_mut(BATCH_OUTPUTS))
+        {
+            let mut ptrs = [std::ptr::null_mut(); BATCH_OUTPUTS];
+            for (ptr, column) in ptrs.iter_mut().zip(chunk.iter_mut()) {
+                *ptr = column.as_mut_ptr();
+            }
+            self.update_batch_chunk(input_pair_key, input1, input2, keys, &ptrs)?;
+        }
+        columns
+            .iter_mut()
+            .flat_map(|column| column.iter_mut())
+            .filter(|value| !value.is_finite())
+            .for_each(|value| *value = f64::NAN);
+        Ok(())
+    }
+
     /// Specify the phase state for all further calculations.
     ///
     /// # Arguments
@@ -299,15 +877,16 @@ impl AbstractState {
     pub fn specify_phase(&mut self, phase: impl AsRef<str>) -> Result<()> {
         let phase = c_string_trimmed("phase", phase)?;
         let mut err = ErrorBuffer::default();
-        unsafe {
-            COOLPROP.lock().unwrap().AbstractState_specify_phase(
+        let _handles = read_handles();
+        ffi!("AbstractState_specify_phase", unsafe {
+            COOLPROP_API.AbstractState_specify_phase(
                 self.ptr,
                 phase.as_ptr(),
                 err.code_as_mut_ptr(),
-                err.message.as_mut_ptr(),
-                c_long::from(err.message.capacity()),
+                err.message_as_mut_ptr(),
+                err.message_capacity(),
             );
-        }
+        });
         res((), err)
     }
 
@@ -333,14 +912,73 @@ impl AbstractState {
     /// - [Imposing the Phase (Optional)](https://coolprop.org/coolprop/HighLevelAPI.html#imposing-the-phase-optional)
     pub fn unspecify_phase(&mut self) {
         let mut err = ErrorBuffer::blank();
-        unsafe {
-            COOLPROP.lock().unwrap().AbstractState_unspecify_phase(
+        let _handles = read_handles();
+        ffi!("AbstractState_unspecify_phase", unsafe {
+            COOLPROP_API.AbstractState_unspecify_phase(
                 self.ptr,
                 err.code_as_mut_ptr(),
-                err.message.as_mut_ptr(),
-                c_long::from(err.message.capacity()),
+                err.message_as_mut_ptr(),
+                err.message_capacity(),
             );
+        });
+    }
+
+    fn update_batch_chunk<K: Copy + Into<u8>>(
+        &mut self,
+        input_pair_key: c_long,
+        input1: &[f64],
+        input2: &[f64],
+        keys: &[K],
+        columns: &[*mut f64; BATCH_OUTPUTS],
+    ) -> Result<()> {
+        let len = input1.len();
+        let mut err = ErrorBuffer::default();
+        let _handles = read_handles();
+        if let [key] = keys {
+            ffi!("AbstractState_update_and_1_out", unsafe {
+                COOLPROP_API.AbstractState_update_and_1_out(
+                    self.ptr,
+                    input_pair_key,
+                    input1.as_ptr(),
+                    input2.as_ptr(),
+                    len as c_long,
+                    c_long::from((*key).into()),
+                    columns[0],
+                    err.code_as_mut_ptr(),
+                    err.message_as_mut_ptr(),
+                    err.message_capacity(),
+                );
+            });
+            return res((), err);
+        }
+        // Unused slots repeat the last requested output,
+        // so no additional buffers are required
+        let mut raw_keys: [c_long; BATCH_OUTPUTS] = [0; BATCH_OUTPUTS];
+        let mut ptrs: [*mut f64; BATCH_OUTPUTS] = [std::ptr::null_mut(); BATCH_OUTPUTS];
+        for slot in 0..BATCH_OUTPUTS {
+            let idx = slot.min(keys.len() - 1);
+            raw_keys[slot] = c_long::from(keys[idx].into());
+            ptrs[slot] = columns[idx];
         }
+        ffi!("AbstractState_update_and_5_out", unsafe {
+            COOLPROP_API.AbstractState_update_and_5_out(
+                self.ptr,
+                input_pair_key,
+                input1.as_ptr(),
+                input2.as_ptr(),
+                len as c_long,
+                raw_keys.as_mut_ptr(),
+                ptrs[0],
+                ptrs[1],
+                ptrs[2],
+                ptrs[3],
+                ptrs[4],
+                err.code_as_mut_ptr(),
+                err.message_as_mut_ptr(),
+                err.message_capacity(),
+            );
+        });
+        res((), err)
     }
 }
 
@@ -348,26 +986,7 @@ impl TryFrom<&SubstanceWithBackend> for AbstractState {
     type Error = CoolPropError;
 
     fn try_from(value: &SubstanceWithBackend) -> Result<Self> {
-        let (component_names, fractions): (Cow<'static, str>, Option<Vec<f64>>) =
-            match &value.substance {
-                Substance::Pure(pure) => (Cow::Borrowed(pure.into()), None),
-                Substance::IncompPure(incomp_pure) => (Cow::Borrowed(incomp_pure.into()), None),
-                Substance::PredefinedMix(predefined_mix) => {
-                    (Cow::Borrowed(predefined_mix.into()), None)
-                }
-                Substance::BinaryMix(binary_mix) => {
-                    (Cow::Borrowed(binary_mix.kind.into()), Some(vec![binary_mix.fraction]))
-                }
-                Substance::CustomMix(custom_mix) => {
-                    let mix = custom_mix.clone().into_mole_based();
-                    let (components, fractions): (Vec<&str>, Vec<f64>) = mix
-                        .components()
-                        .iter()
-                        .map(|component| (component.0.as_ref(), component.1))
-                        .unzip();
-                    (Cow::Owned(components.join("&")), Some(fractions))
-                }
-            };
+        let (component_names, fractions) = composition(&value.substance);
         let mut backend = AbstractState::new(value.backend.name(), component_names)?;
         if let Some(fractions) = fractions {
             backend.set_fractions(&fractions).unwrap();
@@ -376,21 +995,60 @@ impl TryFrom<&SubstanceWithBackend> for AbstractState {
     }
 }
 
+/// Returns names of the substance components separated by the `&` symbol
+/// and their fractions _(if required)_ in the form expected by [`AbstractState`].
+pub(crate) fn composition(substance: &Substance) -> (Cow<'static, str>, Option<Vec<f64>>) {
+    match substance {
+        Substance::Pure(pure) => (Cow::Borrowed(pure.into()), None),
+        Substance::IncompPure(incomp_pure) => (Cow::Borrowed(incomp_pure.into()), None),
+        Substance::PredefinedMix(predefined_mix) => (Cow::Borrowed(predefined_mix.into()), None),
+        Substance::BinaryMix(binary_mix) => {
+            (Cow::Borrowed(binary_mix.kind.into()), Some(vec![binary_mix.fraction]))
+        }
+        Substance::CustomMix(custom_mix) => {
+            let mix = custom_mix.clone().into_mole_based();
+            let (components, fractions): (Vec<&str>, Vec<f64>) = mix
+                .components()
+                .iter()
+                .map(|component| (component.0.as_ref(), component.1))
+                .unzip();
+            (Cow::Owned(components.join("&")), Some(fractions))
+        }
+    }
+}
+
 impl Drop for AbstractState {
     fn drop(&mut self) {
+        let mut pending = PENDING_FREES.lock().unwrap();
+        pending.push(self.ptr);
+        if pending.len() < MAX_PENDING_FREES {
+            return;
+        }
+        let mut ptrs = std::mem::take(&mut *pending);
+        // The queue is released first, so the exclusive lock
+        // is always acquired before the queue lock
+        drop(pending);
+        let _handles = write_handles();
+        free_pending(&mut ptrs);
+    }
+}
+
+/// Frees the queued native handles _(the exclusive lock of all handles must be held)_.
+fn free_pending(ptrs: &mut Vec<c_long>) {
+    for ptr in ptrs.drain(..) {
         let mut err = ErrorBuffer::blank();
-        unsafe {
-            COOLPROP.lock().unwrap().AbstractState_free(
-                self.ptr,
+        ffi!("AbstractState_free", unsafe {
+            COOLPROP_API.AbstractState_free(
+                ptr,
                 err.code_as_mut_ptr(),
-                err.message.as_mut_ptr(),
-                c_long::from(err.message.capacity()),
+                err.message_as_mut_ptr(),
+                err.message_capacity(),
             );
-        }
+        });
     }
 }
 
-fn res<T>(value: T, err: ErrorBuffer) -> Result<T> {
+pub(super) fn res<T>(value: T, err: ErrorBuffer) -> Result<T> {
     let err: Option<CoolPropError> = err.into();
     err.map_or(Ok(value), Err)
 }
@@ -414,6 +1072,36 @@ mod tests {
         test::assert_relative_eq,
     };
 
+    #[test]
+    fn drop_frees_native_handles_in_bulk() {
+        // Given
+        let states: Vec<_> = (0..2 * MAX_PENDING_FREES)
+            .map(|_| AbstractState::new("HEOS", "Water").unwrap())
+            .collect();
+
+        // When
+        drop(states);
+
+        // Then
+        assert!(PENDING_FREES.lock().unwrap().len() < MAX_PENDING_FREES);
+        let mut sut = AbstractState::new("HEOS", "Water").unwrap();
+        assert!(sut.update(FluidInputPair::PT, 101_325.0, 293.15).is_ok());
+    }
+
+    #[test]
+    fn free_pending() {
+        // Given
+        let state = AbstractState::new("HEOS", "Water").unwrap();
+        let ptr = state.ptr;
+        drop(state);
+
+        // When
+        AbstractState::free_pending();
+
+        // Then
+        assert!(!PENDING_FREES.lock().unwrap().contains(&ptr));
+    }
+
     #[test]
     fn thread_safety() {
         // Given
@@ -555,6 +1243,170 @@ mod tests {
         );
     }
 
+    #[rstest]
+    #[case(&[FluidParam::DMass])]
+    #[case(&[FluidParam::DMass, FluidParam::CpMass, FluidParam::HMass])]
+    #[case(&[
+        FluidParam::DMass,
+        FluidParam::CpMass,
+        FluidParam::HMass,
+        FluidParam::SMass,
+        FluidParam::Conductivity,
+        FluidParam::DynamicViscosity,
+        FluidParam::Prandtl,
+    ])]
+    fn update_batch_valid_inputs(#[case] output_keys: &[FluidParam]) {
+        // Given
+        let pressures = [101_325.0, 202_650.0, 405_300.0];
+        let temperatures = [293.15, 313.15, 353.15];
+        let mut out = vec![0.0; pressures.len() * output_keys.len()];
+        let mut sut = AbstractState::new("HEOS", "Water").unwrap();
+        let mut expected = AbstractState::new("HEOS", "Water").unwrap();
+
+        // When
+        sut.update_batch(FluidInputPair::PT, &pressures, &temperatures, output_keys, &mut out)
+            .unwrap();
+
+        // Then
+        for (i, (p, t)) in pressures.into_iter().zip(temperatures).enumerate() {
+            expected.update(FluidInputPair::PT, p, t).unwrap();
+            for (j, key) in output_keys.iter().enumerate() {
+                assert_relative_eq!(
+                    out[j * pressures.len() + i],
+                    expected.keyed_output(*key).unwrap()
+                );
+            }
+        }
+    }
+
+    #[test]
+    fn update_batch_invalid_state() {
+        // Given
+        let mut out = [0.0; 4];
+        let mut sut = AbstractState::new("HEOS", "Water").unwrap();
+
+        // When
+        sut.update_batch(
+            FluidInputPair::PT,
+            &[101_325.0, -1.0],
+            &[293.15, 293.15],
+            &[FluidParam::DMass, FluidParam::CpMass],
+            &mut out,
+        )
+        .unwrap();
+
+        // Then
+        assert_relative_eq!(out[0], 998.207_150_467_928_4);
+        assert!(out[1].is_nan());
+        assert_relative_eq!(out[2], 4_184.050_924_523_541);
+        assert!(out[3].is_nan());
+    }
+
+    #[test]
+    fn update_batch_invalid_inputs_length() {
+        // Given
+        let mut out = [0.0; 2];
+        let mut sut = AbstractState::new("HEOS", "Water").unwrap();
+
+        // When
+        let res = sut
+            .update_batch(
+                FluidInputPair::PT,
+                &[101_325.0, 202_650.0],
+                &[293.15],
+                &[FluidParam::DMass],
+                &mut out,
+            )
+            .unwrap_err();
+
+        // Then
+        assert_eq!(res, CoolPropError::InvalidLength { arg: "input2", expected: 2, actual: 1 });
+    }
+
+    #[test]
+    fn update_batch_invalid_out_length() {
+        // Given
+        let mut out = [0.0; 3];
+        let mut sut = AbstractState::new("HEOS", "Water").unwrap();
+
+        // When
+        let res = sut
+            .update_batch(
+                FluidInputPair::PT,
+                &[101_325.0],
+                &[293.15],
+                &[FluidParam::DMass, FluidParam::CpMass],
+                &mut out,
+            )
+            .unwrap_err();
+
+        // Then
+        assert_eq!(res, CoolPropError::InvalidLength { arg: "out", expected: 2, actual: 3 });
+    }
+
+    #[test]
+    fn update_batch_columns_matches_update_batch() {
+        // Given
+        let output_keys = [
+            FluidParam::DMass,
+            FluidParam::CpMass,
+            FluidParam::HMass,
+            FluidParam::SMass,
+            FluidParam::Conductivity,
+            FluidParam::DynamicViscosity,
+            FluidParam::Prandtl,
+        ];
+        let pressures = [101_325.0, 202_650.0, 405_300.0];
+        let temperatures = [293.15, 313.15, 353.15];
+        let mut expected = vec![0.0; pressures.len() * output_keys.len()];
+        let mut buffers = vec![vec![0.0; pressures.len()]; output_keys.len()];
+        let mut sut = AbstractState::new("HEOS", "Water").unwrap();
+        sut.update_batch(
+            FluidInputPair::PT,
+            &pressures,
+            &temperatures,
+            &output_keys,
+            &mut expected,
+        )
+        .unwrap();
+
+        // When
+        let mut columns: Vec<_> = buffers.iter_mut().map(Vec::as_mut_slice).collect();
+        sut.update_batch_columns(
+            FluidInputPair::PT,
+            &pressures,
+            &temperatures,
+            &output_keys,
+            &mut columns,
+        )
+        .unwrap();
+
+        // Then
+        assert_eq!(buffers.concat(), expected);
+    }
+
+    #[test]
+    fn update_batch_columns_invalid_column_length() {
+        // Given
+        let mut density = [0.0; 2];
+        let mut heat_capacity = [0.0; 1];
+        let mut sut = AbstractState::new("HEOS", "Water").unwrap();
+
+        // When
+        let res = sut
+            .update_batch_columns(
+                FluidInputPair::PT,
+                &[101_325.0, 202_650.0],
+                &[293.15, 313.15],
+                &[FluidParam::DMass, FluidParam::CpMass],
+                &mut [&mut density, &mut heat_capacity],
+            )
+            .unwrap_err();
+
+        // Then
+        assert_eq!(res, CoolPropError::InvalidLength { arg: "column", expected: 2, actual: 1 });
+    }
+
     #[test]
     fn keyed_output_valid_state() {
         // Given
@@ -598,6 +1450,141 @@ mod tests {
         assert_eq!(res, CoolPropError::NonFiniteKeyedOutput { key: 39 });
     }
 
+    #[test]
+    fn first_partial_deriv_valid_state() {
+        // Given
+        let mut sut = AbstractState::new("HEOS", "Water").unwrap();
+        sut.update(FluidInputPair::PT, 101_325.0, 293.15).unwrap();
+
+        // When
+        let res = sut.first_partial_deriv(FluidParam::HMass, FluidParam::T, FluidParam::P).unwrap();
+
+        // Then
+        assert_relative_eq!(res, sut.keyed_output(FluidParam::CpMass).unwrap());
+    }
+
+    #[test]
+    fn first_partial_deriv_not_defined_state() {
+        // Given
+        let sut = AbstractState::new("HEOS", "Water").unwrap();
+
+        // When
+        let res = sut.first_partial_deriv(FluidParam::HMass, FluidParam::T, FluidParam::P);
+
+        // Then
+        assert!(res.is_err());
+    }
+
+    #[test]
+    fn second_partial_deriv_valid_state() {
+        // Given
+        let mut sut = AbstractState::new("HEOS", "Water").unwrap();
+        sut.update(FluidInputPair::PT, 101_325.0, 293.15).unwrap();
+
+        // When
+        let res = sut.second_partial_deriv(
+            FluidParam::HMass,
+            FluidParam::T,
+            FluidParam::P,
+            FluidParam::T,
+            FluidParam::P,
+        );
+
+        // Then
+        assert!(res.is_ok());
+    }
+
+    #[test]
+    fn first_saturation_deriv_valid_state() {
+        // Given
+        let mut sut = AbstractState::new("HEOS", "Water").unwrap();
+        sut.update(FluidInputPair::PQ, 101_325.0, 1.0).unwrap();
+        let temperature = sut.keyed_output(FluidParam::T).unwrap();
+        let vapor =
+            [FluidParam::DMass, FluidParam::HMass].map(|key| sut.keyed_output(key).unwrap());
+        sut.update(FluidInputPair::PQ, 101_325.0, 0.0).unwrap();
+        let liquid =
+            [FluidParam::DMass, FluidParam::HMass].map(|key| sut.keyed_output(key).unwrap());
+        // Clausius-Clapeyron equation
+        let expected = temperature * (1.0 / vapor[0] - 1.0 / liquid[0]) / (vapor[1] - liquid[1]);
+
+        // When
+        let res = sut.first_saturation_deriv(FluidParam::T, FluidParam::P).unwrap();
+
+        // Then
+        assert_relative_eq!(res, expected);
+    }
+
+    #[test]
+    fn first_two_phase_deriv_valid_state() {
+        // Given
+        let mut sut = AbstractState::new("HEOS", "Water").unwrap();
+        sut.update(FluidInputPair::PQ, 101_325.0, 0.5).unwrap();
+
+        // When
+        let res = sut.first_two_phase_deriv(FluidParam::DMass, FluidParam::HMass, FluidParam::P);
+
+        // Then
+        assert!(res.is_ok());
+    }
+
+    #[test]
+    fn first_two_phase_deriv_splined_valid_state() {
+        // Given
+        let mut sut = AbstractState::new("HEOS", "Water").unwrap();
+        sut.update(FluidInputPair::PQ, 101_325.0, 0.05).unwrap();
+
+        // When
+        let res = sut.first_two_phase_deriv_splined(
+            FluidParam::DMass,
+            FluidParam::HMass,
+            FluidParam::P,
+            0.1,
+        );
+
+        // Then
+        assert!(res.is_ok());
+    }
+
+    #[rstest]
+    #[case(0.0, FluidParam::DMass)]
+    #[case(1.0, FluidParam::DMass)]
+    #[case(0.0, FluidParam::CpMass)]
+    #[case(1.0, FluidParam::CpMass)]
+    fn saturated_keyed_output_valid_state(#[case] quality: f64, #[case] key: FluidParam) {
+        // Given
+        let mut sut = AbstractState::new("HEOS", "Water").unwrap();
+        let mut expected = AbstractState::new("HEOS", "Water").unwrap();
+        sut.update(FluidInputPair::PQ, 101_325.0, 0.5).unwrap();
+        expected.update(FluidInputPair::PQ, 101_325.0, quality).unwrap();
+
+        // When
+        let res = if quality == 0.0 {
+            sut.saturated_liquid_keyed_output(key)
+        } else {
+            sut.saturated_vapor_keyed_output(key)
+        }
+        .unwrap();
+
+        // Then
+        assert_relative_eq!(res, expected.keyed_output(key).unwrap());
+    }
+
+    #[test]
+    fn saturated_keyed_output_invalid_input() {
+        // Given
+        let mut sut = AbstractState::new("HEOS", "Water").unwrap();
+        sut.update(FluidInputPair::PQ, 101_325.0, 0.5).unwrap();
+
+        // When
+        let liquid_res = sut.saturated_liquid_keyed_output(255);
+        let vapor_res = sut.saturated_vapor_keyed_output(255);
+
+        // Then
+        assert!(liquid_res.is_err());
+        assert!(vapor_res.is_err());
+    }
+
     #[test]
     fn specify_phase_valid() {
         // Given
@@ -9,14 +9,23 @@
 //!
 //! - [`CoolProp`] -- high-level API for simplified access to properties
 //! - [`AbstractState`] -- low-level API for direct control and improved performance
+//! - [`PreparedQuery`] -- high-level API call with keys and substance resolved once
+//! - [`PhaseEnvelope`], [`Spinodal`] and [`CriticalPoints`] -- reusable buffers
+//!   for the phase envelope, spinodal curve and critical points of mixtures
 
 mod common;
+mod envelope;
 mod high_level_api;
 mod low_level_api;
+mod prepared_query;
+mod props_si_pool;
 mod utils;
 
+pub use envelope::{CriticalPoints, PhaseEnvelope, Spinodal};
 pub use high_level_api::CoolProp;
 pub use low_level_api::AbstractState;
+pub(crate) use low_level_api::composition;
+pub use prepared_query::PreparedQuery;
 
 /// `CoolProp` error.
 #[derive(Clone, Debug, Eq, PartialEq, thiserror::Error)]
@@ -45,6 +54,17 @@ pub enum CoolPropError {
         /// Byte position of the interior NUL byte.
         pos: usize,
     },
+
+    /// Input slice length doesn't match the expected one.
+    #[error("input `{arg}` has length {actual}, but {expected} was expected")]
+    InvalidLength {
+        /// Name of the invalid input argument.
+        arg: &'static str,
+        /// Expected length.
+        expected: usize,
+        /// Actual length.
+        actual: usize,
+    },
 }
 
 /// A type alias for results returned by `CoolProp` native API.
@@ -0,0 +1,283 @@
+use core::ffi::c_long;
+
+use super::{
+    AbstractState, CoolProp, CoolPropError, Result,
+    common::{c_string_trimmed, get_error, lock_coolprop},
+};
+use crate::io::{FluidInputPair, FluidParam};
+
+impl CoolProp {
+    /// Resolves the output key, input keys and substance name of the [`CoolProp::props_si`]
+    /// call once, so it can be evaluated repeatedly for different input values.
+    ///
+    /// Each evaluation of the returned [`PreparedQuery`] is just an update of its own
+    /// [`AbstractState`] and a keyed output, without any string conversions
+    /// and parsing or the global lock of the high-level API.
+    ///
+    /// # Arguments
+    ///
+    /// - `output_key` -- key of the output _(raw [`&str`](str) or
+    ///   [`FluidParam`](crate::io::FluidParam))_
+    /// - `input1_key` -- key of the first input property _(raw [`&str`](str) or
+    ///   [`FluidParam`](crate::io::FluidParam))_
+    /// - `input2_key` -- key of the second input property _(raw [`&str`](str) or
+    ///   [`FluidParam`](crate::io::FluidParam))_
+    /// - `substance_name` -- name of the substance in the same form as for
+    ///   [`CoolProp::props_si`] _(e.g., `"Water"`, `"INCOMP::MPG-60%"`
+    ///   or `"HEOS::Water[0.8]&Ethanol[0.2]"`)_
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`CoolPropError`] for unknown keys, unsupported input keys combination
+    /// or invalid substance name.
+    ///
+    /// # Examples
+    ///
+    /// ```
+    /// use approx::assert_relative_eq;
+    /// use rfluids::prelude::*;
+    ///
+    /// let mut density = CoolProp::prepare("D", "P", "T", "Water")?;
+    /// let res = density.eval(101_325.0, 293.15)?;
+    /// assert_relative_eq!(res, 998.207_150_467_928_4, max_relative = 1e-6);
+    /// let res = density.eval(101_325.0, 313.15)?;
+    /// let expected = CoolProp::props_si("D", "P", 101_325.0, "T", 313.15, "Water")?;
+    /// assert_relative_eq!(res, expected, max_relative = 1e-6);
+    /// # Ok::<(), rfluids::native::CoolPropError>(())
+    /// ```
+    ///
+    /// # See Also
+    ///
+    /// - [`CoolProp::props_si`]
+    /// - [`PreparedQuery::eval`]
+    pub fn prepare(
+        output_key: impl AsRef<str>,
+        input1_key: impl AsRef<str>,
+        input2_key: impl AsRef<str>,
+        substance_name: impl AsRef<str>,
+    ) -> Result<PreparedQuery> {
+        let keys =
+            ResolvedKeys::resolve(output_key.as_ref(), input1_key.as_ref(), input2_key.as_ref())?;
+        let state = build_state(substance_name.as_ref())?;
+        Ok(PreparedQuery { state, keys })
+    }
+}
+
+/// [`CoolProp::props_si`] call with resolved output key, input keys and substance.
+///
+/// It owns its own [`AbstractState`], so it's [`Send`], but not [`Sync`].
+///
+/// # See Also
+///
+/// - [`CoolProp::prepare`]
+#[derive(Debug)]
+pub struct PreparedQuery {
+    state: AbstractState,
+    keys: ResolvedKeys,
+}
+
+impl PreparedQuery {
+    /// Returns the output value for the specified input values.
+    ///
+    /// # Arguments
+    ///
+    /// - `input1_value` -- value of the first input property **\[SI units\]**
+    /// - `input2_value` -- value of the second input property **\[SI units\]**
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`CoolPropError`] for invalid inputs.
+    ///
+    /// # See Also
+    ///
+    /// - [`CoolProp::prepare`]
+    pub fn eval(&mut self, input1_value: f64, input2_value: f64) -> Result<f64> {
+        self.keys.eval(&mut self.state, input1_value, input2_value)
+    }
+}
+
+/// Output key and input pair of the [`CoolProp::props_si`] call.
+#[derive(Clone, Copy, Debug, PartialEq)]
+pub(super) struct ResolvedKeys {
+    input_pair: FluidInputPair,
+    output_key: u8,
+    swap_inputs: bool,
+}
+
+impl ResolvedKeys {
+    pub fn resolve(output_key: &str, input1_key: &str, input2_key: &str) -> Result<Self> {
+        let output_key = param_index(output_key)?;
+        let keys = (param_index(input1_key)?, param_index(input2_key)?);
+        let input_pair = FluidParam::try_from(keys.0)
+            .and_then(|key1| Ok((key1, FluidParam::try_from(keys.1)?)))
+            .and_then(FluidInputPair::try_from)
+            .map_err(|_| {
+                CoolPropError::Native(format!(
+                    "Input keys `{}` and `{}` are not a valid input pair",
+                    input1_key.trim(),
+                    input2_key.trim(),
+                ))
+            })?;
+        let swap_inputs = u8::from(<(FluidParam, FluidParam)>::from(input_pair).0) != keys.0;
+        Ok(Self { input_pair, output_key, swap_inputs })
+    }
+
+    pub fn eval(
+        self,
+        state: &mut AbstractState,
+        input1_value: f64,
+        input2_value: f64,
+    ) -> Result<f64> {
+        let (value1, value2) = if self.swap_inputs {
+            (input2_value, input1_value)
+        } else {
+            (input1_value, input2_value)
+        };
+        state.update(self.input_pair, value1, value2)?;
+        state.keyed_output(self.output_key)
+    }
+}
+
+/// Builds the native handle for the substance name in the same form as for
+/// [`CoolProp::props_si`].
+pub(super) fn build_state(substance_name: &str) -> Result<AbstractState> {
+    let (backend_name, composition_id, fractions) = parse_substance(substance_name)?;
+    let mut state = AbstractState::new(backend_name, composition_id)?;
+    if let Some(fractions) = fractions {
+        state.set_fractions(&fractions)?;
+    }
+    Ok(state)
+}
+
+fn param_index(key: &str) -> Result<u8> {
+    let name = c_string_trimmed("key", key)?;
+    let lock = lock_coolprop();
+    let index: c_long = unsafe { lock.get_param_index(name.as_ptr()) };
+    u8::try_from(index).map_err(|_| {
+        get_error(&lock)
+            .unwrap_or_else(|| CoolPropError::Native(format!("Unknown parameter `{}`", key.trim())))
+    })
+}
+
+/// Splits the substance name into the backend name, composition ID and fractions
+/// _(if specified)_.
+fn parse_substance(substance_name: &str) -> Result<(&str, String, Option<Vec<f64>>)> {
+    let substance_name = substance_name.trim();
+    let invalid = || CoolPropError::Native(format!("Invalid substance name `{substance_name}`"));
+    let (backend_name, fluid) = substance_name.split_once("::").unwrap_or(("HEOS", substance_name));
+    // Incompressible binary mixtures, e.g., `MPG-60%`
+    if let Some((name, percent)) = fluid.strip_suffix('%').and_then(|x| x.rsplit_once('-')) {
+        let fraction = percent.parse::<f64>().map_err(|_| invalid())?;
+        return Ok((backend_name, name.into(), Some(vec![fraction / 100.0])));
+    }
+    if !fluid.contains('[') {
+        return Ok((backend_name, fluid.into(), None));
+    }
+    // Mixtures with specified fractions, e.g., `Water[0.8]&Ethanol[0.2]`
+    let (names, fractions): (Vec<&str>, Vec<f64>) = fluid
+        .split('&')
+        .map(|component| {
+            let (name, fraction) =
+                component.strip_suffix(']').and_then(|x| x.split_once('[')).ok_or_else(invalid)?;
+            Ok((name, fraction.parse::<f64>().map_err(|_| invalid())?))
+        })
+        .collect::<Result<Vec<_>>>()?
+        .into_iter()
+        .unzip();
+    Ok((backend_name, names.join("&"), Some(fractions)))
+}
+
+#[cfg(test)]
+mod tests {
+    use rstest::*;
+
+    use super::*;
+    use crate::test::assert_relative_eq;
+
+    #[rstest]
+    #[case("D", "P", 101_325.0, "T", 293.15, "Water")]
+    #[case("D", "T", 293.15, "P", 101_325.0, "Water")]
+    #[case("H", "P", 101_325.0, "Q", 1.0, "HEOS::Water")]
+    #[case("V", "P", 100e3, "T", 253.15, "INCOMP::MPG-60%")]
+    #[case("D", "P", 200e3, "T", 277.15, "HEOS::Water[0.8]&Ethanol[0.2]")]
+    fn eval_matches_props_si(
+        #[case] output_key: &str,
+        #[case] input1_key: &str,
+        #[case] input1_value: f64,
+        #[case] input2_key: &str,
+        #[case] input2_value: f64,
+        #[case] substance_name: &str,
+    ) {
+        // Given
+        let mut sut =
+            CoolProp::prepare(output_key, input1_key, input2_key, substance_name).unwrap();
+
+        // When
+        let res = sut.eval(input1_value, input2_value).unwrap();
+
+        // Then
+        assert_relative_eq!(
+            res,
+            CoolProp::props_si(
+                output_key,
+                input1_key,
+                input1_value,
+                input2_key,
+                input2_value,
+                substance_name
+            )
+            .unwrap()
+        );
+    }
+
+    #[test]
+    fn eval_invalid_inputs() {
+        // Given
+        let mut sut = CoolProp::prepare("D", "P", "Q", "Water").unwrap();
+
+        // When
+        let res = sut.eval(101_325.0, -1.0);
+
+        // Then
+        assert!(res.is_err());
+    }
+
+    #[rstest]
+    #[case("Hello", "P", "T", "Water")]
+    #[case("D", "P", "Hello", "Water")]
+    #[case("D", "P", "P", "Water")]
+    #[case("D", "P", "Tcrit", "Water")]
+    #[case("D", "P", "T", "Hello, World!")]
+    #[case("D", "P", "T", "HEOS::Water[0.8&Ethanol[0.2]")]
+    #[case("V", "P", "T", "INCOMP::MPG-Hello%")]
+    fn prepare_invalid_inputs(
+        #[case] output_key: &str,
+        #[case] input1_key: &str,
+        #[case] input2_key: &str,
+        #[case] substance_name: &str,
+    ) {
+        // When
+        let res = CoolProp::prepare(output_key, input1_key, input2_key, substance_name);
+
+        // Then
+        assert!(res.is_err());
+    }
+
+    #[rstest]
+    #[case("Water", ("HEOS", "Water", None))]
+    #[case(" IF97::Water ", ("IF97", "Water", None))]
+    #[case("INCOMP::MPG-60%", ("INCOMP", "MPG", Some(vec![0.6])))]
+    #[case("INCOMP::MPG[0.6]", ("INCOMP", "MPG", Some(vec![0.6])))]
+    #[case("n-Butane", ("HEOS", "n-Butane", None))]
+    #[case("HEOS::Water[0.8]&Ethanol[0.2]", ("HEOS", "Water&Ethanol", Some(vec![0.8, 0.2])))]
+    fn parse_substance(
+        #[case] substance_name: &str,
+        #[case] expected: (&str, &str, Option<Vec<f64>>),
+    ) {
+        // When
+        let res = super::parse_substance(substance_name).unwrap();
+
+        // Then
+        assert_eq!(res, (expected.0, expected.1.to_string(), expected.2));
+    }
+}
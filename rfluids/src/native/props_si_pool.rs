@@ -0,0 +1,263 @@
+use std::cell::RefCell;
+
+use super::{
+    AbstractState, CoolPropError, Result,
+    prepared_query::{ResolvedKeys, build_state},
+};
+
+/// Maximum number of native handles kept per thread
+/// _(including the substance names, for which they can't be built)_.
+const MAX_STATES: usize = 16;
+
+/// Maximum number of resolved output and input keys combinations kept per thread
+/// _(including the unresolvable ones)_.
+const MAX_KEYS: usize = 64;
+
+thread_local! {
+    static POOL: RefCell<PropsSiPool> = RefCell::new(PropsSiPool::default());
+}
+
+/// Per-thread pool of long-lived native handles and resolved keys
+/// of the [`CoolProp::props_si`](crate::native::CoolProp::props_si) calls.
+///
+/// Both are bounded, and the least recently used entries are evicted first
+/// _(the most recently used entries are at the back)_. Keys combinations that can't be
+/// resolved and substance names, for which native handles can't be built, are cached
+/// as `None`, so they are passed to `CoolProp` as is without resolving them
+/// or running the native handles factory _(under the exclusive lock)_ again on every call.
+#[derive(Debug, Default)]
+struct PropsSiPool {
+    keys: Vec<([String; 3], Option<ResolvedKeys>)>,
+    states: Vec<(String, Option<AbstractState>)>,
+}
+
+impl PropsSiPool {
+    fn keys(
+        &mut self,
+        output_key: &str,
+        input1_key: &str,
+        input2_key: &str,
+    ) -> Option<ResolvedKeys> {
+        let names = [output_key, input1_key, input2_key];
+        if let Some(i) = self.keys.iter().position(|(x, _)| *x == names) {
+            self.keys[i..].rotate_left(1);
+            return self.keys.last().and_then(|(_, keys)| *keys);
+        }
+        let keys = ResolvedKeys::resolve(output_key, input1_key, input2_key).ok();
+        if self.keys.len() >= MAX_KEYS {
+            self.keys.remove(0);
+        }
+        self.keys.push((names.map(String::from), keys));
+        keys
+    }
+
+    fn state(&mut self, substance_name: &str) -> Option<&mut AbstractState> {
+        if let Some(i) = self.states.iter().position(|(x, _)| x == substance_name) {
+            self.states[i..].rotate_left(1);
+        } else {
+            let state = build_state(substance_name).ok();
+            if self.states.len() >= MAX_STATES {
+                self.states.remove(0);
+            }
+            self.states.push((substance_name.into(), state));
+        }
+        self.states.last_mut().and_then(|(_, state)| state.as_mut())
+    }
+}
+
+/// Evaluates the [`CoolProp::props_si`](crate::native::CoolProp::props_si) call
+/// on the native handle from the per-thread pool.
+///
+/// Returns `None` if the call can't be evaluated this way (e.g., unknown keys,
+/// unsupported input pair or invalid substance name), so it has to be passed to `CoolProp`
+/// as is _(which also reports the error)_. Errors of the calculation itself are returned
+/// with the same context as `PropsSI` appends, so it's not repeated by `CoolProp`.
+pub(super) fn props_si(
+    output_key: &str,
+    input1_key: &str,
+    input1_value: f64,
+    input2_key: &str,
+    input2_value: f64,
+    substance_name: &str,
+) -> Option<Result<f64>> {
+    POOL.try_with(|pool| {
+        let mut pool = pool.try_borrow_mut().ok()?;
+        let keys = pool.keys(output_key, input1_key, input2_key)?;
+        let state = pool.state(substance_name)?;
+        match keys.eval(state, input1_value, input2_value) {
+            Ok(value) => Some(Ok(value)),
+            Err(CoolPropError::Native(message)) => Some(Err(CoolPropError::Native(format!(
+                "{message} : PropsSI(\"{}\",\"{}\",{},\"{}\",{},\"{}\")",
+                output_key.trim(),
+                input1_key.trim(),
+                format_g(input1_value),
+                input2_key.trim(),
+                format_g(input2_value),
+                substance_name.trim(),
+            )))),
+            // Other errors (e.g., non-finite outputs) are reported by `CoolProp` as is
+            Err(_) => None,
+        }
+    })
+    .ok()
+    .flatten()
+}
+
+/// Formats the value in the same way as `PropsSI` does in its error messages
+/// _(i.e., `%0.10g`)_.
+fn format_g(value: f64) -> String {
+    if value == 0.0 || !value.is_finite() {
+        return match value {
+            x if x.is_nan() => "nan".into(),
+            x if x.is_infinite() => (if x > 0.0 { "inf" } else { "-inf" }).into(),
+            _ => "0".into(),
+        };
+    }
+    let scientific = format!("{value:.9e}");
+    let (mantissa, exponent) = scientific.split_once('e').unwrap();
+    let exponent: i32 = exponent.parse().unwrap();
+    let trim = |x: &str| {
+        if x.contains('.') {
+            x.trim_end_matches('0').trim_end_matches('.').to_owned()
+        } else {
+            x.into()
+        }
+    };
+    if (-4..10).contains(&exponent) {
+        let decimals = usize::try_from(9 - exponent).unwrap();
+        return trim(&format!("{value:.decimals$}"));
+    }
+    let sign = if exponent < 0 { '-' } else { '+' };
+    format!("{}e{sign}{:02}", trim(mantissa), exponent.abs())
+}
+
+#[cfg(test)]
+mod tests {
+    use rstest::*;
+
+    use super::*;
+
+    #[test]
+    fn keys_evicts_least_recently_used() {
+        // Given
+        let mut sut = PropsSiPool::default();
+        sut.keys("D", "P", "T").unwrap();
+        for i in 1..MAX_KEYS {
+            // Distinct names of the same keys
+            sut.keys("D", &format!("{}P", " ".repeat(i)), "T").unwrap();
+        }
+        sut.keys("D", "P", "T").unwrap();
+
+        // When
+        sut.keys("H", "P", "T").unwrap();
+
+        // Then
+        assert_eq!(sut.keys.len(), MAX_KEYS);
+        assert!(sut.keys.iter().any(|(names, _)| names == &["D", "P", "T"]));
+        assert!(!sut.keys.iter().any(|(names, _)| names == &["D", " P", "T"]));
+    }
+
+    #[test]
+    fn keys_caches_unresolvable_names() {
+        // Given
+        let mut sut = PropsSiPool::default();
+        sut.keys("Not a real key", "P", "T");
+
+        // When
+        let res = sut.keys("Not a real key", "P", "T");
+
+        // Then
+        assert!(res.is_none());
+        assert_eq!(sut.keys.len(), 1);
+        assert!(sut.keys[0].1.is_none());
+    }
+
+    #[test]
+    fn state_reused() {
+        // Given
+        let mut sut = PropsSiPool::default();
+        sut.state("Water").unwrap();
+        sut.state("HEOS::R134a").unwrap();
+
+        // When
+        let res = sut.state("Water");
+
+        // Then
+        assert!(res.is_some());
+        assert_eq!(sut.states.len(), 2);
+        assert_eq!(sut.states.last().unwrap().0, "Water");
+    }
+
+    #[test]
+    fn state_invalid_substance_name() {
+        // Given
+        let mut sut = PropsSiPool::default();
+
+        // When
+        let res = sut.state("Not a real fluid");
+
+        // Then
+        assert!(res.is_none());
+        assert_eq!(sut.states.len(), 1);
+        assert!(sut.states[0].1.is_none());
+    }
+
+    #[test]
+    fn state_caches_invalid_substance_name() {
+        // Given
+        let mut sut = PropsSiPool::default();
+        sut.state("Not a real fluid");
+        sut.state("Water").unwrap();
+
+        // When
+        let res = sut.state("Not a real fluid");
+
+        // Then
+        assert!(res.is_none());
+        assert_eq!(sut.states.len(), 2);
+        assert_eq!(sut.states.last().unwrap().0, "Not a real fluid");
+    }
+
+    #[test]
+    fn props_si_failed_calculation() {
+        // When
+        let res = props_si("D", "P", 101_325.0, "Q", -1.0, "Water");
+
+        // Then
+        assert_eq!(
+            res,
+            Some(Err(CoolPropError::Native(
+                "Input vapor quality [Q] must be between 0 and 1 : \
+                PropsSI(\"D\",\"P\",101325,\"Q\",-1,\"Water\")"
+                    .into()
+            )))
+        );
+    }
+
+    #[rstest]
+    #[case(0.0, "0")]
+    #[case(101_325.0, "101325")]
+    #[case(-1.0, "-1")]
+    #[case(293.15, "293.15")]
+    #[case(0.123_456_789_012, "0.123456789")]
+    #[case(1e-7, "1e-07")]
+    #[case(1_234_567.0, "1234567")]
+    #[case(12_345_678_901.0, "1.23456789e+10")]
+    #[case(9_999_999_999.5, "1e+10")]
+    fn format_g(#[case] value: f64, #[case] expected: &str) {
+        // When
+        let res = super::format_g(value);
+
+        // Then
+        assert_eq!(res, expected);
+    }
+
+    #[test]
+    fn props_si_invalid_input_pair() {
+        // When
+        let res = props_si("D", "P", 101_325.0, "P", 101_325.0, "Water");
+
+        // Then
+        assert!(res.is_none());
+    }
+}
@@ -1,10 +1,8 @@
 use std::ffi::CString;
 
-use coolprop_sys::COOLPROP;
-
 use super::{
     CoolProp, Result,
-    common::{StringBuffer, c_string, get_error},
+    common::{StringBuffer, c_string, get_error, lock_coolprop, write_handles},
 };
 use crate::io::ConfigValue;
 
@@ -35,7 +33,7 @@ impl CoolProp {
     /// - [`CoolProp::set_debug_level`](Self::set_debug_level)
     #[must_use]
     pub fn get_debug_level() -> u8 {
-        let level = unsafe { COOLPROP.lock().unwrap().get_debug_level() };
+        let level = unsafe { lock_coolprop().get_debug_level() };
         level.clamp(MIN_DEBUG_LEVEL.into(), MAX_DEBUG_LEVEL.into()) as u8
     }
 
@@ -70,10 +68,7 @@ impl CoolProp {
     /// - [`CoolProp::get_debug_level`](Self::get_debug_level)
     pub fn set_debug_level(level: u8) {
         unsafe {
-            COOLPROP
-                .lock()
-                .unwrap()
-                .set_debug_level(level.clamp(MIN_DEBUG_LEVEL, MAX_DEBUG_LEVEL).into());
+            lock_coolprop().set_debug_level(level.clamp(MIN_DEBUG_LEVEL, MAX_DEBUG_LEVEL).into());
         }
     }
 
@@ -342,11 +337,7 @@ fn get_global_param(param: &str) -> Option<String> {
     let param = CString::new(param).ok()?;
     let mut res = StringBuffer::with_capacity(capacity);
     let status = unsafe {
-        COOLPROP.lock().unwrap().get_global_param_string(
-            param.as_ptr(),
-            res.as_mut_ptr(),
-            res.capacity(),
-        )
+        lock_coolprop().get_global_param_string(param.as_ptr(), res.as_mut_ptr(), res.capacity())
     };
     let res: String = res.into();
     if status != 1 || res.trim().is_empty() { None } else { Some(res) }
@@ -367,7 +358,7 @@ fn get_substance_param(composition_id: &str, param: &str) -> Option<String> {
     let param = CString::new(param).ok()?;
     let mut res = StringBuffer::with_capacity(capacity);
     let status = unsafe {
-        COOLPROP.lock().unwrap().get_fluid_param_string(
+        lock_coolprop().get_fluid_param_string(
             composition_id.as_ptr(),
             param.as_ptr(),
             res.as_mut_ptr(),
@@ -380,7 +371,9 @@ fn get_substance_param(composition_id: &str, param: &str) -> Option<String> {
 
 fn set_config(key: &str, value: &ConfigValue) -> Result<()> {
     let key = c_string("key", key)?;
-    let lock = COOLPROP.lock().unwrap();
+    let lock = lock_coolprop();
+    // Configuration is read by per-handle calls, so it must not change while they are running
+    let _handles = write_handles();
     match value {
         ConfigValue::Bool(val) => unsafe {
             lock.set_config_bool(key.as_ptr(), *val);
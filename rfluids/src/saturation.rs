@@ -0,0 +1,540 @@
+//! Native evaluation of the saturation curves of pure substances.
+//!
+//! Saturation states _(e.g., evaporating or condensing pressure at the specified temperature)_
+//! are the most frequent queries of refrigeration cycle models, but each of them still goes
+//! through the FFI and the full flash calculation of `CoolProp`.
+//! [`SaturationCurve`] fits the saturation curves of the pure substance once
+//! and evaluates them entirely in Rust, which is suitable for tight loops.
+//!
+//! # Examples
+//!
+//! ```
+//! use approx::assert_relative_eq;
+//! use rfluids::{
+//!     prelude::*,
+//!     saturation::{SaturationCurve, SaturationParam},
+//! };
+//!
+//! let curve = SaturationCurve::new(Pure::R32)?;
+//!
+//! let mut fluid = Fluid::from(Pure::R32)
+//!     .in_state(FluidInput::temperature(278.15), FluidInput::quality(0.0))?;
+//! assert_relative_eq!(
+//!     curve.output(SaturationParam::Pressure, 278.15)?,
+//!     fluid.pressure()?,
+//!     max_relative = 1e-8
+//! );
+//!
+//! let pressures = [5e5, 1e6, 2e6];
+//! let mut temperatures = [0.0; 3];
+//! curve.output_batch(SaturationParam::Temperature, &pressures, &mut temperatures);
+//! assert!(temperatures.windows(2).all(|x| x[0] < x[1]));
+//! # Ok::<(), rfluids::Error>(())
+//! ```
+
+use std::ops::RangeInclusive;
+
+use crate::{
+    chebyshev,
+    fluid::backend::{Backend, BaseBackend},
+    io::{FluidInputPair, FluidParam, FluidTrivialParam},
+    native::{AbstractState, CoolProp, CoolPropError},
+    substance::Pure,
+};
+
+/// Number of collocation nodes per segment.
+const NODES: usize = 16;
+
+/// Maximum relative deviation of the segment from the `CoolProp` values between the nodes.
+const TOLERANCE: f64 = 1e-9;
+
+/// Maximum number of segment bisections.
+const MAX_DEPTH: u32 = 20;
+
+/// Relative distance from the critical temperature to the upper bound of the fitted curves
+/// _(closer to the critical point, ancillary equations are used)_.
+const CRITICAL_MARGIN: f64 = 1e-4;
+
+/// Number of points evaluated together by [`SaturationCurve::output_batch`].
+const LANES: usize = 8;
+
+/// Saturation curve parameter.
+#[derive(Clone, Copy, Debug, Eq, Hash, PartialEq)]
+pub enum SaturationParam {
+    /// Saturation pressure **\[Pa\]** at the specified temperature **\[K\]**.
+    Pressure,
+    /// Saturation temperature **\[K\]** at the specified pressure **\[Pa\]**.
+    Temperature,
+    /// Saturated liquid mass density **\[kg/m³\]** at the specified temperature **\[K\]**.
+    LiquidDensity,
+    /// Saturated vapor mass density **\[kg/m³\]** at the specified temperature **\[K\]**.
+    VaporDensity,
+}
+
+/// Saturation curves of the pure substance evaluated entirely in Rust.
+///
+/// On creation, the saturation states are calculated by `CoolProp` at the Chebyshev nodes,
+/// and the piecewise Chebyshev series are fitted to the values _(the pressure in logarithmic
+/// coordinates)_. Segments are bisected until the fit matches `CoolProp` between the nodes
+/// within about `1e-9` relative deviation _(see [`SaturationCurve::max_relative_error`])_.
+/// Within `0.01 %` of the critical temperature, where the densities change too steeply
+/// for the polynomial fit, the ancillary equations of the substance are used instead
+/// _(see [`CoolProp::saturation_ancillary`])_.
+///
+/// For pseudo-pure substances _(e.g., [`R404A`](Pure::R404A))_, the pressure and temperature
+/// correspond to the saturated liquid _(bubble point)_.
+///
+/// # Examples
+///
+/// See the [module-level documentation](crate::saturation).
+#[derive(Clone, Debug, PartialEq)]
+pub struct SaturationCurve {
+    substance: Pure,
+    temperature: RangeInclusive<f64>,
+    pressure: RangeInclusive<f64>,
+    fitted_temperature: f64,
+    fitted_pressure: f64,
+    molar_mass: f64,
+    curves: [Piecewise; 4],
+}
+
+impl SaturationCurve {
+    /// Fits a new [`SaturationCurve`] of the pure substance.
+    ///
+    /// # Arguments
+    ///
+    /// - `substance` -- pure substance
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`SaturationError`] if `CoolProp` fails to calculate the saturation states.
+    pub fn new(substance: Pure) -> Result<Self, SaturationError> {
+        Self::fit(substance).map_err(|e| failed(substance, e))
+    }
+
+    fn fit(substance: Pure) -> Result<Self, CoolPropError> {
+        let mut state = AbstractState::new(Backend::Base(BaseBackend::Heos).name(), substance)?;
+        let min_temperature = state.keyed_output(FluidTrivialParam::TMin)?;
+        let critical_temperature = state.keyed_output(FluidTrivialParam::TCritical)?;
+        let critical_pressure = state.keyed_output(FluidTrivialParam::PCritical)?;
+        let molar_mass = state.keyed_output(FluidTrivialParam::MolarMass)?;
+        let fitted_temperature = critical_temperature * (1.0 - CRITICAL_MARGIN);
+        let domain = Domain { min: min_temperature, max: fitted_temperature, log: false };
+        let pressure = Piecewise::fit(&mut state, domain, true, saturated(0.0, FluidParam::P))?;
+        let liquid_density =
+            Piecewise::fit(&mut state, domain, false, saturated(0.0, FluidParam::DMass))?;
+        let vapor_density =
+            Piecewise::fit(&mut state, domain, true, saturated(1.0, FluidParam::DMass))?;
+        let [min_pressure, fitted_pressure] = pressure.eval(&[min_temperature, fitted_temperature]);
+        let domain = Domain { min: min_pressure.ln(), max: fitted_pressure.ln(), log: true };
+        let temperature = Piecewise::fit(&mut state, domain, false, |state, pressure| {
+            state.update(FluidInputPair::PQ, pressure, 0.0)?;
+            state.keyed_output(FluidParam::T)
+        })?;
+        Ok(Self {
+            substance,
+            temperature: min_temperature..=critical_temperature,
+            pressure: min_pressure..=critical_pressure,
+            fitted_temperature,
+            fitted_pressure,
+            molar_mass,
+            curves: [pressure, temperature, liquid_density, vapor_density],
+        })
+    }
+
+    /// Pure substance.
+    #[must_use]
+    pub fn substance(&self) -> Pure {
+        self.substance
+    }
+
+    /// Valid temperature range **\[K\]** _(from the minimum to the critical temperature)_.
+    #[must_use]
+    pub fn temperature_range(&self) -> RangeInclusive<f64> {
+        self.temperature.clone()
+    }
+
+    /// Valid pressure range **\[Pa\]** _(from the saturation pressure at the minimum temperature
+    /// to the critical pressure)_.
+    #[must_use]
+    pub fn pressure_range(&self) -> RangeInclusive<f64> {
+        self.pressure.clone()
+    }
+
+    /// Maximum relative deviation of the fitted curve from the `CoolProp` values
+    /// between the collocation nodes.
+    ///
+    /// # Arguments
+    ///
+    /// - `param` -- saturation curve parameter
+    #[must_use]
+    pub fn max_relative_error(&self, param: SaturationParam) -> f64 {
+        self.curve(param).max_relative_error
+    }
+
+    /// Evaluates the saturation curve parameter value at the specified input
+    /// _(pressure for [`Temperature`](SaturationParam::Temperature), temperature otherwise)_.
+    ///
+    /// # Arguments
+    ///
+    /// - `param` -- saturation curve parameter
+    /// - `input` -- temperature **\[K\]** or pressure **\[Pa\]**
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`SaturationError`] if the input is out of range
+    /// or the ancillary equation fails near the critical point.
+    pub fn output(&self, param: SaturationParam, input: f64) -> Result<f64, SaturationError> {
+        let (range, fitted) = self.domain(param);
+        if !range.contains(&input) {
+            return Err(SaturationError::OutOfRange(input));
+        }
+        if input > fitted {
+            return self.ancillary(param, input).map_err(|e| failed(self.substance, e));
+        }
+        let [value] = self.curve(param).eval(&[input]);
+        Ok(value)
+    }
+
+    /// Evaluates the saturation curve parameter values at the specified inputs
+    /// _(pressures for [`Temperature`](SaturationParam::Temperature), temperatures otherwise)_.
+    ///
+    /// Inputs are processed in fixed-size chunks with branch-free evaluation of the series
+    /// over lane arrays, which the compiler maps to SIMD instructions of the target.
+    /// Values at the inputs out of range _(or for which the ancillary equation fails)_
+    /// are [`f64::NAN`].
+    ///
+    /// # Arguments
+    ///
+    /// - `param` -- saturation curve parameter
+    /// - `input` -- temperatures **\[K\]** or pressures **\[Pa\]**
+    /// - `out` -- buffer for the output values
+    ///
+    /// # Panics
+    ///
+    /// Panics if the lengths of `input` and `out` are not equal.
+    pub fn output_batch(&self, param: SaturationParam, input: &[f64], out: &mut [f64]) {
+        assert!(input.len() == out.len(), "lengths of inputs and output buffer must be equal");
+        let mut input_chunks = input.chunks_exact(LANES);
+        let mut out_chunks = out.chunks_exact_mut(LANES);
+        for (input, out) in input_chunks.by_ref().zip(out_chunks.by_ref()) {
+            out.copy_from_slice(&self.eval(param, input.try_into().unwrap()));
+        }
+        for (&input, out) in input_chunks.remainder().iter().zip(out_chunks.into_remainder()) {
+            *out = self.eval(param, &[input])[0];
+        }
+    }
+
+    fn curve(&self, param: SaturationParam) -> &Piecewise {
+        &self.curves[param as usize]
+    }
+
+    /// Valid range of the input and the upper bound of its fitted part.
+    fn domain(&self, param: SaturationParam) -> (&RangeInclusive<f64>, f64) {
+        match param {
+            SaturationParam::Temperature => (&self.pressure, self.fitted_pressure),
+            _ => (&self.temperature, self.fitted_temperature),
+        }
+    }
+
+    fn eval<const L: usize>(&self, param: SaturationParam, input: &[f64; L]) -> [f64; L] {
+        let (range, fitted) = self.domain(param);
+        let mut value = self.curve(param).eval(input);
+        for lane in 0..L {
+            if !range.contains(&input[lane]) {
+                value[lane] = f64::NAN;
+            } else if input[lane] > fitted {
+                value[lane] = self.ancillary(param, input[lane]).unwrap_or(f64::NAN);
+            }
+        }
+        value
+    }
+
+    fn ancillary(&self, param: SaturationParam, input: f64) -> Result<f64, CoolPropError> {
+        let name: &str = self.substance.into();
+        match param {
+            SaturationParam::Pressure => CoolProp::saturation_ancillary("P", 0, "T", input, name),
+            SaturationParam::Temperature => {
+                CoolProp::saturation_ancillary("T", 0, "P", input, name)
+            }
+            SaturationParam::LiquidDensity => {
+                CoolProp::saturation_ancillary("Dmolar", 0, "T", input, name)
+                    .map(|x| x * self.molar_mass)
+            }
+            SaturationParam::VaporDensity => {
+                CoolProp::saturation_ancillary("Dmolar", 1, "T", input, name)
+                    .map(|x| x * self.molar_mass)
+            }
+        }
+    }
+}
+
+/// Error during fitting or evaluation of the [`SaturationCurve`].
+#[derive(Clone, Debug, PartialEq, thiserror::Error)]
+pub enum SaturationError {
+    /// `CoolProp` failed to calculate the saturation states of the substance.
+    #[error("failed to calculate saturation states of `{substance}`: {source}")]
+    Failed {
+        /// Substance name.
+        substance: String,
+        /// `CoolProp` error.
+        source: CoolPropError,
+    },
+
+    /// Input value is out of range of the [`SaturationCurve`].
+    #[error("input value {0} is out of the saturation curve range")]
+    OutOfRange(f64),
+}
+
+fn failed(substance: Pure, source: CoolPropError) -> SaturationError {
+    SaturationError::Failed { substance: substance.as_ref().into(), source }
+}
+
+/// Sampler of the saturated state parameter at the specified temperature.
+fn saturated(
+    quality: f64,
+    param: FluidParam,
+) -> impl FnMut(&mut AbstractState, f64) -> Result<f64, CoolPropError> {
+    move |state, temperature| {
+        state.update(FluidInputPair::QT, quality, temperature)?;
+        state.keyed_output(param)
+    }
+}
+
+/// Fitted range of the curve input _(or its logarithm if `log`)_.
+#[derive(Clone, Copy, Debug)]
+struct Domain {
+    min: f64,
+    max: f64,
+    log: bool,
+}
+
+/// Piecewise Chebyshev series of the curve _(with `NODES` coefficients per segment)_.
+#[derive(Clone, Debug, PartialEq)]
+struct Piecewise {
+    bounds: Vec<f64>,
+    coefficients: Vec<f64>,
+    log_input: bool,
+    log_output: bool,
+    max_relative_error: f64,
+}
+
+impl Piecewise {
+    /// Fits the series to the values calculated by `sample`
+    /// _(in logarithmic coordinates of the output if `log_output`)_,
+    /// bisecting the segments until the tolerance is met.
+    fn fit<F>(
+        state: &mut AbstractState,
+        domain: Domain,
+        log_output: bool,
+        mut sample: F,
+    ) -> Result<Self, CoolPropError>
+    where
+        F: FnMut(&mut AbstractState, f64) -> Result<f64, CoolPropError>,
+    {
+        let mut series = Self {
+            bounds: vec![domain.min],
+            coefficients: Vec::new(),
+            log_input: domain.log,
+            log_output,
+            max_relative_error: 0.0,
+        };
+        series.segment(state, domain, 0, &mut sample)?;
+        Ok(series)
+    }
+
+    fn segment<F>(
+        &mut self,
+        state: &mut AbstractState,
+        domain: Domain,
+        depth: u32,
+        sample: &mut F,
+    ) -> Result<(), CoolPropError>
+    where
+        F: FnMut(&mut AbstractState, f64) -> Result<f64, CoolPropError>,
+    {
+        let (mid, half) = (0.5 * (domain.min + domain.max), 0.5 * (domain.max - domain.min));
+        let input = |k: f64| self.input(mid + half * chebyshev::node(k, NODES));
+        let mut values = Vec::with_capacity(NODES);
+        for k in 0..NODES {
+            let value = sample(state, input(k as f64))?;
+            values.push(if self.log_output { value.ln() } else { value });
+        }
+        let coefficients = chebyshev::coefficients(&values);
+        let mut max_relative_error = 0.0_f64;
+        // Extrema of the Chebyshev polynomial between the nodes are the check points
+        for k in 0..NODES - 1 {
+            let x = chebyshev::node(k as f64 + 0.5, NODES);
+            let expected = sample(state, input(k as f64 + 0.5))?;
+            let [value] = chebyshev::eval(NODES, &[x], |_, j| coefficients[j]);
+            let value = if self.log_output { value.exp() } else { value };
+            max_relative_error = max_relative_error.max(((value - expected) / expected).abs());
+        }
+        if (max_relative_error.is_nan() || max_relative_error > TOLERANCE) && depth < MAX_DEPTH {
+            self.segment(state, Domain { max: mid, ..domain }, depth + 1, sample)?;
+            return self.segment(state, Domain { min: mid, ..domain }, depth + 1, sample);
+        }
+        self.bounds.push(domain.max);
+        self.coefficients.extend(coefficients);
+        self.max_relative_error = self.max_relative_error.max(max_relative_error);
+        Ok(())
+    }
+
+    /// Input value at the point of the domain.
+    fn input(&self, point: f64) -> f64 {
+        if self.log_input { point.exp() } else { point }
+    }
+
+    fn eval<const L: usize>(&self, input: &[f64; L]) -> [f64; L] {
+        let segments = self.bounds.len() - 1;
+        let mut segment = [0; L];
+        let mut x = [0.0; L];
+        for lane in 0..L {
+            let point = if self.log_input { input[lane].ln() } else { input[lane] };
+            let s = self.bounds.partition_point(|&bound| bound <= point).clamp(1, segments) - 1;
+            let (min, max) = (self.bounds[s], self.bounds[s + 1]);
+            segment[lane] = s;
+            x[lane] = (2.0 * point - min - max) / (max - min);
+        }
+        let value =
+            chebyshev::eval(NODES, &x, |lane, j| self.coefficients[segment[lane] * NODES + j]);
+        if self.log_output { value.map(f64::exp) } else { value }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use rstest::*;
+
+    use super::*;
+
+    fn water() -> SaturationCurve {
+        SaturationCurve::new(Pure::Water).unwrap()
+    }
+
+    #[rstest]
+    #[case(Pure::Water)]
+    #[case(Pure::R32)]
+    #[case(Pure::CarbonDioxide)]
+    fn output_matches_backend(#[case] substance: Pure) {
+        // Given
+        let sut = SaturationCurve::new(substance).unwrap();
+        let mut expected =
+            AbstractState::new(Backend::Base(BaseBackend::Heos).name(), substance).unwrap();
+        let (min, max) = (*sut.temperature_range().start(), sut.fitted_temperature);
+
+        for k in 0..10_u32 {
+            let temperature = min + (max - min) * (f64::from(k) + 0.5) / 10.0;
+
+            // When
+            let pressure = sut.output(SaturationParam::Pressure, temperature).unwrap();
+            let liquid_density = sut.output(SaturationParam::LiquidDensity, temperature).unwrap();
+            let vapor_density = sut.output(SaturationParam::VaporDensity, temperature).unwrap();
+            let res = sut.output(SaturationParam::Temperature, pressure).unwrap();
+
+            // Then
+            expected.update(FluidInputPair::QT, 0.0, temperature).unwrap();
+            approx::assert_relative_eq!(
+                pressure,
+                expected.keyed_output(FluidParam::P).unwrap(),
+                max_relative = 1e-8
+            );
+            approx::assert_relative_eq!(
+                liquid_density,
+                expected.keyed_output(FluidParam::DMass).unwrap(),
+                max_relative = 1e-8
+            );
+            expected.update(FluidInputPair::QT, 1.0, temperature).unwrap();
+            approx::assert_relative_eq!(
+                vapor_density,
+                expected.keyed_output(FluidParam::DMass).unwrap(),
+                max_relative = 1e-8
+            );
+            approx::assert_relative_eq!(res, temperature, max_relative = 1e-8);
+        }
+    }
+
+    #[rstest]
+    #[case(SaturationParam::Pressure)]
+    #[case(SaturationParam::Temperature)]
+    #[case(SaturationParam::LiquidDensity)]
+    #[case(SaturationParam::VaporDensity)]
+    fn max_relative_error(#[case] param: SaturationParam) {
+        // Given
+        let sut = water();
+
+        // When
+        let res = sut.max_relative_error(param);
+
+        // Then
+        assert!(res < 1e-8);
+    }
+
+    #[test]
+    fn output_near_critical_point() {
+        // Given
+        let sut = water();
+        let temperature = *sut.temperature_range().end() * (1.0 - 0.5 * CRITICAL_MARGIN);
+
+        // When
+        let res = sut.output(SaturationParam::VaporDensity, temperature).unwrap();
+
+        // Then
+        let expected =
+            CoolProp::saturation_ancillary("Dmolar", 1, "T", temperature, "Water").unwrap();
+        assert_eq!(res, expected * sut.molar_mass);
+    }
+
+    #[rstest]
+    #[case(SaturationParam::Pressure, f64::NAN)]
+    #[case(SaturationParam::Pressure, 200.0)]
+    #[case(SaturationParam::LiquidDensity, 700.0)]
+    #[case(SaturationParam::Temperature, 1e8)]
+    fn output_out_of_range(#[case] param: SaturationParam, #[case] input: f64) {
+        // Given
+        let sut = water();
+
+        // When
+        let res = sut.output(param, input);
+
+        // Then
+        assert!(matches!(res, Err(SaturationError::OutOfRange(_))));
+    }
+
+    #[test]
+    fn output_batch_matches_output() {
+        // Given
+        let sut = water();
+        let mut temperature: Vec<f64> = (0..11_u32).map(|k| 283.15 + 35.0 * f64::from(k)).collect();
+        temperature[3] = 1000.0;
+        let mut res = vec![0.0; temperature.len()];
+
+        // When
+        sut.output_batch(SaturationParam::Pressure, &temperature, &mut res);
+
+        // Then
+        for (&t, &res) in temperature.iter().zip(&res) {
+            match sut.output(SaturationParam::Pressure, t) {
+                Ok(expected) => assert_eq!(res, expected),
+                Err(_) => assert!(res.is_nan()),
+            }
+        }
+        assert!(res[3].is_nan());
+    }
+
+    #[test]
+    fn ranges() {
+        // Given
+        let sut = water();
+
+        // When
+        let (temperature, pressure) = (sut.temperature_range(), sut.pressure_range());
+
+        // Then
+        approx::assert_relative_eq!(*temperature.start(), 273.16, max_relative = 1e-6);
+        approx::assert_relative_eq!(*temperature.end(), 647.096, max_relative = 1e-6);
+        approx::assert_relative_eq!(*pressure.end(), 22.064e6, max_relative = 1e-6);
+        assert!(*pressure.start() < 1e3);
+        assert_eq!(sut.substance(), Pure::Water);
+    }
+}
@@ -32,7 +32,7 @@ mod predefined_mix;
 mod pure;
 mod with_backend;
 
-use std::borrow::Cow;
+use std::{borrow::Cow, str::FromStr};
 
 pub use binary_mix::*;
 pub use custom_mix::*;
@@ -61,6 +61,18 @@ use crate::{
 ///
 /// `Substance` enum provides [`From`] implementations for each of its variants,
 /// allowing for easy conversion from specific substance types to the `Substance` enum.
+///
+/// It can also be parsed from the name of the [`Pure`] or [`PredefinedMix`]
+/// _(case-insensitive)_, or from the name of the [`IncompPure`] with the `INCOMP::` prefix
+/// _(since some of them have the same names as the [`Pure`] ones)_:
+///
+/// ```
+/// use rfluids::prelude::*;
+///
+/// assert_eq!("Water".parse(), Ok(Substance::from(Pure::Water)));
+/// assert_eq!("INCOMP::Water".parse(), Ok(Substance::from(IncompPure::Water)));
+/// assert_eq!("R444A.mix".parse(), Ok(Substance::from(PredefinedMix::R444A)));
+/// ```
 #[derive(Clone, Debug, PartialEq)]
 pub enum Substance {
     /// Pure or pseudo-pure substance.
@@ -537,6 +549,17 @@ impl From<CustomMix> for Substance {
     }
 }
 
+impl FromStr for Substance {
+    type Err = strum::ParseError;
+
+    fn from_str(s: &str) -> Result<Self, Self::Err> {
+        if let Some(name) = s.strip_prefix("INCOMP::") {
+            return IncompPure::from_str(name).map(Into::into);
+        }
+        Pure::from_str(s).map(Into::into).or_else(|_| PredefinedMix::from_str(s).map(Into::into))
+    }
+}
+
 #[cfg(test)]
 mod tests {
     use rstest::*;
@@ -604,6 +627,34 @@ mod tests {
         );
     }
 
+    #[rstest]
+    #[case("Water", Pure::Water)]
+    #[case("r32", Pure::R32)]
+    #[case("INCOMP::Water", IncompPure::Water)]
+    #[case("R444A", PredefinedMix::R444A)]
+    #[case("R444A.mix", PredefinedMix::R444A)]
+    fn from_valid_str(#[case] s: &str, #[case] expected: impl Into<Substance>) {
+        // When
+        let res = Substance::from_str(s);
+
+        // Then
+        assert_eq!(res, Ok(expected.into()));
+    }
+
+    #[rstest]
+    #[case("")]
+    #[case("Hello, World!")]
+    #[case("INCOMP::")]
+    #[case("INCOMP::R444A")]
+    #[case("MPG[0.4]")]
+    fn from_invalid_str(#[case] s: &str) {
+        // When
+        let res = Substance::from_str(s);
+
+        // Then
+        assert!(res.is_err());
+    }
+
     #[rstest]
     #[case(Pure::Water, "Water")]
     #[case(IncompPure::Water, "Water")]
@@ -1,5 +1,11 @@
 // cSpell:disable
 
+use crate::{
+    fluid::{OutputResult, pure_trivial_output},
+    io::FluidTrivialParam,
+    ops::mul,
+};
+
 /// `CoolProp` pure or pseudo-pure substances.
 ///
 /// # Examples
@@ -27,6 +33,7 @@
     Hash,
     PartialEq,
     strum_macros::AsRefStr,
+    strum_macros::EnumCount,
     strum_macros::EnumString,
     strum_macros::IntoStaticStr,
 )]
@@ -1263,6 +1270,254 @@ pub enum Pure {
     Xenon,
 }
 
+/// Trivial outputs _(constants of the substance with the default backend)_.
+///
+/// They are kept in a process-wide table keyed by the substance, which is filled
+/// with all trivial outputs of the substance on the first access to any of them.
+/// Further accesses need neither a [`Fluid`](crate::fluid::Fluid) instance nor any FFI call.
+///
+/// # Examples
+///
+/// ```
+/// use approx::assert_relative_eq;
+/// use rfluids::prelude::*;
+///
+/// assert_relative_eq!(Pure::Water.critical_temperature()?, 647.096, max_relative = 1e-6);
+/// assert_relative_eq!(Pure::Water.molar_mass()?, 0.018_015_268, max_relative = 1e-6);
+/// # Ok::<(), rfluids::Error>(())
+/// ```
+impl Pure {
+    /// Acentric factor **\[dimensionless\]**.
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`FluidOutputError`](crate::fluid::FluidOutputError) if the property
+    /// is not available for the substance.
+    pub fn acentric_factor(self) -> OutputResult<f64> {
+        pure_trivial_output(self, FluidTrivialParam::AcentricFactor, |_| true)
+    }
+
+    /// Critical point mass density **\[kg/m³\]**.
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`FluidOutputError`](crate::fluid::FluidOutputError) if the property
+    /// is not available for the substance.
+    pub fn critical_density(self) -> OutputResult<f64> {
+        pure_trivial_output(self, FluidTrivialParam::DMassCritical, |x| x > 0.0)
+    }
+
+    /// Critical point molar density **\[mol/m³\]**.
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`FluidOutputError`](crate::fluid::FluidOutputError) if the property
+    /// is not available for the substance.
+    pub fn critical_molar_density(self) -> OutputResult<f64> {
+        pure_trivial_output(self, FluidTrivialParam::DMolarCritical, |x| x > 0.0)
+    }
+
+    /// Critical point pressure **\[Pa\]**.
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`FluidOutputError`](crate::fluid::FluidOutputError) if the property
+    /// is not available for the substance.
+    pub fn critical_pressure(self) -> OutputResult<f64> {
+        pure_trivial_output(self, FluidTrivialParam::PCritical, |x| x > 0.0)
+    }
+
+    /// Critical point temperature **\[K\]**.
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`FluidOutputError`](crate::fluid::FluidOutputError) if the property
+    /// is not available for the substance.
+    pub fn critical_temperature(self) -> OutputResult<f64> {
+        pure_trivial_output(self, FluidTrivialParam::TCritical, |x| x > 0.0)
+    }
+
+    /// Flammability hazard index **\[dimensionless\]**.
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`FluidOutputError`](crate::fluid::FluidOutputError) if the property
+    /// is not available for the substance.
+    pub fn flammability_hazard(self) -> OutputResult<f64> {
+        pure_trivial_output(self, FluidTrivialParam::FH, |x| x >= 0.0)
+    }
+
+    /// 20-year global warming potential **\[dimensionless\]**.
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`FluidOutputError`](crate::fluid::FluidOutputError) if the property
+    /// is not available for the substance.
+    pub fn gwp20(self) -> OutputResult<f64> {
+        pure_trivial_output(self, FluidTrivialParam::GWP20, |x| x >= 0.0)
+    }
+
+    /// 100-year global warming potential **\[dimensionless\]**.
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`FluidOutputError`](crate::fluid::FluidOutputError) if the property
+    /// is not available for the substance.
+    pub fn gwp100(self) -> OutputResult<f64> {
+        pure_trivial_output(self, FluidTrivialParam::GWP100, |x| x >= 0.0)
+    }
+
+    /// 500-year global warming potential **\[dimensionless\]**.
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`FluidOutputError`](crate::fluid::FluidOutputError) if the property
+    /// is not available for the substance.
+    pub fn gwp500(self) -> OutputResult<f64> {
+        pure_trivial_output(self, FluidTrivialParam::GWP500, |x| x >= 0.0)
+    }
+
+    /// Health hazard index **\[dimensionless\]**.
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`FluidOutputError`](crate::fluid::FluidOutputError) if the property
+    /// is not available for the substance.
+    pub fn health_hazard(self) -> OutputResult<f64> {
+        pure_trivial_output(self, FluidTrivialParam::HH, |x| x >= 0.0)
+    }
+
+    /// Maximum pressure **\[Pa\]**.
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`FluidOutputError`](crate::fluid::FluidOutputError) if the property
+    /// is not available for the substance.
+    pub fn max_pressure(self) -> OutputResult<f64> {
+        pure_trivial_output(self, FluidTrivialParam::PMax, |x| x > 0.0)
+    }
+
+    /// Maximum temperature **\[K\]**.
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`FluidOutputError`](crate::fluid::FluidOutputError) if the property
+    /// is not available for the substance.
+    pub fn max_temperature(self) -> OutputResult<f64> {
+        pure_trivial_output(self, FluidTrivialParam::TMax, |x| x > 0.0)
+    }
+
+    /// Minimum pressure **\[Pa\]**.
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`FluidOutputError`](crate::fluid::FluidOutputError) if the property
+    /// is not available for the substance.
+    pub fn min_pressure(self) -> OutputResult<f64> {
+        pure_trivial_output(self, FluidTrivialParam::PMin, |x| x > 0.0)
+    }
+
+    /// Minimum temperature **\[K\]**.
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`FluidOutputError`](crate::fluid::FluidOutputError) if the property
+    /// is not available for the substance.
+    pub fn min_temperature(self) -> OutputResult<f64> {
+        pure_trivial_output(self, FluidTrivialParam::TMin, |x| x > 0.0)
+    }
+
+    /// Molar mass **\[kg/mol\]**.
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`FluidOutputError`](crate::fluid::FluidOutputError) if the property
+    /// is not available for the substance.
+    pub fn molar_mass(self) -> OutputResult<f64> {
+        pure_trivial_output(self, FluidTrivialParam::MolarMass, |x| x > 0.0)
+    }
+
+    /// Ozone depletion potential **\[dimensionless\]**.
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`FluidOutputError`](crate::fluid::FluidOutputError) if the property
+    /// is not available for the substance.
+    pub fn odp(self) -> OutputResult<f64> {
+        pure_trivial_output(self, FluidTrivialParam::ODP, |x| x >= 0.0)
+    }
+
+    /// Physical hazard index **\[dimensionless\]**.
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`FluidOutputError`](crate::fluid::FluidOutputError) if the property
+    /// is not available for the substance.
+    pub fn physical_hazard(self) -> OutputResult<f64> {
+        pure_trivial_output(self, FluidTrivialParam::PH, |x| x >= 0.0)
+    }
+
+    /// Reducing point mass density **\[kg/m³\]**.
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`FluidOutputError`](crate::fluid::FluidOutputError) if the property
+    /// is not available for the substance.
+    pub fn reducing_density(self) -> OutputResult<f64> {
+        mul(self.reducing_molar_density(), self.molar_mass())
+    }
+
+    /// Reducing point molar density **\[mol/m³\]**.
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`FluidOutputError`](crate::fluid::FluidOutputError) if the property
+    /// is not available for the substance.
+    pub fn reducing_molar_density(self) -> OutputResult<f64> {
+        pure_trivial_output(self, FluidTrivialParam::DMolarReducing, |x| x > 0.0)
+    }
+
+    /// Reducing point pressure **\[Pa\]**.
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`FluidOutputError`](crate::fluid::FluidOutputError) if the property
+    /// is not available for the substance.
+    pub fn reducing_pressure(self) -> OutputResult<f64> {
+        pure_trivial_output(self, FluidTrivialParam::PReducing, |x| x > 0.0)
+    }
+
+    /// Reducing point temperature **\[K\]**.
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`FluidOutputError`](crate::fluid::FluidOutputError) if the property
+    /// is not available for the substance.
+    pub fn reducing_temperature(self) -> OutputResult<f64> {
+        pure_trivial_output(self, FluidTrivialParam::TReducing, |x| x > 0.0)
+    }
+
+    /// Triple point pressure **\[Pa\]**.
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`FluidOutputError`](crate::fluid::FluidOutputError) if the property
+    /// is not available for the substance.
+    pub fn triple_pressure(self) -> OutputResult<f64> {
+        pure_trivial_output(self, FluidTrivialParam::PTriple, |x| x > 0.0)
+    }
+
+    /// Triple point temperature **\[K\]**.
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`FluidOutputError`](crate::fluid::FluidOutputError) if the property
+    /// is not available for the substance.
+    pub fn triple_temperature(self) -> OutputResult<f64> {
+        pure_trivial_output(self, FluidTrivialParam::TTriple, |x| x > 0.0)
+    }
+}
+
 #[cfg(test)]
 mod tests {
     use std::str::FromStr;
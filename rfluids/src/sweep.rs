@@ -0,0 +1,479 @@
+//! Parallel property maps and parameter sweeps.
+//!
+//! [`grid`] calculates the output parameters of the substance over the dense grid
+//! of two input properties _(e.g., pressure and temperature or pressure and enthalpy)_,
+//! which is suitable for chart generation or tabulation.
+//!
+//! # Examples
+//!
+//! ```
+//! use rfluids::{
+//!     prelude::*,
+//!     sweep::{self, Axis},
+//! };
+//!
+//! let res = sweep::grid(
+//!     Pure::Water,
+//!     BaseBackend::Heos,
+//!     &Axis::linspace(FluidParam::P, 100e3, 1e6, 10),
+//!     &Axis::linspace(FluidParam::T, 283.15, 573.15, 30),
+//!     &[FluidParam::DMass, FluidParam::HMass],
+//! )?;
+//! assert_eq!(res.output(FluidParam::DMass).unwrap().len(), 10 * 30);
+//! assert_eq!(res.failed_count(), 0);
+//! # Ok::<(), rfluids::Error>(())
+//! ```
+
+use std::{
+    num::NonZeroUsize,
+    sync::{
+        Mutex,
+        atomic::{AtomicUsize, Ordering},
+    },
+    thread,
+};
+
+use crate::{
+    fluid::{PooledState, backend::Backend},
+    io::{FluidInputPair, FluidParam},
+    native::CoolPropError,
+    substance::Substance,
+};
+
+/// Number of grid points claimed by the thread at once
+/// _(equal to the number of bits in the word of the failed points bitmap)_.
+const CHUNK_LEN: usize = u64::BITS as usize;
+
+/// Axis of the [`grid`].
+#[derive(Clone, Debug, PartialEq)]
+pub struct Axis {
+    key: FluidParam,
+    values: Vec<f64>,
+}
+
+impl Axis {
+    /// Creates a new axis with the specified values.
+    ///
+    /// # Arguments
+    ///
+    /// - `key` -- input property
+    /// - `values` -- values of the input property **\[SI units\]**
+    #[must_use]
+    pub fn new(key: FluidParam, values: impl Into<Vec<f64>>) -> Self {
+        Self { key, values: values.into() }
+    }
+
+    /// Creates a new axis with `count` evenly spaced values from `start` to `end`
+    /// _(both inclusive)_.
+    ///
+    /// # Arguments
+    ///
+    /// - `key` -- input property
+    /// - `start` -- first value **\[SI units\]**
+    /// - `end` -- last value **\[SI units\]**
+    /// - `count` -- number of values
+    #[must_use]
+    pub fn linspace(key: FluidParam, start: f64, end: f64, count: usize) -> Self {
+        let step = if count > 1 { (end - start) / (count - 1) as f64 } else { 0.0 };
+        Self::new(key, (0..count).map(|i| start + step * i as f64).collect::<Vec<_>>())
+    }
+
+    /// Input property.
+    #[must_use]
+    pub fn key(&self) -> FluidParam {
+        self.key
+    }
+
+    /// Values of the input property **\[SI units\]**.
+    #[must_use]
+    pub fn values(&self) -> &[f64] {
+        &self.values
+    }
+
+    /// Number of values.
+    #[must_use]
+    pub fn len(&self) -> usize {
+        self.values.len()
+    }
+
+    /// Returns `true` if there are no values.
+    #[must_use]
+    pub fn is_empty(&self) -> bool {
+        self.values.is_empty()
+    }
+}
+
+/// Result of the [`grid`] calculation.
+#[derive(Clone, Debug, PartialEq)]
+pub struct Grid {
+    axis1: Axis,
+    axis2: Axis,
+    output_keys: Vec<FluidParam>,
+    values: Vec<f64>,
+    failed: Vec<u64>,
+}
+
+impl Grid {
+    /// First axis.
+    #[must_use]
+    pub fn axis1(&self) -> &Axis {
+        &self.axis1
+    }
+
+    /// Second axis.
+    #[must_use]
+    pub fn axis2(&self) -> &Axis {
+        &self.axis2
+    }
+
+    /// Calculated output parameters.
+    #[must_use]
+    pub fn output_keys(&self) -> &[FluidParam] {
+        &self.output_keys
+    }
+
+    /// Dense cube of the output values **\[SI units\]**, i.e., the value of the `k`-th output
+    /// parameter at the `i`-th value of the first axis and the `j`-th value of the second axis
+    /// is at index `(k * axis1.len() + i) * axis2.len() + j`.
+    ///
+    /// Values at the failed points are [`f64::NAN`].
+    #[must_use]
+    pub fn values(&self) -> &[f64] {
+        &self.values
+    }
+
+    /// Values of the output parameter in row-major order **\[SI units\]**
+    /// _(`None` if it's not calculated)_, i.e., the value at the `i`-th value of the first axis
+    /// and the `j`-th value of the second axis is at index `i * axis2.len() + j`.
+    ///
+    /// # Arguments
+    ///
+    /// - `key` -- output parameter
+    #[must_use]
+    pub fn output(&self, key: FluidParam) -> Option<&[f64]> {
+        let index = self.output_keys.iter().position(|&x| x == key)?;
+        let len = self.len();
+        Some(&self.values[index * len..][..len])
+    }
+
+    /// Value of the output parameter at the grid point **\[SI units\]**
+    /// _(`None` if it's not calculated or the indices are out of bounds)_.
+    ///
+    /// # Arguments
+    ///
+    /// - `key` -- output parameter
+    /// - `i` -- index of the first axis value
+    /// - `j` -- index of the second axis value
+    #[must_use]
+    pub fn get(&self, key: FluidParam, i: usize, j: usize) -> Option<f64> {
+        let index = self.index(i, j)?;
+        self.output(key).map(|values| values[index])
+    }
+
+    /// Returns `true` if the state at the grid point can't be calculated
+    /// _(or the indices are out of bounds)_.
+    ///
+    /// # Arguments
+    ///
+    /// - `i` -- index of the first axis value
+    /// - `j` -- index of the second axis value
+    #[must_use]
+    pub fn is_failed(&self, i: usize, j: usize) -> bool {
+        self.index(i, j)
+            .is_none_or(|index| self.failed[index / CHUNK_LEN] >> (index % CHUNK_LEN) & 1 == 1)
+    }
+
+    /// Number of grid points where the state can't be calculated.
+    #[must_use]
+    pub fn failed_count(&self) -> usize {
+        self.failed.iter().map(|word| word.count_ones() as usize).sum()
+    }
+
+    /// Number of grid points.
+    #[must_use]
+    pub fn len(&self) -> usize {
+        self.axis1.values.len() * self.axis2.values.len()
+    }
+
+    /// Returns `true` if there are no grid points.
+    #[must_use]
+    pub fn is_empty(&self) -> bool {
+        self.len() == 0
+    }
+
+    fn index(&self, i: usize, j: usize) -> Option<usize> {
+        (i < self.axis1.values.len() && j < self.axis2.values.len())
+            .then(|| i * self.axis2.values.len() + j)
+    }
+}
+
+/// Error during [`grid`] calculation.
+#[derive(Clone, Debug, Eq, PartialEq, thiserror::Error)]
+pub enum SweepError {
+    /// Specified axes are not a valid input pair.
+    #[error("specified axes (`{0:?}`, `{1:?}`) are not a valid input pair")]
+    InvalidInputPair(FluidParam, FluidParam),
+
+    /// Failed to create the native handle for the substance and backend.
+    #[error("unable to create the native handle: {0}")]
+    BuildFailed(#[from] CoolPropError),
+}
+
+/// Calculates the output parameters of the substance over the dense grid of two input
+/// properties in parallel.
+///
+/// Grid points are claimed by the threads in small chunks from the shared counter,
+/// so the threads that got slowly converging points _(e.g., near the saturation curve)_
+/// get fewer chunks instead of stalling the whole calculation. Native handles are checked out
+/// from the pool of the calling thread and returned to it afterwards _(so they are reused
+/// by the further calls)_, and each chunk is calculated by a single batch update.
+///
+/// If the state can't be calculated at some point, it's marked in the failed points
+/// bitmap _(see [`Grid::is_failed`])_ and its output values are set to [`f64::NAN`].
+/// Output values that can't be calculated at the valid points are also set to [`f64::NAN`].
+///
+/// # Arguments
+///
+/// - `substance` -- substance
+/// - `backend` -- `CoolProp` backend
+/// - `axis1` -- first axis _(outer)_
+/// - `axis2` -- second axis _(inner)_
+/// - `output_keys` -- output parameters
+///
+/// # Errors
+///
+/// Returns a [`SweepError`] for axes that are not a valid input pair
+/// or if the native handle can't be created for the substance and backend.
+///
+/// # See Also
+///
+/// - [`FluidBatch`](crate::fluid::FluidBatch)
+pub fn grid(
+    substance: impl Into<Substance>,
+    backend: impl Into<Backend>,
+    axis1: &Axis,
+    axis2: &Axis,
+    output_keys: &[FluidParam],
+) -> Result<Grid, SweepError> {
+    let input_pair = FluidInputPair::try_from((axis1.key, axis2.key))
+        .map_err(|_| SweepError::InvalidInputPair(axis1.key, axis2.key))?;
+    let input_keys = <(FluidParam, FluidParam)>::from(input_pair);
+    // The first input is always available at the valid points,
+    // so it marks the failed points in the batch outputs
+    let batch_keys: Vec<FluidParam> =
+        [input_keys.0].into_iter().chain(output_keys.iter().copied()).collect();
+    let job = Job {
+        input_pair,
+        swap_inputs: input_keys.0 != axis1.key,
+        axis1: &axis1.values,
+        axis2: &axis2.values,
+        batch_keys: &batch_keys,
+    };
+    let len = axis1.values.len() * axis2.values.len();
+    let mut values = vec![f64::NAN; len * output_keys.len()];
+    let mut status = vec![f64::NAN; len];
+    let mut failed = vec![0; len.div_ceil(CHUNK_LEN)];
+    // Each chunk of grid points owns one word of the bitmap and one slice of each batch output
+    let mut chunks: Vec<(&mut u64, Vec<&mut [f64]>)> =
+        failed.iter_mut().map(|word| (word, Vec::with_capacity(batch_keys.len()))).collect();
+    if len > 0 {
+        for output in status.chunks_mut(len).chain(values.chunks_mut(len)) {
+            for ((_, slices), values) in chunks.iter_mut().zip(output.chunks_mut(CHUNK_LEN)) {
+                slices.push(values);
+            }
+        }
+    }
+    let chunks: Vec<Mutex<_>> = chunks.into_iter().map(Mutex::new).collect();
+    let next = AtomicUsize::new(0);
+    let threads = thread::available_parallelism().map_or(1, NonZeroUsize::get).min(chunks.len());
+    // Native handles are checked out on the current thread and returned to its pool
+    // after the workers are joined, so they are reused by the further calls
+    let request = substance.into().into_with_backend(backend);
+    let mut states = (0..threads.max(1))
+        .map(|_| PooledState::checkout(&request))
+        .collect::<Result<Vec<_>, CoolPropError>>()?;
+    let work = |state: &mut PooledState| loop {
+        let index = next.fetch_add(1, Ordering::Relaxed);
+        let Some(chunk) = chunks.get(index) else {
+            return;
+        };
+        let mut chunk = chunk.lock().unwrap();
+        let (word, slices) = &mut *chunk;
+        job.calculate(state, index * CHUNK_LEN, word, slices);
+    };
+    let mut first_state = states.swap_remove(0);
+    thread::scope(|scope| {
+        let workers: Vec<_> = states
+            .into_iter()
+            .map(|mut state| {
+                scope.spawn(move || {
+                    work(&mut state);
+                    state
+                })
+            })
+            .collect();
+        work(&mut first_state);
+        // Handles are moved back, so they are dropped into the pool of the current thread
+        for worker in workers {
+            drop(worker.join().unwrap());
+        }
+    });
+    drop(chunks);
+    Ok(Grid {
+        axis1: axis1.clone(),
+        axis2: axis2.clone(),
+        output_keys: output_keys.to_vec(),
+        values,
+        failed,
+    })
+}
+
+/// Shared parameters of the chunk calculations.
+struct Job<'a> {
+    input_pair: FluidInputPair,
+    swap_inputs: bool,
+    axis1: &'a [f64],
+    axis2: &'a [f64],
+    batch_keys: &'a [FluidParam],
+}
+
+impl Job<'_> {
+    /// Calculates the chunk of grid points by a single batch update. The first of `columns`
+    /// holds the values of the first input, which are [`f64::NAN`] at the failed points.
+    fn calculate(
+        &self,
+        state: &mut PooledState,
+        start: usize,
+        failed: &mut u64,
+        columns: &mut [&mut [f64]],
+    ) {
+        let len = CHUNK_LEN.min(self.axis1.len() * self.axis2.len() - start);
+        let (mut input1, mut input2) = ([0.0; CHUNK_LEN], [0.0; CHUNK_LEN]);
+        for offset in 0..len {
+            let index = start + offset;
+            let (i, j) = (index / self.axis2.len(), index % self.axis2.len());
+            (input1[offset], input2[offset]) = if self.swap_inputs {
+                (self.axis2[j], self.axis1[i])
+            } else {
+                (self.axis1[i], self.axis2[j])
+            };
+        }
+        let res = state.update_batch_columns(
+            self.input_pair,
+            &input1[..len],
+            &input2[..len],
+            self.batch_keys,
+            columns,
+        );
+        if res.is_err() {
+            columns.iter_mut().for_each(|column| column.fill(f64::NAN));
+        }
+        *failed = columns[0]
+            .iter()
+            .enumerate()
+            .filter(|(_, value)| value.is_nan())
+            .fold(0, |word, (offset, _)| word | 1 << offset);
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::{
+        fluid::{Fluid, backend::BaseBackend},
+        io::FluidInput,
+        substance::Pure,
+        test::assert_relative_eq,
+    };
+
+    #[test]
+    fn grid_matches_fluid() {
+        // Given
+        let pressure = Axis::linspace(FluidParam::P, 100e3, 1e6, 7);
+        let temperature = Axis::linspace(FluidParam::T, 283.15, 573.15, 23);
+
+        // When
+        let res = grid(
+            Pure::Water,
+            BaseBackend::Heos,
+            &temperature,
+            &pressure,
+            &[FluidParam::DMass, FluidParam::HMass],
+        )
+        .unwrap();
+
+        // Then
+        assert_eq!(res.values().len(), 2 * 7 * 23);
+        assert_eq!(res.failed_count(), 0);
+        for (i, j) in [(0, 0), (11, 3), (22, 6)] {
+            let mut expected = Fluid::from(Pure::Water)
+                .in_state(
+                    FluidInput::temperature(temperature.values()[i]),
+                    FluidInput::pressure(pressure.values()[j]),
+                )
+                .unwrap();
+            assert_relative_eq!(
+                res.get(FluidParam::DMass, i, j).unwrap(),
+                expected.density().unwrap()
+            );
+            assert_relative_eq!(
+                res.get(FluidParam::HMass, i, j).unwrap(),
+                expected.enthalpy().unwrap()
+            );
+        }
+    }
+
+    #[test]
+    fn grid_failed_points() {
+        // Given
+        let pressure = Axis::new(FluidParam::P, [-1.0, 101_325.0]);
+        let temperature = Axis::new(FluidParam::T, [293.15]);
+
+        // When
+        let res =
+            grid(Pure::Water, BaseBackend::Heos, &pressure, &temperature, &[FluidParam::DMass])
+                .unwrap();
+
+        // Then
+        assert_eq!(res.failed_count(), 1);
+        assert!(res.is_failed(0, 0));
+        assert!(!res.is_failed(1, 0));
+        assert!(res.get(FluidParam::DMass, 0, 0).unwrap().is_nan());
+        assert_relative_eq!(res.get(FluidParam::DMass, 1, 0).unwrap(), 998.207_150_467_928_4);
+    }
+
+    #[test]
+    fn grid_invalid_input_pair() {
+        // Given
+        let pressure = Axis::linspace(FluidParam::P, 100e3, 1e6, 2);
+
+        // When
+        let res = grid(Pure::Water, BaseBackend::Heos, &pressure, &pressure, &[FluidParam::DMass]);
+
+        // Then
+        assert_eq!(res, Err(SweepError::InvalidInputPair(FluidParam::P, FluidParam::P)));
+    }
+
+    #[test]
+    fn grid_invalid_backend() {
+        // Given
+        let pressure = Axis::linspace(FluidParam::P, 100e3, 1e6, 2);
+        let temperature = Axis::linspace(FluidParam::T, 283.15, 573.15, 2);
+
+        // When
+        let res = grid(Pure::R32, BaseBackend::If97, &pressure, &temperature, &[FluidParam::DMass]);
+
+        // Then
+        assert!(matches!(res, Err(SweepError::BuildFailed(_))));
+    }
+
+    #[test]
+    fn linspace() {
+        // When
+        let res = Axis::linspace(FluidParam::T, 280.0, 300.0, 5);
+
+        // Then
+        assert_eq!(res.key(), FluidParam::T);
+        assert_eq!(res.values(), &[280.0, 285.0, 290.0, 295.0, 300.0]);
+    }
+}
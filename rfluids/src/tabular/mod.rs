@@ -0,0 +1,307 @@
+//! Ahead-of-time generation and loading of `CoolProp` tabular data.
+//!
+//! Tabular backends (e.g., `TTSE&HEOS`) require gridded data, which `CoolProp` builds
+//! on the first use of each substance _(it usually takes several seconds)_ and then writes
+//! into the tables directory ([`Config::alt_tables_path`](crate::config::Config::alt_tables_path)
+//! or `${HOME}/.CoolProp/Tables` by default). Once the data is in memory, it's shared by all
+//! instances with the same substance and backend within the process.
+//!
+//! This module allows moving this cost out of the hot path:
+//!
+//! - [`prebuild`] -- generates the tables into the specified directory ahead of time
+//!   _(e.g., while building a container image)_
+//! - [`load`] -- points `CoolProp` to the directory with already generated tables
+//!   _(it can be read-only)_ and loads them into memory _(e.g., at application startup)_
+//!
+//! Both functions return a [`TabularReport`] with the elapsed time for each item.
+//!
+//! Alternatively, [`PropertyTable`] generates its own tables and evaluates them entirely
+//! in Rust, without going through the FFI on each lookup.
+//!
+//! # Examples
+//!
+//! ```no_run
+//! use rfluids::{prelude::*, tabular};
+//!
+//! let items: [(Substance, TabularMethod); 2] =
+//!     [(Pure::Water.into(), TabularMethod::Bicubic), (Pure::R32.into(), TabularMethod::Ttse)];
+//!
+//! // While building the image
+//! let report = tabular::prebuild(&items, "/opt/tables")?;
+//! println!("Tables were built in {:?}", report.total());
+//!
+//! // At application startup
+//! let report = tabular::load(&items, "/opt/tables")?;
+//! println!("Tables were loaded in {:?}", report.total());
+//! # Ok::<(), rfluids::Error>(())
+//! ```
+//!
+//! # See Also
+//!
+//! - [Tabular Interpolation](https://coolprop.org/coolprop/Tabular.html)
+
+use std::{
+    fs,
+    path::{Path, PathBuf},
+    time::{Duration, Instant},
+};
+
+use crate::{
+    config,
+    fluid::backend::{Backend, BaseBackend, DefaultBackend, TabularMethod},
+    io::FluidParam,
+    native::{AbstractState, CoolPropError, composition},
+    substance::Substance,
+};
+
+mod table;
+
+pub use table::PropertyTable;
+
+/// Generates the tabular data for the specified substances and tabular methods
+/// into the specified directory and sets it as the tables directory for all further calculations.
+///
+/// Tabular methods are combined with the default base backend of each substance
+/// _(e.g., `HEOS` for pure substances)_. Already generated tables are just loaded.
+///
+/// # Arguments
+///
+/// - `items` -- substances and tabular methods to generate the tables for
+/// - `dir` -- tables directory _(it will be created if it doesn't exist)_
+///
+/// # Errors
+///
+/// Returns a [`TabularError`] if the directory can't be created
+/// or `CoolProp` fails to build the tables.
+///
+/// # See Also
+///
+/// - [`load`]
+pub fn prebuild(
+    items: &[(Substance, TabularMethod)],
+    dir: impl AsRef<Path>,
+) -> Result<TabularReport, TabularError> {
+    let dir = dir.as_ref();
+    fs::create_dir_all(dir)
+        .map_err(|e| TabularError::InvalidDirectory(dir.to_path_buf(), e.to_string()))?;
+    process(items, dir)
+}
+
+/// Sets the specified directory with already generated tabular data as the tables directory
+/// for all further calculations and loads the tables for the specified substances
+/// and tabular methods into memory.
+///
+/// Tabular methods are combined with the default base backend of each substance
+/// _(e.g., `HEOS` for pure substances)_. If some tables are missing, `CoolProp` builds them
+/// and tries to write them into the directory.
+///
+/// # Arguments
+///
+/// - `items` -- substances and tabular methods to load the tables for
+/// - `dir` -- tables directory _(it can be read-only)_
+///
+/// # Errors
+///
+/// Returns a [`TabularError`] if the directory doesn't exist
+/// or `CoolProp` fails to load the tables.
+///
+/// # See Also
+///
+/// - [`prebuild`]
+pub fn load(
+    items: &[(Substance, TabularMethod)],
+    dir: impl AsRef<Path>,
+) -> Result<TabularReport, TabularError> {
+    let dir = dir.as_ref();
+    if !dir.is_dir() {
+        return Err(TabularError::InvalidDirectory(
+            dir.to_path_buf(),
+            "it doesn't exist or it's not a directory".into(),
+        ));
+    }
+    process(items, dir)
+}
+
+/// Report of the tabular data generation or loading.
+#[derive(Clone, Debug, PartialEq)]
+pub struct TabularReport {
+    /// Absolute path to the tables directory.
+    pub dir: PathBuf,
+
+    /// Report entries in the same order as the requested items.
+    pub entries: Vec<TabularReportEntry>,
+}
+
+impl TabularReport {
+    /// Total elapsed time.
+    #[must_use]
+    pub fn total(&self) -> Duration {
+        self.entries.iter().map(|entry| entry.elapsed).sum()
+    }
+}
+
+/// Entry of the [`TabularReport`].
+#[derive(Clone, Debug, PartialEq)]
+pub struct TabularReportEntry {
+    /// Substance.
+    pub substance: Substance,
+
+    /// Tabular backend.
+    pub backend: Backend,
+
+    /// Elapsed time of the tables generation or loading.
+    pub elapsed: Duration,
+}
+
+/// Error during tabular data generation or loading.
+#[derive(Clone, Debug, PartialEq, thiserror::Error)]
+pub enum TabularError {
+    /// Invalid tables directory.
+    #[error("invalid tables directory `{0}`: {1}")]
+    InvalidDirectory(PathBuf, String),
+
+    /// `CoolProp` failed to build or load the tables.
+    #[error("failed to build or load tables for `{substance}` with `{backend}` backend: {source}")]
+    Failed {
+        /// Substance name.
+        substance: String,
+        /// Backend name.
+        backend: String,
+        /// `CoolProp` error.
+        source: CoolPropError,
+    },
+
+    /// Invalid grid of the [`PropertyTable`].
+    #[error("invalid tabular grid: {0}")]
+    InvalidGrid(String),
+
+    /// Output parameter is not tabulated in the [`PropertyTable`].
+    #[error("specified output parameter `{0:?}` is not tabulated")]
+    NotTabulated(FluidParam),
+
+    /// Output parameter value is not available in the [`PropertyTable`].
+    #[error(
+        "output value of `{param:?}` is not available at P = {pressure} Pa, H = {enthalpy} J/kg"
+    )]
+    NotAvailable {
+        /// Output parameter.
+        param: FluidParam,
+        /// Pressure **\[Pa\]**.
+        pressure: f64,
+        /// Specific enthalpy **\[J/kg\]**.
+        enthalpy: f64,
+    },
+}
+
+fn process(
+    items: &[(Substance, TabularMethod)],
+    dir: &Path,
+) -> Result<TabularReport, TabularError> {
+    let dir = dir
+        .canonicalize()
+        .map_err(|e| TabularError::InvalidDirectory(dir.to_path_buf(), e.to_string()))?;
+    let mut cfg = config::read();
+    if cfg.alt_tables_path.as_ref() != Some(&dir) {
+        cfg.alt_tables_path = Some(dir.clone());
+        config::update(cfg);
+    }
+    let entries = items
+        .iter()
+        .map(|(substance, method)| {
+            let backend = tabular_backend(substance, *method);
+            let start = Instant::now();
+            build(substance, backend).map_err(|e| TabularError::Failed {
+                substance: substance.name().into_owned(),
+                backend: backend.name().into_owned(),
+                source: e,
+            })?;
+            Ok(TabularReportEntry {
+                substance: substance.clone(),
+                backend,
+                elapsed: start.elapsed(),
+            })
+        })
+        .collect::<Result<_, _>>()?;
+    Ok(TabularReport { dir, entries })
+}
+
+fn tabular_backend(substance: &Substance, method: TabularMethod) -> Backend {
+    base_backend(substance).with(method)
+}
+
+fn base_backend(substance: &Substance) -> BaseBackend {
+    match substance.default_backend() {
+        Backend::Base(base) | Backend::Tabular { base, .. } => base,
+    }
+}
+
+/// Creates a native handle for the tabular backend, which makes `CoolProp` build
+/// _(or load)_ the tables and keep them in memory for all further instances.
+fn build(substance: &Substance, backend: Backend) -> Result<(), CoolPropError> {
+    native_state(substance, backend).map(drop)
+}
+
+fn native_state(substance: &Substance, backend: Backend) -> Result<AbstractState, CoolPropError> {
+    let (composition_id, fractions) = composition(substance);
+    let mut state = AbstractState::new(backend.name(), composition_id)?;
+    if let Some(fractions) = fractions {
+        state.set_fractions(&fractions)?;
+    }
+    Ok(state)
+}
+
+#[cfg(test)]
+mod tests {
+    use rstest::*;
+
+    use super::*;
+    use crate::substance::{BinaryMixKind, Pure};
+
+    #[rstest]
+    #[case(Pure::Water.into(), TabularMethod::Ttse, BaseBackend::Heos.with(TabularMethod::Ttse))]
+    #[case(
+        BinaryMixKind::MPG.with_fraction(0.4).unwrap().into(),
+        TabularMethod::Bicubic,
+        BaseBackend::Incomp.with(TabularMethod::Bicubic)
+    )]
+    fn tabular_backend(
+        #[case] substance: Substance,
+        #[case] method: TabularMethod,
+        #[case] expected: Backend,
+    ) {
+        // When
+        let res = super::tabular_backend(&substance, method);
+
+        // Then
+        assert_eq!(res, expected);
+    }
+
+    #[test]
+    fn load_invalid_directory() {
+        // Given
+        let dir = std::env::temp_dir().join("rfluids-tabular-missing-dir");
+
+        // When
+        let res = load(&[(Pure::Water.into(), TabularMethod::Ttse)], &dir);
+
+        // Then
+        assert!(matches!(res, Err(TabularError::InvalidDirectory(path, _)) if path == dir));
+    }
+
+    #[test]
+    fn report_total() {
+        // Given
+        let entry = |millis| TabularReportEntry {
+            substance: Pure::Water.into(),
+            backend: BaseBackend::Heos.with(TabularMethod::Ttse),
+            elapsed: Duration::from_millis(millis),
+        };
+        let sut = TabularReport { dir: PathBuf::from("tables"), entries: vec![entry(1), entry(2)] };
+
+        // When
+        let res = sut.total();
+
+        // Then
+        assert_eq!(res, Duration::from_millis(3));
+    }
+}
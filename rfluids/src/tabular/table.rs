@@ -0,0 +1,602 @@
+use std::ops::RangeInclusive;
+
+use super::{TabularError, base_backend, native_state};
+use crate::{
+    fluid::backend::{Backend, TabularMethod},
+    io::{FluidInputPair, FluidParam},
+    substance::Substance,
+};
+
+/// Default number of grid nodes along each axis.
+const DEFAULT_NODES: usize = 200;
+
+/// Number of points evaluated together by [`PropertyTable::output_batch`].
+const LANES: usize = 8;
+
+/// Property table in pressure -- specific enthalpy coordinates evaluated entirely in Rust.
+///
+/// Unlike tabular backends _(e.g., `TTSE&HEOS`)_, lookups don't go through the FFI
+/// and `CoolProp` locks, so they are cheap enough for tight loops _(e.g., CFD coupling)_
+/// and can be evaluated concurrently from any number of threads.
+///
+/// The table is generated once through the default base backend of the substance
+/// _(e.g., `HEOS` for pure substances)_ over a grid with logarithmically spaced pressure
+/// nodes and linearly spaced specific enthalpy nodes. Values are stored as a struct of arrays
+/// _(one contiguous column per output and derivative)_, and derivatives at the nodes are
+/// estimated by finite differences. Depending on the [`TabularMethod`], outputs are evaluated by:
+///
+/// - [`TabularMethod::Ttse`] -- second order Taylor series expansion around the nearest node
+/// - [`TabularMethod::Bicubic`] -- bicubic Hermite interpolation over the enclosing cell
+///
+/// Points outside the grid or close to the nodes where `CoolProp` fails
+/// to calculate the state are not available.
+///
+/// # Examples
+///
+/// ```
+/// use rfluids::{prelude::*, tabular::PropertyTable};
+///
+/// let table = PropertyTable::builder()
+///     .substance(Pure::Water)
+///     .method(TabularMethod::Bicubic)
+///     .outputs([FluidParam::T, FluidParam::DMass])
+///     .pressure(1e5..=1e6)
+///     .enthalpy(1e5..=4e5)
+///     .pressure_nodes(50)
+///     .enthalpy_nodes(50)
+///     .build()?;
+///
+/// let temperature = table.output(FluidParam::T, 101_325.0, 2e5)?;
+/// assert!((temperature - 320.93).abs() < 0.1);
+///
+/// let mut densities = [0.0; 3];
+/// table.output_batch(FluidParam::DMass, &[1e5, 2e5, 5e5], &[2e5; 3], &mut densities)?;
+/// assert!(densities.iter().all(|density| (density - 989.0).abs() < 1.0));
+/// # Ok::<(), rfluids::Error>(())
+/// ```
+///
+/// # See Also
+///
+/// - [Tabular Interpolation](https://coolprop.org/coolprop/Tabular.html)
+#[derive(Clone, Debug, PartialEq)]
+pub struct PropertyTable {
+    method: TabularMethod,
+    pressure: Axis,
+    enthalpy: Axis,
+    columns: Vec<(FluidParam, Column)>,
+}
+
+#[bon::bon]
+impl PropertyTable {
+    /// Generates a new [`PropertyTable`].
+    ///
+    /// # Arguments
+    ///
+    /// - `substance` -- substance for which to calculate properties
+    /// - `method` -- tabular interpolation method
+    /// - `outputs` -- output parameters to be tabulated
+    /// - `pressure` -- pressure range **\[Pa\]**
+    /// - `enthalpy` -- specific enthalpy range **\[J/kg\]**
+    /// - `pressure_nodes` -- number of pressure nodes _(at least 3, default 200)_
+    /// - `enthalpy_nodes` -- number of specific enthalpy nodes _(at least 3, default 200)_
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`TabularError`] for invalid grid or if `CoolProp` fails
+    /// to create the native handle for the substance.
+    #[builder]
+    pub fn new(
+        /// Substance for which to calculate properties.
+        #[builder(into)]
+        substance: Substance,
+        /// Tabular interpolation method.
+        method: TabularMethod,
+        /// Output parameters to be tabulated.
+        #[builder(into)]
+        outputs: Vec<FluidParam>,
+        /// Pressure range **\[Pa\]**.
+        pressure: RangeInclusive<f64>,
+        /// Specific enthalpy range **\[J/kg\]**.
+        enthalpy: RangeInclusive<f64>,
+        /// Number of pressure nodes _(at least 3)_.
+        #[builder(default = DEFAULT_NODES)]
+        pressure_nodes: usize,
+        /// Number of specific enthalpy nodes _(at least 3)_.
+        #[builder(default = DEFAULT_NODES)]
+        enthalpy_nodes: usize,
+    ) -> Result<Self, TabularError> {
+        let pressure = Axis::new("pressure", pressure, pressure_nodes, true)?;
+        let enthalpy = Axis::new("enthalpy", enthalpy, enthalpy_nodes, false)?;
+        let backend = Backend::Base(base_backend(&substance));
+        let mut state = native_state(&substance, backend).map_err(|e| TabularError::Failed {
+            substance: substance.name().into_owned(),
+            backend: backend.name().into_owned(),
+            source: e,
+        })?;
+        let nh = enthalpy.len();
+        let mut values = vec![vec![f64::NAN; pressure.len() * nh]; outputs.len()];
+        for (i, &p) in pressure.nodes.iter().enumerate() {
+            for (j, &h) in enthalpy.nodes.iter().enumerate() {
+                if state.update(FluidInputPair::HMassP, h, p).is_err() {
+                    continue;
+                }
+                for (column, &param) in values.iter_mut().zip(&outputs) {
+                    column[i * nh + j] = state.keyed_output(param).unwrap_or(f64::NAN);
+                }
+            }
+        }
+        let columns = outputs
+            .into_iter()
+            .zip(values)
+            .map(|(param, value)| (param, Column::new(method, value, &pressure, &enthalpy)))
+            .collect();
+        Ok(Self { method, pressure, enthalpy, columns })
+    }
+}
+
+impl PropertyTable {
+    /// Tabular interpolation method.
+    #[must_use]
+    pub fn method(&self) -> TabularMethod {
+        self.method
+    }
+
+    /// Tabulated output parameters.
+    pub fn outputs(&self) -> impl Iterator<Item = FluidParam> + '_ {
+        self.columns.iter().map(|(param, _)| *param)
+    }
+
+    /// Evaluates the output parameter value at the specified point.
+    ///
+    /// # Arguments
+    ///
+    /// - `param` -- output parameter
+    /// - `pressure` -- pressure **\[Pa\]**
+    /// - `enthalpy` -- specific enthalpy **\[J/kg\]**
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`TabularError`] if the output parameter is not tabulated
+    /// or the point is not available.
+    pub fn output(
+        &self,
+        param: FluidParam,
+        pressure: f64,
+        enthalpy: f64,
+    ) -> Result<f64, TabularError> {
+        let [value] = self.eval(self.column(param)?, &[pressure], &[enthalpy]);
+        if value.is_finite() {
+            Ok(value)
+        } else {
+            Err(TabularError::NotAvailable { param, pressure, enthalpy })
+        }
+    }
+
+    /// Evaluates the output parameter values at the specified points.
+    ///
+    /// Points are processed in fixed-size chunks: lookups of the grid cells are followed
+    /// by branch-free evaluation over lane arrays, which the compiler maps to SIMD instructions
+    /// of the target. Values at the points that are not available are [`f64::NAN`].
+    ///
+    /// # Arguments
+    ///
+    /// - `param` -- output parameter
+    /// - `pressure` -- pressures **\[Pa\]**
+    /// - `enthalpy` -- specific enthalpies **\[J/kg\]**
+    /// - `out` -- buffer for the output values
+    ///
+    /// # Errors
+    ///
+    /// Returns a [`TabularError`] if the output parameter is not tabulated.
+    ///
+    /// # Panics
+    ///
+    /// Panics if the lengths of `pressure`, `enthalpy` and `out` are not equal.
+    pub fn output_batch(
+        &self,
+        param: FluidParam,
+        pressure: &[f64],
+        enthalpy: &[f64],
+        out: &mut [f64],
+    ) -> Result<(), TabularError> {
+        assert!(
+            pressure.len() == enthalpy.len() && enthalpy.len() == out.len(),
+            "lengths of inputs and output buffer must be equal"
+        );
+        let column = self.column(param)?;
+        let mut p_chunks = pressure.chunks_exact(LANES);
+        let mut h_chunks = enthalpy.chunks_exact(LANES);
+        let mut out_chunks = out.chunks_exact_mut(LANES);
+        for ((p, h), out) in p_chunks.by_ref().zip(h_chunks.by_ref()).zip(out_chunks.by_ref()) {
+            let p: &[f64; LANES] = p.try_into().unwrap();
+            let h: &[f64; LANES] = h.try_into().unwrap();
+            out.copy_from_slice(&self.eval(column, p, h));
+        }
+        let remainder = p_chunks.remainder().iter().zip(h_chunks.remainder());
+        for ((&p, &h), out) in remainder.zip(out_chunks.into_remainder()) {
+            *out = self.eval(column, &[p], &[h])[0];
+        }
+        Ok(())
+    }
+
+    fn column(&self, param: FluidParam) -> Result<&Column, TabularError> {
+        self.columns
+            .iter()
+            .find(|(p, _)| *p == param)
+            .map(|(_, column)| column)
+            .ok_or(TabularError::NotTabulated(param))
+    }
+
+    fn eval<const L: usize>(&self, column: &Column, p: &[f64; L], h: &[f64; L]) -> [f64; L] {
+        match self.method {
+            TabularMethod::Ttse => self.ttse(column, p, h),
+            TabularMethod::Bicubic => self.bicubic(column, p, h),
+        }
+    }
+
+    fn ttse<const L: usize>(&self, column: &Column, p: &[f64; L], h: &[f64; L]) -> [f64; L] {
+        let nh = self.enthalpy.len();
+        let mut valid = [false; L];
+        let mut dp = [0.0; L];
+        let mut dh = [0.0; L];
+        let mut idx = [0; L];
+        for lane in 0..L {
+            let (Some(i), Some(j)) =
+                (self.pressure.nearest(p[lane]), self.enthalpy.nearest(h[lane]))
+            else {
+                continue;
+            };
+            valid[lane] = true;
+            dp[lane] = p[lane] - self.pressure.nodes[i];
+            dh[lane] = h[lane] - self.enthalpy.nodes[j];
+            idx[lane] = i * nh + j;
+        }
+        let gather = |values: &[f64]| -> [f64; L] { idx.map(|k| values[k]) };
+        let (value, d_dh, d_dp) =
+            (gather(&column.value), gather(&column.d_dh), gather(&column.d_dp));
+        let (d2_dh2, d2_dp2, d2_dhdp) =
+            (gather(&column.d2_dh2), gather(&column.d2_dp2), gather(&column.d2_dhdp));
+        let mut res = [0.0; L];
+        for lane in 0..L {
+            let (dh, dp) = (dh[lane], dp[lane]);
+            let sum = value[lane]
+                + d_dh[lane] * dh
+                + d_dp[lane] * dp
+                + 0.5 * d2_dh2[lane] * dh * dh
+                + 0.5 * d2_dp2[lane] * dp * dp
+                + d2_dhdp[lane] * dh * dp;
+            res[lane] = if valid[lane] { sum } else { f64::NAN };
+        }
+        res
+    }
+
+    fn bicubic<const L: usize>(&self, column: &Column, p: &[f64; L], h: &[f64; L]) -> [f64; L] {
+        let nh = self.enthalpy.len();
+        let mut valid = [false; L];
+        let mut th = [0.0; L];
+        let mut tp = [0.0; L];
+        let mut dx = [0.0; L];
+        let mut dy = [0.0; L];
+        let mut base = [0; L];
+        for lane in 0..L {
+            let (Some(i), Some(j)) = (self.pressure.cell(p[lane]), self.enthalpy.cell(h[lane]))
+            else {
+                continue;
+            };
+            valid[lane] = true;
+            dy[lane] = self.pressure.nodes[i + 1] - self.pressure.nodes[i];
+            dx[lane] = self.enthalpy.nodes[j + 1] - self.enthalpy.nodes[j];
+            tp[lane] = (p[lane] - self.pressure.nodes[i]) / dy[lane];
+            th[lane] = (h[lane] - self.enthalpy.nodes[j]) / dx[lane];
+            base[lane] = i * nh + j;
+        }
+        // Corners of the cell: (h_j, p_i), (h_j+1, p_i), (h_j, p_i+1), (h_j+1, p_i+1)
+        let mut corners = [[0.0; L]; 16];
+        for lane in 0..L {
+            let lower = base[lane];
+            let indices = [lower, lower + 1, lower + nh, lower + nh + 1];
+            for (k, idx) in indices.into_iter().enumerate() {
+                corners[k][lane] = column.value[idx];
+                corners[4 + k][lane] = column.d_dh[idx] * dx[lane];
+                corners[8 + k][lane] = column.d_dp[idx] * dy[lane];
+                corners[12 + k][lane] = column.d2_dhdp[idx] * dx[lane] * dy[lane];
+            }
+        }
+        let mut res = [0.0; L];
+        for lane in 0..L {
+            let (bh, bp) = (hermite(th[lane]), hermite(tp[lane]));
+            let mut sum = 0.0;
+            for k in 0..4 {
+                let (ih, ip) = (k & 1, k >> 1);
+                sum += corners[k][lane] * bh[ih] * bp[ip]
+                    + corners[4 + k][lane] * bh[2 + ih] * bp[ip]
+                    + corners[8 + k][lane] * bh[ih] * bp[2 + ip]
+                    + corners[12 + k][lane] * bh[2 + ih] * bp[2 + ip];
+            }
+            res[lane] = if valid[lane] { sum } else { f64::NAN };
+        }
+        res
+    }
+}
+
+/// Cubic Hermite basis functions on the unit interval:
+/// values at the start and the end, then slopes at the start and the end.
+fn hermite(t: f64) -> [f64; 4] {
+    let (t2, t3) = (t * t, t * t * t);
+    [2.0 * t3 - 3.0 * t2 + 1.0, -2.0 * t3 + 3.0 * t2, t3 - 2.0 * t2 + t, t3 - t2]
+}
+
+/// Uniformly _(linearly or logarithmically)_ spaced grid axis.
+#[derive(Clone, Debug, PartialEq)]
+struct Axis {
+    nodes: Vec<f64>,
+    log: bool,
+    origin: f64,
+    step: f64,
+}
+
+impl Axis {
+    fn new(
+        name: &str,
+        range: RangeInclusive<f64>,
+        len: usize,
+        log: bool,
+    ) -> Result<Self, TabularError> {
+        let (min, max) = range.into_inner();
+        if len < 3 {
+            return Err(TabularError::InvalidGrid(format!(
+                "number of {name} nodes should be at least 3"
+            )));
+        }
+        if !(min < max && min.is_finite() && max.is_finite() && (!log || min > 0.0)) {
+            return Err(TabularError::InvalidGrid(format!("{name} range is invalid")));
+        }
+        let (origin, end) = if log { (min.ln(), max.ln()) } else { (min, max) };
+        let step = (end - origin) / (len - 1) as f64;
+        let mut nodes: Vec<f64> = (0..len)
+            .map(|k| origin + step * k as f64)
+            .map(|x| if log { x.exp() } else { x })
+            .collect();
+        (nodes[0], nodes[len - 1]) = (min, max);
+        Ok(Self { nodes, log, origin, step })
+    }
+
+    fn len(&self) -> usize {
+        self.nodes.len()
+    }
+
+    /// Index of the lower node of the cell containing the value.
+    fn cell(&self, value: f64) -> Option<usize> {
+        let last = self.len() - 1;
+        if !(value >= self.nodes[0] && value <= self.nodes[last]) {
+            return None;
+        }
+        let t = ((if self.log { value.ln() } else { value }) - self.origin) / self.step;
+        Some((t.max(0.0) as usize).min(last - 1))
+    }
+
+    /// Index of the nearest node.
+    fn nearest(&self, value: f64) -> Option<usize> {
+        let i = self.cell(value)?;
+        Some(if value - self.nodes[i] <= self.nodes[i + 1] - value { i } else { i + 1 })
+    }
+}
+
+/// Values of the output parameter and its derivatives at the grid nodes
+/// _(pressure-major order)_.
+#[derive(Clone, Debug, PartialEq)]
+struct Column {
+    value: Vec<f64>,
+    d_dh: Vec<f64>,
+    d_dp: Vec<f64>,
+    d2_dhdp: Vec<f64>,
+    /// Only for [`TabularMethod::Ttse`].
+    d2_dh2: Vec<f64>,
+    /// Only for [`TabularMethod::Ttse`].
+    d2_dp2: Vec<f64>,
+}
+
+impl Column {
+    fn new(method: TabularMethod, value: Vec<f64>, pressure: &Axis, enthalpy: &Axis) -> Self {
+        let (d_dh, d2_dh2) = differentiate(&value, &enthalpy.nodes, 1);
+        let (d_dp, d2_dp2) = differentiate(&value, &pressure.nodes, enthalpy.len());
+        let (d2_dhdp, _) = differentiate(&d_dh, &pressure.nodes, enthalpy.len());
+        let (d2_dh2, d2_dp2) = match method {
+            TabularMethod::Ttse => (d2_dh2, d2_dp2),
+            TabularMethod::Bicubic => (Vec::new(), Vec::new()),
+        };
+        Self { value, d_dh, d_dp, d2_dhdp, d2_dh2, d2_dp2 }
+    }
+}
+
+/// First and second derivatives of the gridded values along the axis
+/// by three-point finite differences _(one-sided at the axis bounds)_.
+///
+/// `stride` -- distance between the neighbouring nodes of the axis in `values`.
+fn differentiate(values: &[f64], nodes: &[f64], stride: usize) -> (Vec<f64>, Vec<f64>) {
+    let len = nodes.len();
+    let mut first = vec![0.0; values.len()];
+    let mut second = vec![0.0; values.len()];
+    for (idx, (first, second)) in first.iter_mut().zip(&mut second).enumerate() {
+        let pos = idx / stride % len;
+        let mid = pos.clamp(1, len - 2);
+        let center = idx - pos * stride + mid * stride;
+        let (f0, f1, f2) = (values[center - stride], values[center], values[center + stride]);
+        let (x0, x1, x2, x) = (nodes[mid - 1], nodes[mid], nodes[mid + 1], nodes[pos]);
+        // Derivatives of the quadratic Lagrange polynomial through the three nodes
+        *first = f0 * (2.0 * x - x1 - x2) / ((x0 - x1) * (x0 - x2))
+            + f1 * (2.0 * x - x0 - x2) / ((x1 - x0) * (x1 - x2))
+            + f2 * (2.0 * x - x0 - x1) / ((x2 - x0) * (x2 - x1));
+        *second = 2.0
+            * (f0 / ((x0 - x1) * (x0 - x2))
+                + f1 / ((x1 - x0) * (x1 - x2))
+                + f2 / ((x2 - x0) * (x2 - x1)));
+    }
+    (first, second)
+}
+
+#[cfg(test)]
+mod tests {
+    use rstest::*;
+
+    use super::*;
+    use crate::{native::AbstractState, substance::Pure};
+
+    fn water_table(method: TabularMethod) -> PropertyTable {
+        PropertyTable::builder()
+            .substance(Pure::Water)
+            .method(method)
+            .outputs([FluidParam::T, FluidParam::DMass])
+            .pressure(1e5..=1e6)
+            .enthalpy(1e5..=4e5)
+            .pressure_nodes(60)
+            .enthalpy_nodes(60)
+            .build()
+            .unwrap()
+    }
+
+    #[rstest]
+    #[case(TabularMethod::Ttse, 1e-5)]
+    #[case(TabularMethod::Bicubic, 1e-5)]
+    fn output_matches_backend(#[case] method: TabularMethod, #[case] tolerance: f64) {
+        // Given
+        let sut = water_table(method);
+        let mut expected = AbstractState::new("HEOS", "Water").unwrap();
+        expected.update(FluidInputPair::HMassP, 2.345e5, 4.321e5).unwrap();
+
+        // When
+        let temperature = sut.output(FluidParam::T, 4.321e5, 2.345e5).unwrap();
+        let density = sut.output(FluidParam::DMass, 4.321e5, 2.345e5).unwrap();
+
+        // Then
+        approx::assert_relative_eq!(
+            temperature,
+            expected.keyed_output(FluidParam::T).unwrap(),
+            max_relative = tolerance
+        );
+        approx::assert_relative_eq!(
+            density,
+            expected.keyed_output(FluidParam::DMass).unwrap(),
+            max_relative = tolerance
+        );
+    }
+
+    #[rstest]
+    #[case(TabularMethod::Ttse)]
+    #[case(TabularMethod::Bicubic)]
+    fn output_at_nodes(#[case] method: TabularMethod) {
+        // Given
+        let sut = water_table(method);
+        let mut expected = AbstractState::new("HEOS", "Water").unwrap();
+        expected.update(FluidInputPair::HMassP, 4e5, 1e6).unwrap();
+
+        // When
+        let res = sut.output(FluidParam::T, 1e6, 4e5).unwrap();
+
+        // Then
+        approx::assert_relative_eq!(res, expected.keyed_output(FluidParam::T).unwrap());
+    }
+
+    #[rstest]
+    #[case(1e4, 2e5)]
+    #[case(2e6, 2e5)]
+    #[case(5e5, 5e5)]
+    #[case(f64::NAN, 2e5)]
+    fn output_not_available(#[case] pressure: f64, #[case] enthalpy: f64) {
+        // Given
+        let sut = water_table(TabularMethod::Bicubic);
+
+        // When
+        let res = sut.output(FluidParam::T, pressure, enthalpy);
+
+        // Then
+        assert!(matches!(res, Err(TabularError::NotAvailable { param: FluidParam::T, .. })));
+    }
+
+    #[test]
+    fn output_not_tabulated() {
+        // Given
+        let sut = water_table(TabularMethod::Ttse);
+
+        // When
+        let res = sut.output(FluidParam::CpMass, 5e5, 2e5);
+
+        // Then
+        assert_eq!(res, Err(TabularError::NotTabulated(FluidParam::CpMass)));
+    }
+
+    #[rstest]
+    #[case(TabularMethod::Ttse)]
+    #[case(TabularMethod::Bicubic)]
+    fn output_batch_matches_output(#[case] method: TabularMethod) {
+        // Given
+        let sut = water_table(method);
+        let pressure: Vec<f64> = (0..11_u32).map(|k| 1.5e5 + 5e4 * f64::from(k)).collect();
+        let mut enthalpy: Vec<f64> = (0..11_u32).map(|k| 1.5e5 + 2e4 * f64::from(k)).collect();
+        enthalpy[3] = 1e6;
+        let mut res = vec![0.0; pressure.len()];
+
+        // When
+        sut.output_batch(FluidParam::DMass, &pressure, &enthalpy, &mut res).unwrap();
+
+        // Then
+        for ((&p, &h), &res) in pressure.iter().zip(&enthalpy).zip(&res) {
+            match sut.output(FluidParam::DMass, p, h) {
+                Ok(expected) => assert_eq!(res, expected),
+                Err(_) => assert!(res.is_nan()),
+            }
+        }
+        assert!(res[3].is_nan());
+    }
+
+    #[test]
+    fn outputs() {
+        // Given
+        let sut = water_table(TabularMethod::Bicubic);
+
+        // When
+        let res: Vec<FluidParam> = sut.outputs().collect();
+
+        // Then
+        assert_eq!(res, vec![FluidParam::T, FluidParam::DMass]);
+        assert_eq!(sut.method(), TabularMethod::Bicubic);
+    }
+
+    #[rstest]
+    #[case(1e5..=1e6, 2)]
+    #[case(1e6..=1e5, 10)]
+    #[case(0.0..=1e6, 10)]
+    #[case(1e5..=f64::INFINITY, 10)]
+    fn new_invalid_grid(#[case] pressure: RangeInclusive<f64>, #[case] pressure_nodes: usize) {
+        // When
+        let res = PropertyTable::builder()
+            .substance(Pure::Water)
+            .method(TabularMethod::Ttse)
+            .outputs([FluidParam::T])
+            .pressure(pressure)
+            .enthalpy(1e5..=4e5)
+            .pressure_nodes(pressure_nodes)
+            .build();
+
+        // Then
+        assert!(matches!(res, Err(TabularError::InvalidGrid(_))));
+    }
+
+    #[test]
+    fn differentiate_quadratic() {
+        // Given
+        let nodes = [1.0, 1.5, 3.0, 4.0];
+        let values = nodes.map(|x| x * x);
+
+        // When
+        let (first, second) = differentiate(&values, &nodes, 1);
+
+        // Then
+        for (res, x) in first.iter().zip(nodes) {
+            approx::assert_relative_eq!(*res, 2.0 * x);
+        }
+        for res in second {
+            approx::assert_relative_eq!(res, 2.0);
+        }
+    }
+}
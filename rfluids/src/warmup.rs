@@ -0,0 +1,186 @@
+//! Startup warm-up of the `CoolProp` library, fluid data and tabular backends.
+
+use std::{
+    sync::LazyLock,
+    time::{Duration, Instant},
+};
+
+use coolprop_sys::{COOLPROP, COOLPROP_API};
+
+use crate::{
+    fluid::{PooledState, backend::Backend, trivial_outputs},
+    io::FluidTrivialParam,
+    native::CoolPropError,
+    substance::Substance,
+};
+
+/// Trivial outputs calculated for each warmed-up item _(failures are ignored,
+/// since not all of them are available for every substance)_.
+const TRIVIAL_OUTPUTS: [FluidTrivialParam; 7] = [
+    FluidTrivialParam::MolarMass,
+    FluidTrivialParam::TCritical,
+    FluidTrivialParam::PCritical,
+    FluidTrivialParam::TMin,
+    FluidTrivialParam::TMax,
+    FluidTrivialParam::PMax,
+    FluidTrivialParam::TFreeze,
+];
+
+/// Moves the one-time costs of the first calculations out of the hot path
+/// _(e.g., to the application startup, before the readiness probe succeeds)_.
+///
+/// It forces loading of the `CoolProp` dynamic library and then, for each item, creates
+/// a native handle _(which makes `CoolProp` parse the fluid data and build or load the tables
+/// of the tabular backends)_ and calculates its trivial outputs _(e.g., critical point,
+/// which is expensive for mixtures)_. The fluid data, tables and trivial outputs of
+/// substances with fixed composition are shared by all further instances with the same
+/// substance and backend within the process. The native handles themselves are kept
+/// in the pool of the calling thread, so only [`Fluid`](crate::fluid::Fluid) instances
+/// created on that thread reuse them _(instances on other threads create their own handles,
+/// which is still cheap after the warm-up)_.
+///
+/// Items are processed sequentially, since `CoolProp` creates native handles
+/// under the process-wide lock anyway.
+///
+/// # Arguments
+///
+/// - `items` -- substances and backends to warm up
+///
+/// # Errors
+///
+/// Returns a [`WarmupError`] if `CoolProp` fails to create the native handle of some item.
+///
+/// # Examples
+///
+/// ```
+/// use rfluids::prelude::*;
+///
+/// let report = rfluids::warmup(&[
+///     (Pure::Water.into(), BaseBackend::Heos.into()),
+///     (BinaryMixKind::MPG.with_fraction(0.4)?.into(), BaseBackend::Incomp.into()),
+/// ])?;
+/// assert_eq!(report.entries.len(), 2);
+/// println!("Warmed up in {:?}", report.total());
+/// # Ok::<(), rfluids::Error>(())
+/// ```
+///
+/// # See Also
+///
+/// - [`tabular::load`](crate::tabular::load)
+pub fn warmup(items: &[(Substance, Backend)]) -> Result<WarmupReport, WarmupError> {
+    let start = Instant::now();
+    LazyLock::force(&COOLPROP_API);
+    LazyLock::force(&COOLPROP);
+    let library = start.elapsed();
+    let entries = items
+        .iter()
+        .map(|(substance, backend)| {
+            let start = Instant::now();
+            warm(substance, *backend).map_err(|e| WarmupError {
+                substance: substance.name().into_owned(),
+                backend: backend.name().into_owned(),
+                source: e,
+            })?;
+            Ok(WarmupReportEntry {
+                substance: substance.clone(),
+                backend: *backend,
+                elapsed: start.elapsed(),
+            })
+        })
+        .collect::<Result<_, _>>()?;
+    Ok(WarmupReport { library, entries })
+}
+
+/// Report of the [`warmup`].
+#[derive(Clone, Debug, PartialEq)]
+pub struct WarmupReport {
+    /// Elapsed time of the `CoolProp` library loading
+    /// _(almost zero if it's already loaded)_.
+    pub library: Duration,
+
+    /// Report entries in the same order as the requested items.
+    pub entries: Vec<WarmupReportEntry>,
+}
+
+impl WarmupReport {
+    /// Total elapsed time.
+    #[must_use]
+    pub fn total(&self) -> Duration {
+        self.library + self.entries.iter().map(|entry| entry.elapsed).sum::<Duration>()
+    }
+}
+
+/// Entry of the [`WarmupReport`].
+#[derive(Clone, Debug, PartialEq)]
+pub struct WarmupReportEntry {
+    /// Substance.
+    pub substance: Substance,
+
+    /// Backend.
+    pub backend: Backend,
+
+    /// Elapsed time of the native handle creation and trivial outputs calculation.
+    pub elapsed: Duration,
+}
+
+/// Error during [`warmup`].
+#[derive(Clone, Debug, PartialEq, thiserror::Error)]
+#[error("failed to warm up `{substance}` with `{backend}` backend: {source}")]
+pub struct WarmupError {
+    /// Substance name.
+    pub substance: String,
+    /// Backend name.
+    pub backend: String,
+    /// `CoolProp` error.
+    pub source: CoolPropError,
+}
+
+/// Creates the native handle and calculates its trivial outputs
+/// _(filling the process-wide table of trivial outputs for substances with fixed composition)_.
+/// On return, the handle is put into the pool of the current thread.
+fn warm(substance: &Substance, backend: Backend) -> Result<(), CoolPropError> {
+    let mut state = PooledState::checkout(&substance.with_backend(backend))?;
+    trivial_outputs(&mut state, TRIVIAL_OUTPUTS);
+    Ok(())
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::{
+        fluid::backend::BaseBackend,
+        substance::{BinaryMixKind, Pure},
+    };
+
+    #[test]
+    fn warmup_valid_items() {
+        // Given
+        let items = [
+            (Pure::Water.into(), BaseBackend::Heos.into()),
+            (BinaryMixKind::MPG.with_fraction(0.4).unwrap().into(), BaseBackend::Incomp.into()),
+        ];
+
+        // When
+        let res = warmup(&items).unwrap();
+
+        // Then
+        assert_eq!(res.entries.len(), items.len());
+        for (entry, (substance, backend)) in res.entries.iter().zip(&items) {
+            assert_eq!(&entry.substance, substance);
+            assert_eq!(&entry.backend, backend);
+        }
+        assert!(res.total() >= res.library);
+    }
+
+    #[test]
+    fn warmup_invalid_item() {
+        // Given
+        let items = [(Pure::R32.into(), BaseBackend::Incomp.into())];
+
+        // When
+        let res = warmup(&items);
+
+        // Then
+        assert!(matches!(res, Err(WarmupError { substance, .. }) if substance == "R32"));
+    }
+}
@@ -0,0 +1,28 @@
+use rfluids::{config, prelude::*, tabular};
+
+#[test]
+fn prebuild_and_load() {
+    // Given
+    let dir = std::env::temp_dir().join("rfluids-tabular-tables");
+    let items: [(Substance, TabularMethod); 1] = [(Pure::Water.into(), TabularMethod::Bicubic)];
+
+    // When
+    let built = tabular::prebuild(&items, &dir).unwrap();
+    let loaded = tabular::load(&items, &dir).unwrap();
+
+    // Then
+    let dir = dir.canonicalize().unwrap();
+    assert_eq!(built.dir, dir);
+    assert_eq!(loaded.dir, dir);
+    assert_eq!(config::read().alt_tables_path, Some(dir));
+    assert_eq!(built.entries.len(), 1);
+    assert_eq!(loaded.entries[0].backend, BaseBackend::Heos.with(TabularMethod::Bicubic));
+    let mut water = Fluid::builder()
+        .substance(Pure::Water)
+        .with_backend(BaseBackend::Heos.with(TabularMethod::Bicubic))
+        .build()
+        .unwrap()
+        .in_state(FluidInput::pressure(101_325.0), FluidInput::temperature(293.15))
+        .unwrap();
+    assert!(water.density().is_ok());
+}